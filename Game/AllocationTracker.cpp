@@ -0,0 +1,300 @@
+#include "AllocationTracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+#ifndef ALLOCATION_TRACKING
+#define ALLOCATION_TRACKING 0
+#endif
+
+namespace
+{
+
+using HideAndSeekAndShoot::AllocationTracker;
+
+/* All of the tracking state is constant-initialized,
+   so that it is usable even by allocations made before main() */
+
+/// Names of the registered tags. The first one is for allocations outside of any tag.
+std::array<std::atomic<char const*>, AllocationTracker::MAX_TAGS> g_tagNames = { "untagged" };
+/// Number of registered tags
+int g_tagsCount = 1;
+/// Mutex for registering new tags
+std::mutex g_tagsMutex;
+
+/// Counters of the current frame, in total and for each tag
+std::atomic<std::size_t> g_frameCount, g_frameBytes;
+std::array<std::atomic<std::size_t>, AllocationTracker::MAX_TAGS> g_tagCounts, g_tagBytes;
+
+/// Index of the tag to which the current thread's allocations are attributed
+thread_local int g_currentTagInd = 0;
+
+} // namespace
+
+namespace HideAndSeekAndShoot
+{
+
+bool AllocationTracker::IsEnabled()
+{
+    return ALLOCATION_TRACKING;
+}
+
+AllocationTracker::FrameStats AllocationTracker::TakeFrameStats()
+{
+    FrameStats stats;
+    stats.count = g_frameCount.exchange(0, std::memory_order_relaxed);
+    stats.bytes = g_frameBytes.exchange(0, std::memory_order_relaxed);
+    for (int tagInd = 0; tagInd < MAX_TAGS; tagInd++)
+    {
+        stats.tagCounts[tagInd] = g_tagCounts[tagInd].exchange(0, std::memory_order_relaxed);
+        stats.tagBytes[tagInd] = g_tagBytes[tagInd].exchange(0, std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+char const* AllocationTracker::GetTagName(int tagInd)
+{
+    if (tagInd < 0 || tagInd >= MAX_TAGS)
+    {
+        return nullptr;
+    }
+    return g_tagNames[tagInd].load(std::memory_order_acquire);
+}
+
+void AllocationTracker::RecordAllocation(std::size_t bytes)
+{
+    g_frameCount.fetch_add(1, std::memory_order_relaxed);
+    g_frameBytes.fetch_add(bytes, std::memory_order_relaxed);
+    g_tagCounts[g_currentTagInd].fetch_add(1, std::memory_order_relaxed);
+    g_tagBytes[g_currentTagInd].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+int AllocationTracker::FindOrAddTag(char const* name)
+{
+    std::lock_guard<std::mutex> lock(g_tagsMutex);
+
+    // Equal literals of different translation units don't have to share a pointer, so the names themselves are compared
+    for (int tagInd = 0; tagInd < g_tagsCount; tagInd++)
+    {
+        char const* const tagName = g_tagNames[tagInd].load(std::memory_order_relaxed);
+        if (tagName == name || std::strcmp(tagName, name) == 0)
+        {
+            return tagInd;
+        }
+    }
+
+    // When there is no more room for tags, the allocations are counted as untagged
+    if (g_tagsCount == MAX_TAGS)
+    {
+        return 0;
+    }
+
+    g_tagNames[g_tagsCount].store(name, std::memory_order_release);
+    return g_tagsCount++;
+}
+
+AllocationTag::AllocationTag(char const* name)
+    : _prevTagInd(g_currentTagInd)
+{
+    g_currentTagInd = AllocationTracker::FindOrAddTag(name);
+}
+
+AllocationTag::~AllocationTag()
+{
+    g_currentTagInd = _prevTagInd;
+}
+
+AllocationReport::AllocationReport(Config const& config)
+    : _window(),
+    _lineOfSightWindow(),
+    _lineOfSightTotals(),
+    _started(false),
+    _frameCount(0),
+    _reportInterval(0),
+    _budgetBytes(-1),
+    _budgetWarmupFrames(0)
+{
+    auto const reportIntervalConfig = config.find("alloc_report_interval");
+    if (reportIntervalConfig != config.end())
+    {
+        _reportInterval = std::stoi(reportIntervalConfig->second);
+    }
+
+    auto const reportFileConfig = config.find("alloc_report_file");
+    if (reportFileConfig != config.end())
+    {
+        _reportFile.open(reportFileConfig->second);
+        if (!_reportFile.is_open())
+        {
+            throw std::runtime_error("Error: Cannot open allocation report file \"" + reportFileConfig->second + "\".");
+        }
+    }
+
+    auto const budgetBytesConfig = config.find("alloc_budget_bytes");
+    if (budgetBytesConfig != config.end())
+    {
+        _budgetBytes = std::stoll(budgetBytesConfig->second);
+    }
+
+    auto const budgetWarmupFramesConfig = config.find("alloc_budget_warmup_frames");
+    if (budgetWarmupFramesConfig != config.end())
+    {
+        _budgetWarmupFrames = std::stoi(budgetWarmupFramesConfig->second);
+    }
+
+    if ((_reportInterval > 0 || _budgetBytes >= 0) && !AllocationTracker::IsEnabled())
+    {
+        std::cerr << "Warning: Allocation report is configured, "
+            << "but the game is built without the ALLOCATION_TRACKING option, so nothing is counted." << std::endl;
+    }
+}
+
+void AllocationReport::EndFrame(LineOfSightStats const& lineOfSightStats)
+{
+    AllocationTracker::FrameStats const stats = AllocationTracker::TakeFrameStats();
+    // The allocations so far were made while starting up, so the budget would fail the first frame if they were counted
+    if (!_started)
+    {
+        _lineOfSightTotals = lineOfSightStats;
+        _started = true;
+        return;
+    }
+
+    _window[_frameCount % WINDOW_FRAMES] = stats;
+    _lineOfSightWindow[_frameCount % WINDOW_FRAMES] = {
+        lineOfSightStats.queries - _lineOfSightTotals.queries,
+        lineOfSightStats.hits - _lineOfSightTotals.hits,
+        lineOfSightStats.misses - _lineOfSightTotals.misses,
+        lineOfSightStats.rayCasts - _lineOfSightTotals.rayCasts
+    };
+    _lineOfSightTotals = lineOfSightStats;
+    _frameCount++;
+
+    if (_budgetBytes >= 0 && _frameCount > _budgetWarmupFrames && stats.bytes > _budgetBytes)
+    {
+        throw std::runtime_error("Error: Frame " + std::to_string(_frameCount)
+            + " allocated " + std::to_string(stats.bytes)
+            + " bytes, which is over the budget of " + std::to_string(_budgetBytes) + " bytes.");
+    }
+
+    if (_reportInterval > 0 && _frameCount % _reportInterval == 0)
+    {
+        WriteReport(std::cout);
+        if (_reportFile.is_open())
+        {
+            WriteReport(_reportFile);
+            _reportFile.flush();
+        }
+    }
+}
+
+void AllocationReport::WriteReport(std::ostream& stream) const
+{
+    int const framesCount = std::min<long long>(_frameCount, WINDOW_FRAMES);
+
+    // Sum up the frames in the rolling window
+    std::size_t totalCount = 0, totalBytes = 0, maxCount = 0, maxBytes = 0;
+    std::array<std::size_t, AllocationTracker::MAX_TAGS> tagCounts = {}, tagBytes = {};
+    for (int frameInd = 0; frameInd < framesCount; frameInd++)
+    {
+        AllocationTracker::FrameStats const& stats = _window[frameInd];
+        totalCount += stats.count;
+        totalBytes += stats.bytes;
+        maxCount = std::max(maxCount, stats.count);
+        maxBytes = std::max(maxBytes, stats.bytes);
+        for (int tagInd = 0; tagInd < AllocationTracker::MAX_TAGS; tagInd++)
+        {
+            tagCounts[tagInd] += stats.tagCounts[tagInd];
+            tagBytes[tagInd] += stats.tagBytes[tagInd];
+        }
+    }
+
+    stream << "Allocations in frames " << _frameCount - framesCount + 1 << "-" << _frameCount << ": "
+        << "avg " << totalCount / framesCount << " allocs (" << totalBytes / framesCount << " B) per frame, "
+        << "max " << maxCount << " allocs (" << maxBytes << " B)\n";
+    for (int tagInd = 0; tagInd < AllocationTracker::MAX_TAGS; tagInd++)
+    {
+        if (tagCounts[tagInd] > 0)
+        {
+            stream << "    " << AllocationTracker::GetTagName(tagInd) << ": "
+                << tagCounts[tagInd] << " allocs (" << tagBytes[tagInd] << " B)\n";
+        }
+    }
+
+    std::size_t queries = 0, hits = 0, misses = 0, rayCasts = 0;
+    for (int frameInd = 0; frameInd < framesCount; frameInd++)
+    {
+        queries += _lineOfSightWindow[frameInd].queries;
+        hits += _lineOfSightWindow[frameInd].hits;
+        misses += _lineOfSightWindow[frameInd].misses;
+        rayCasts += _lineOfSightWindow[frameInd].rayCasts;
+    }
+    // Hits are counted among the queries that looked up the cache, which are all of them unless the cache is off
+    if (queries > 0)
+    {
+        stream << "Line of sight cache: avg " << queries / framesCount << " queries per frame, "
+            << (hits + misses > 0 ? 100 * hits / (hits + misses) : 0) << "% hits, "
+            << 100 * rayCasts / queries << "% cast through the walls\n";
+    }
+}
+
+} // namespace HideAndSeekAndShoot
+
+#if ALLOCATION_TRACKING == 1
+
+/* Replacements of the global allocation functions, counting every allocation.
+   The aligned versions are not replaced, they keep using the default implementation. */
+
+void* operator new(std::size_t size)
+{
+    HideAndSeekAndShoot::AllocationTracker::RecordAllocation(size);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+    HideAndSeekAndShoot::AllocationTracker::RecordAllocation(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#endif
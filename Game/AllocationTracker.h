@@ -0,0 +1,163 @@
+#pragma once
+
+#include "LineOfSightStats.h"
+
+#include <array>
+#include <cstddef>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <map>
+
+typedef std::map<std::string, std::string> Config;
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * Counts heap allocations made through the global operator new, per frame and per callsite tag.
+ * The counting is opt-in - the global operator new/delete are replaced only when the game is built
+ * with the ALLOCATION_TRACKING CMake option. Otherwise all counters stay at 0.
+ * 
+ * Allocations are attributed to the tag of the innermost AllocationTag alive on the allocating thread,
+ * or to the "untagged" tag if there is none.
+ */
+class AllocationTracker
+{
+
+  public:
+
+    /// Maximum number of different tags that can be tracked
+    static int const MAX_TAGS = 16;
+
+    /// Allocation counts of a single frame
+    struct FrameStats
+    {
+        /// Number of allocations and allocated bytes during the frame, in total
+        std::size_t count, bytes;
+        /// Number of allocations and allocated bytes during the frame, for each tag
+        std::array<std::size_t, MAX_TAGS> tagCounts, tagBytes;
+    };
+
+    /// Returns whether allocations are actually being tracked (whether the game was built with tracking)
+    static bool IsEnabled();
+
+    /**
+     * Returns the counts of the allocations made since the last call, and starts counting from 0 again.
+     * Meant to be called once at the beginning of each frame.
+     */
+    static FrameStats TakeFrameStats();
+
+    /// Returns the name of the tag with the given index (as found in FrameStats), or nullptr if there is no such tag
+    static char const* GetTagName(int tagInd);
+
+    /// Records an allocation of some bytes. Called by the global operator new.
+    static void RecordAllocation(std::size_t bytes);
+
+  private: /* functions */
+
+    friend class AllocationTag;
+
+    /// Returns the index of a tag, registering it if it is seen for the first time
+    static int FindOrAddTag(char const* name);
+};
+
+/**
+ * Marks a scope whose allocations are attributed to a callsite tag.
+ * Tags are compared by name, so the same literal in different translation units is the same tag.
+ * The name is kept by pointer, so it has to live as long as the program, as string literals do.
+ * Scopes can be nested, and the innermost one wins.
+ */
+class AllocationTag
+{
+
+  public:
+
+    /// Starts attributing the current thread's allocations to the given tag
+    AllocationTag(char const* name);
+
+    /// Goes back to attributing allocations to the tag that was current before this one
+    ~AllocationTag();
+
+    AllocationTag(AllocationTag const&) = delete;
+    AllocationTag& operator=(AllocationTag const&) = delete;
+
+  private: /* variables */
+
+    /// Index of the tag that was current before this one
+    int _prevTagInd;
+};
+
+/**
+ * Keeps a rolling report of the allocations per frame, and checks them against a budget.
+ * The report also shows how well the world's line of sight cache does in the same frames.
+ * Configured with these (optional) keys of the game config:
+ *  - alloc_report_interval: Number of frames between two reports. Reports are off if not specified.
+ *  - alloc_report_file: Name of a file to which the reports are appended, in addition to the standard output.
+ *  - alloc_budget_bytes: Bytes that a steady-state frame is allowed to allocate.
+ *      If a frame allocates more, an exception is thrown, so that the game fails. Meant for CI runs.
+ *  - alloc_budget_warmup_frames: Number of frames at the start that are not checked against the budget.
+ */
+class AllocationReport
+{
+
+  public:
+
+    /**
+     * Creates a report, configured from the game config
+     * 
+     * @param[in] config
+     *  The game config
+     */
+    AllocationReport(Config const& config);
+
+    /**
+     * Collects the allocations of the frame that just ended,
+     * prints the report if it is time for it, and checks the budget.
+     * Has to be called once at the beginning of each frame.
+     * The first call only starts counting, so the allocations made while starting up are not counted as a frame's.
+     * 
+     * @param[in] lineOfSightStats
+     *  Counts of the world's line of sight queries so far
+     */
+    void EndFrame(LineOfSightStats const& lineOfSightStats);
+
+  private: /* functions */
+
+    /// Writes the report of the frames in the rolling window to a stream
+    void WriteReport(std::ostream& stream) const;
+
+  private: /* variables */
+
+    /// Number of frames in the rolling window of the report
+    static int const WINDOW_FRAMES = 60;
+
+    /// Allocation counts of the last frames, in a ring buffer
+    std::array<AllocationTracker::FrameStats, WINDOW_FRAMES> _window;
+
+    /// Line of sight queries of the last frames, in a ring buffer like the allocation counts
+    std::array<LineOfSightStats, WINDOW_FRAMES> _lineOfSightWindow;
+
+    /// Counts of the line of sight queries up to the last frame that has ended
+    LineOfSightStats _lineOfSightTotals;
+
+    /// Whether the first frame has started, before which nothing is counted
+    bool _started;
+
+    /// Number of frames that have ended so far
+    long long _frameCount;
+
+    /// Number of frames between two reports, or 0 if reports are off
+    int _reportInterval;
+
+    /// File to which reports are appended, if specified
+    std::ofstream _reportFile;
+
+    /// Bytes that a steady-state frame is allowed to allocate, or a negative number if there is no budget
+    long long _budgetBytes;
+
+    /// Number of frames at the start that are not checked against the budget
+    int _budgetWarmupFrames;
+};
+
+} // namespace HideAndSeekAndShoot
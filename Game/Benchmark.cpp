@@ -0,0 +1,511 @@
+#include "Benchmark.h"
+
+#include "ControlState.h"
+#include "utils/configUtils.hpp"
+#include "utils/randomUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+
+auto constexpr BENCHMARK_CONFIG_FILENAME = "Game/config/benchmark.conf";
+
+int const MAP_WALLS_COUNT_DEFAULT = 100;
+// A world this many times the view's size narrows the generator's passages so that the default number of walls fits in every style
+float const MAP_WORLD_SCALE_DEFAULT = 4.f;
+unsigned const SEED_DEFAULT = 1;
+int const WARMUP_UPDATES_DEFAULT = 60;
+int const UPDATES_DEFAULT = 600;
+int const REPETITIONS_DEFAULT = 3;
+double const TIME_THRESHOLD_DEFAULT = 0.15;
+double const TIME_NOISE_MICROSECONDS_DEFAULT = 20.;
+double const ALLOCATION_THRESHOLD_DEFAULT = 0.05;
+double const MAX_ALLOCATIONS_PER_UPDATE_DEFAULT = 0.;
+auto constexpr CROWD_MAP_DEFAULT = "city";
+int const CROWD_ENEMIES_COUNT_DEFAULT = 300;
+
+// Number of updates for which the scripted player keeps moving in the same direction
+int const MOVE_SCRIPT_INTERVAL = 30;
+
+// Angle by which the scripted player's aim turns each update, in radians
+float const AIM_SCRIPT_SPEED = 0.05f;
+
+// Update time percentiles that are measured
+int const TIME_PERCENTILES[] = { 50, 95, 99 };
+
+// Prefix of the names of the update time metrics, to which the time thresholds apply
+auto constexpr TIME_METRIC_PREFIX = "update_us_";
+
+// Name of the metric of heap allocations per update, to which the steady-state limit applies
+auto constexpr ALLOCATIONS_METRIC = "allocations_per_update";
+
+/// Splits a comma separated list from a config
+std::vector<std::string> SplitList(std::string const& list)
+{
+    std::vector<std::string> items;
+    std::size_t begin = 0;
+    while (begin <= list.size())
+    {
+        std::size_t end = std::min(list.find(',', begin), list.size());
+        if (end > begin)
+        {
+            items.push_back(list.substr(begin, end - begin));
+        }
+        begin = end + 1;
+    }
+    return items;
+}
+
+} // namespace
+
+namespace HideAndSeekAndShoot
+{
+
+Benchmark::Benchmark(
+    Game const* game,
+    Resources::ResourceHandler<Resources::Texture::Id, sf::Texture> const* texHandler,
+    FrameArena* frameArena,
+    sf::Vector2f viewSize)
+    : _game(game),
+    _texHandler(texHandler),
+    _frameArena(frameArena),
+    _viewSize(viewSize),
+    _config(ConfigUtils::ReadConfig(BENCHMARK_CONFIG_FILENAME))
+{
+    ConfigScenarios();
+}
+
+bool Benchmark::Run(std::string const& baselineFilename, bool updateBaseline, std::ostream& log)
+{
+    if (!AllocationTracker::IsEnabled())
+    {
+        log << "Allocations are not measured, as the game is built without allocation tracking." << std::endl;
+    }
+
+    std::map<std::string, Result> results;
+    for (int scenarioInd = 0; scenarioInd < _scenarios.size(); scenarioInd++)
+    {
+        Scenario const& scenario = _scenarios[scenarioInd];
+        Result const result = RunScenario(scenario);
+        results[scenario.name] = result;
+
+        log << scenario.name << ":";
+        for (auto it = result.metrics.begin(); it != result.metrics.end(); it++)
+        {
+            log << " " << it->first << "=" << std::fixed << std::setprecision(1) << it->second;
+        }
+        log << std::endl;
+    }
+
+    bool const allocationsPassed = CheckSteadyStateAllocations(results, log);
+
+    if (updateBaseline)
+    {
+        SaveResults(results, baselineFilename);
+        log << "Saved the results as the baseline " << baselineFilename << std::endl;
+        return allocationsPassed;
+    }
+
+    return CompareWithBaseline(results, LoadResults(baselineFilename), log) && allocationsPassed;
+}
+
+void Benchmark::ConfigScenarios()
+{
+    auto const mapsConfig = _config.find("maps");
+    std::vector<std::string> const mapStyles = SplitList(mapsConfig != _config.end() ? mapsConfig->second : "maze,city,sparse");
+    auto const enemiesCountsConfig = _config.find("enemies_counts");
+    std::vector<std::string> const enemiesCounts = SplitList(enemiesCountsConfig != _config.end() ? enemiesCountsConfig->second : "10,100");
+    auto const bulletStormsConfig = _config.find("bullet_storms");
+    std::vector<std::string> const bulletStorms = SplitList(bulletStormsConfig != _config.end() ? bulletStormsConfig->second : "off,on");
+
+    // Every map with every number of enemies, with and without bullet storms
+    _scenarios.clear();
+    for (int mapInd = 0; mapInd < mapStyles.size(); mapInd++)
+    {
+        for (int enemiesInd = 0; enemiesInd < enemiesCounts.size(); enemiesInd++)
+        {
+            for (int stormInd = 0; stormInd < bulletStorms.size(); stormInd++)
+            {
+                Scenario scenario;
+                scenario.mapStyle = mapStyles[mapInd];
+                scenario.enemiesCount = std::stoi(enemiesCounts[enemiesInd]);
+                scenario.bulletStorm = (bulletStorms[stormInd] == "on");
+                scenario.crowdSteering = false;
+                scenario.name = scenario.mapStyle + "_" + std::to_string(scenario.enemiesCount) + "enemies"
+                    + (scenario.bulletStorm ? "_storm" : "_calm");
+                _scenarios.push_back(scenario);
+            }
+        }
+    }
+
+    // A crowd of enemies steering around each other, whose cost grows with the enemies' density
+    Scenario crowdScenario;
+    auto const crowdMapConfig = _config.find("crowd_map");
+    crowdScenario.mapStyle = (crowdMapConfig != _config.end() ? crowdMapConfig->second : CROWD_MAP_DEFAULT);
+    crowdScenario.enemiesCount = CROWD_ENEMIES_COUNT_DEFAULT;
+    auto const crowdEnemiesCountConfig = _config.find("crowd_enemies_count");
+    if (crowdEnemiesCountConfig != _config.end())
+    {
+        crowdScenario.enemiesCount = std::stoi(crowdEnemiesCountConfig->second);
+    }
+    crowdScenario.bulletStorm = false;
+    crowdScenario.crowdSteering = true;
+    crowdScenario.name = crowdScenario.mapStyle + "_" + std::to_string(crowdScenario.enemiesCount) + "enemies_crowd";
+    _scenarios.push_back(crowdScenario);
+
+    _mapWallsCount = MAP_WALLS_COUNT_DEFAULT;
+    auto const mapWallsCountConfig = _config.find("map_walls_count");
+    if (mapWallsCountConfig != _config.end())
+    {
+        _mapWallsCount = std::stoi(mapWallsCountConfig->second);
+    }
+
+    _mapWorldScale = MAP_WORLD_SCALE_DEFAULT;
+    auto const mapWorldScaleConfig = _config.find("map_world_scale");
+    if (mapWorldScaleConfig != _config.end())
+    {
+        _mapWorldScale = std::stof(mapWorldScaleConfig->second);
+    }
+
+    _seed = SEED_DEFAULT;
+    auto const seedConfig = _config.find("seed");
+    if (seedConfig != _config.end())
+    {
+        _seed = std::stoul(seedConfig->second);
+    }
+
+    _warmupUpdates = WARMUP_UPDATES_DEFAULT;
+    auto const warmupUpdatesConfig = _config.find("warmup_updates");
+    if (warmupUpdatesConfig != _config.end())
+    {
+        _warmupUpdates = std::stoi(warmupUpdatesConfig->second);
+    }
+
+    _updates = UPDATES_DEFAULT;
+    auto const updatesConfig = _config.find("updates");
+    if (updatesConfig != _config.end())
+    {
+        _updates = std::max(std::stoi(updatesConfig->second), 1);
+    }
+
+    _repetitions = REPETITIONS_DEFAULT;
+    auto const repetitionsConfig = _config.find("repetitions");
+    if (repetitionsConfig != _config.end())
+    {
+        _repetitions = std::max(std::stoi(repetitionsConfig->second), 1);
+    }
+
+    _timeThreshold = TIME_THRESHOLD_DEFAULT;
+    auto const timeThresholdConfig = _config.find("time_regression_threshold");
+    if (timeThresholdConfig != _config.end())
+    {
+        _timeThreshold = std::stod(timeThresholdConfig->second);
+    }
+
+    _timeNoiseMicroseconds = TIME_NOISE_MICROSECONDS_DEFAULT;
+    auto const timeNoiseConfig = _config.find("time_noise_microseconds");
+    if (timeNoiseConfig != _config.end())
+    {
+        _timeNoiseMicroseconds = std::stod(timeNoiseConfig->second);
+    }
+
+    _allocationThreshold = ALLOCATION_THRESHOLD_DEFAULT;
+    auto const allocationThresholdConfig = _config.find("allocation_regression_threshold");
+    if (allocationThresholdConfig != _config.end())
+    {
+        _allocationThreshold = std::stod(allocationThresholdConfig->second);
+    }
+
+    _maxAllocationsPerUpdate = MAX_ALLOCATIONS_PER_UPDATE_DEFAULT;
+    auto const maxAllocationsConfig = _config.find("max_allocations_per_update");
+    if (maxAllocationsConfig != _config.end())
+    {
+        _maxAllocationsPerUpdate = std::stod(maxAllocationsConfig->second);
+    }
+}
+
+Benchmark::Result Benchmark::RunScenario(Scenario const& scenario) const
+{
+    Config const worldConfigOverrides = {
+        { "enemies_count", std::to_string(scenario.enemiesCount) },
+        { "crowd_steering", scenario.crowdSteering ? "on" : "off" },
+        { "world_scale", std::to_string(_mapWorldScale) }
+    };
+    Config const wallsConfig = {
+        { "generator", scenario.mapStyle },
+        { "generator_walls_count", std::to_string(_mapWallsCount) },
+        { "generator_seed", std::to_string(_seed) }
+    };
+
+    Result best;
+    std::vector<double> updateTimes(_updates);
+    for (int repetition = 0; repetition < _repetitions; repetition++)
+    {
+        World world(_game, _texHandler, _frameArena, _viewSize, worldConfigOverrides, &wallsConfig);
+        ControlState controlState(_window);
+        std::mt19937 rng(_seed);
+
+        std::size_t allocationsCount = 0, allocatedBytes = 0;
+        int direction = 0;
+        for (int update = 0; update < _warmupUpdates + _updates; update++)
+        {
+            _frameArena->Reset();
+
+            // The player wanders around in random directions, aiming around the middle of the window
+            if (update % MOVE_SCRIPT_INTERVAL == 0)
+            {
+                direction = RandomUtils::UniformInt(rng, 0, 8);
+            }
+            float const aimAngle = update * AIM_SCRIPT_SPEED;
+            float const aimRadius = std::min(_viewSize.x, _viewSize.y) / 4.f;
+            controlState.SetScripted(
+                direction / 3 == 0,
+                direction / 3 == 2,
+                direction % 3 == 0,
+                direction % 3 == 2,
+                scenario.bulletStorm,
+                _viewSize / 2.f + sf::Vector2f(std::cos(aimAngle), std::sin(aimAngle)) * aimRadius
+            );
+
+            // Only the allocations of the update itself are counted
+            AllocationTracker::TakeFrameStats();
+            auto const updateStart = std::chrono::steady_clock::now();
+            world.Update(controlState);
+            auto const updateEnd = std::chrono::steady_clock::now();
+            AllocationTracker::FrameStats const allocationStats = AllocationTracker::TakeFrameStats();
+
+            if (update >= _warmupUpdates)
+            {
+                updateTimes[update - _warmupUpdates] = std::chrono::duration<double, std::micro>(updateEnd - updateStart).count();
+                allocationsCount += allocationStats.count;
+                allocatedBytes += allocationStats.bytes;
+            }
+        }
+
+        Result result;
+        result.stateHash = world.CalcStateHash();
+        std::sort(updateTimes.begin(), updateTimes.end());
+        for (int percentile : TIME_PERCENTILES)
+        {
+            // Nearest-rank percentile
+            int const rank = std::max((int)std::ceil(percentile / 100. * updateTimes.size()), 1);
+            result.metrics[TIME_METRIC_PREFIX + std::string("p") + std::to_string(percentile)] = updateTimes[rank - 1];
+        }
+        if (AllocationTracker::IsEnabled())
+        {
+            result.metrics[ALLOCATIONS_METRIC] = (double)allocationsCount / _updates;
+            result.metrics["allocated_bytes_per_update"] = (double)allocatedBytes / _updates;
+        }
+
+        // Other processes can only slow a run down, so the lowest of each metric is the closest to the truth
+        if (repetition == 0)
+        {
+            best = result;
+            continue;
+        }
+        if (result.stateHash != best.stateHash)
+        {
+            throw std::runtime_error("Error: repetitions of the benchmark scenario " + scenario.name + " simulate different games");
+        }
+        for (auto it = result.metrics.begin(); it != result.metrics.end(); it++)
+        {
+            best.metrics[it->first] = std::min(best.metrics[it->first], it->second);
+        }
+    }
+    return best;
+}
+
+bool Benchmark::CompareWithBaseline(
+    std::map<std::string, Result> const& results,
+    std::map<std::string, Result> const& baseline,
+    std::ostream& log) const
+{
+    bool passed = true;
+    for (auto resultIt = results.begin(); resultIt != results.end(); resultIt++)
+    {
+        auto const baselineIt = baseline.find(resultIt->first);
+        if (baselineIt == baseline.end())
+        {
+            log << resultIt->first << ": not in the baseline" << std::endl;
+            continue;
+        }
+        if (resultIt->second.stateHash != baselineIt->second.stateHash)
+        {
+            log << resultIt->first << ": simulates differently than in the baseline, "
+                << "so the baseline should be updated if that is intended" << std::endl;
+        }
+
+        Result const& result = resultIt->second;
+        for (auto metricIt = result.metrics.begin(); metricIt != result.metrics.end(); metricIt++)
+        {
+            auto const baselineMetricIt = baselineIt->second.metrics.find(metricIt->first);
+            if (baselineMetricIt == baselineIt->second.metrics.end())
+            {
+                continue;
+            }
+
+            double const value = metricIt->second;
+            double const baselineValue = baselineMetricIt->second;
+            bool const isTime = (metricIt->first.compare(0, std::string(TIME_METRIC_PREFIX).size(), TIME_METRIC_PREFIX) == 0);
+            bool const regressed = isTime
+                ? value > baselineValue * (1. + _timeThreshold) && value - baselineValue > _timeNoiseMicroseconds
+                : value > baselineValue * (1. + _allocationThreshold);
+            if (regressed)
+            {
+                log << resultIt->first << ": " << metricIt->first << " regressed from "
+                    << std::fixed << std::setprecision(1) << baselineValue << " to " << value << std::endl;
+                passed = false;
+            }
+        }
+    }
+
+    for (auto baselineIt = baseline.begin(); baselineIt != baseline.end(); baselineIt++)
+    {
+        if (results.find(baselineIt->first) == results.end())
+        {
+            log << baselineIt->first << ": in the baseline, but not run" << std::endl;
+        }
+    }
+
+    log << (passed ? "No regressions" : "Found regressions") << std::endl;
+    return passed;
+}
+
+bool Benchmark::CheckSteadyStateAllocations(std::map<std::string, Result> const& results, std::ostream& log) const
+{
+    bool passed = true;
+    for (auto resultIt = results.begin(); resultIt != results.end(); resultIt++)
+    {
+        // Without allocation tracking there is nothing to check
+        auto const allocationsIt = resultIt->second.metrics.find(ALLOCATIONS_METRIC);
+        if (allocationsIt == resultIt->second.metrics.end())
+        {
+            continue;
+        }
+        if (allocationsIt->second > _maxAllocationsPerUpdate)
+        {
+            log << resultIt->first << ": " << ALLOCATIONS_METRIC << " is " << std::fixed << std::setprecision(1)
+                << allocationsIt->second << " after the warmup, above the limit of " << _maxAllocationsPerUpdate << std::endl;
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+void Benchmark::SaveResults(std::map<std::string, Result> const& results, std::string const& filename)
+{
+    std::ofstream file(filename);
+    if (!file)
+    {
+        throw std::runtime_error("Error: Cannot open file " + filename + " for writing.");
+    }
+
+    file << "{\n  \"scenarios\": {";
+    for (auto resultIt = results.begin(); resultIt != results.end(); resultIt++)
+    {
+        file << (resultIt == results.begin() ? "\n" : ",\n")
+            << "    \"" << resultIt->first << "\": {\n"
+            << "      \"state_hash\": \"" << std::hex << std::setw(16) << std::setfill('0') << resultIt->second.stateHash << "\"";
+        for (auto metricIt = resultIt->second.metrics.begin(); metricIt != resultIt->second.metrics.end(); metricIt++)
+        {
+            file << ",\n      \"" << metricIt->first << "\": " << std::fixed << std::setprecision(3) << metricIt->second;
+        }
+        file << "\n    }";
+    }
+    file << "\n  }\n}\n";
+}
+
+std::map<std::string, Benchmark::Result> Benchmark::LoadResults(std::string const& filename)
+{
+    std::ifstream file(filename);
+    if (!file)
+    {
+        throw std::runtime_error("Error: Cannot open benchmark baseline " + filename + ". It can be created with --update-baseline.");
+    }
+    std::string const text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::runtime_error const formatError("Error: Benchmark baseline " + filename + " is not in the expected format.");
+
+    // Keys of the objects that are being read, from the outermost one, and the key of the next value
+    std::vector<std::string> objectKeys;
+    std::string key;
+    std::map<std::string, Result> results;
+    for (int i = 0; i < text.size(); i++)
+    {
+        std::string value;
+        if (text[i] == '{')
+        {
+            objectKeys.push_back(key);
+            key.clear();
+            continue;
+        }
+        else if (text[i] == '}')
+        {
+            if (objectKeys.empty())
+            {
+                throw formatError;
+            }
+            objectKeys.pop_back();
+            continue;
+        }
+        else if (text[i] == '"')
+        {
+            std::size_t const end = text.find('"', i + 1);
+            if (end == std::string::npos)
+            {
+                throw formatError;
+            }
+            value = text.substr(i + 1, end - i - 1);
+            i = end;
+
+            // A string followed by a colon is the key of the next value
+            std::size_t const next = text.find_first_not_of(" \t\r\n", end + 1);
+            if (next != std::string::npos && text[next] == ':')
+            {
+                key = value;
+                i = next;
+                continue;
+            }
+        }
+        else if (text[i] == '-' || (text[i] >= '0' && text[i] <= '9'))
+        {
+            char* end = nullptr;
+            std::strtod(text.c_str() + i, &end);
+            value = text.substr(i, end - text.c_str() - i);
+            i = end - text.c_str() - 1;
+        }
+        else
+        {
+            continue;
+        }
+
+        // Values of a scenario, which is in the object of the scenarios
+        if (objectKeys.size() != 3 || objectKeys[1] != "scenarios")
+        {
+            continue;
+        }
+        Result& result = results[objectKeys[2]];
+        if (key == "state_hash")
+        {
+            result.stateHash = std::stoull(value, nullptr, 16);
+        }
+        else
+        {
+            result.metrics[key] = std::stod(value);
+        }
+    }
+    if (!objectKeys.empty())
+    {
+        throw formatError;
+    }
+    return results;
+}
+
+} // namespace HideAndSeekAndShoot
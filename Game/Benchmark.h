@@ -0,0 +1,194 @@
+#pragma once
+
+#include "World.h"
+#include "FrameArena.h"
+#include "resources/ResourceHandler.hpp"
+#include "resources/ResourceIDs.hpp"
+
+#include <SFML/Graphics.hpp>
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+typedef std::map<std::string, std::string> Config;
+
+namespace HideAndSeekAndShoot
+{
+
+class Game;
+
+/**
+ * Headless benchmark of the world's updates, for catching performance regressions.
+ * Runs a fixed set of seeded scenarios - each generated map style with each number of enemies,
+ * with and without a storm of bullets, and a crowd of enemies steering around each other -
+ * with scripted controls instead of the user's, without a window.
+ * For each scenario it measures percentiles of the updates' times and the heap allocations per update,
+ * and compares them with a baseline saved by an earlier run, failing if any of them got worse beyond a threshold.
+ * It also fails if the updates after the warmup allocate more than a fixed limit, which is 0 by default,
+ * as steady-state updates should take all their transient memory from the frame arena.
+ * 
+ * Allocations are measured only when the game is built with allocation tracking.
+ * The baseline is a JSON file, so it can be read and diffed when it is updated with the code.
+ */
+class Benchmark
+{
+
+  public: /* types */
+
+    /// Measurements of a scenario
+    struct Result
+    {
+        /// Hash of the world's state after the last update, which tells whether the scenario still simulates the same
+        std::uint64_t stateHash;
+        /// Measured metrics by their names
+        std::map<std::string, double> metrics;
+    };
+
+  public:
+
+    /**
+     * Creates a benchmark with the scenarios specified in the benchmark config
+     * 
+     * @param[in] game
+     *  Pointer to the game whose worlds are benchmarked
+     * @param[in] texHandler
+     *  Pointer to texture handler with loaded textures
+     * @param[in] frameArena
+     *  Pointer to the arena from which the worlds allocate memory that lives only during a single update
+     * @param[in] viewSize
+     *  Size of the view of the worlds, in pixels
+     */
+    Benchmark(
+        Game const* game,
+        Resources::ResourceHandler<Resources::Texture::Id, sf::Texture> const* texHandler,
+        FrameArena* frameArena,
+        sf::Vector2f viewSize
+    );
+
+    /**
+     * Runs all the scenarios and compares their results with the baseline, or saves them as the new baseline.
+     * Scenarios that are not in the baseline are only reported.
+     * 
+     * @param[in] baselineFilename
+     *  Name of the baseline file
+     * @param[in] updateBaseline
+     *  Whether to save the results as the new baseline instead of comparing with it
+     * @param[in,out] log
+     *  Stream to which the results and the regressions are written
+     * 
+     * @return true if no metric has regressed beyond its threshold and no scenario allocates beyond the limit, false otherwise
+     */
+    bool Run(std::string const& baselineFilename, bool updateBaseline, std::ostream& log);
+
+  private: /* types */
+
+    /// A scenario of the benchmark
+    struct Scenario
+    {
+        /// Name of the scenario, by which it is found in the baseline
+        std::string name;
+        /// Style of the generated map
+        std::string mapStyle;
+        /// Number of enemies
+        int enemiesCount;
+        /// Whether the player shoots in every update
+        bool bulletStorm;
+        /// Whether the enemies steer around each other
+        bool crowdSteering;
+    };
+
+  private: /* functions */
+
+    /// Configures the scenarios, the number of updates and the thresholds, as specified in the config
+    void ConfigScenarios();
+
+    /**
+     * Runs a scenario the configured number of times, keeping the lowest of each metric, which are the least disturbed.
+     * Throws if the repetitions don't simulate the same game, as their metrics wouldn't be comparable.
+     */
+    Result RunScenario(Scenario const& scenario) const;
+
+    /**
+     * Checks the results against the baseline and reports the regressions
+     * 
+     * @return true if no metric has regressed beyond its threshold, false otherwise
+     */
+    bool CompareWithBaseline(
+        std::map<std::string, Result> const& results,
+        std::map<std::string, Result> const& baseline,
+        std::ostream& log) const;
+
+    /**
+     * Checks that the steady-state updates of each scenario allocate no more than the limit, and reports those that do
+     * 
+     * @return true if no scenario allocates beyond the limit, false otherwise
+     */
+    bool CheckSteadyStateAllocations(std::map<std::string, Result> const& results, std::ostream& log) const;
+
+    /// Saves results to a JSON file
+    static void SaveResults(std::map<std::string, Result> const& results, std::string const& filename);
+
+    /**
+     * Loads results from a JSON file written by SaveResults.
+     * Only that layout is understood - an object of scenarios by their names, each an object of metrics by their names.
+     */
+    static std::map<std::string, Result> LoadResults(std::string const& filename);
+
+  private: /* variables */
+
+    /// Pointer to the game whose worlds are benchmarked
+    Game const* _game;
+
+    /// Pointer to the texture handler with loaded textures
+    Resources::ResourceHandler<Resources::Texture::Id, sf::Texture> const* _texHandler;
+
+    /// Pointer to the arena from which the worlds allocate memory that lives only during a single update
+    FrameArena* _frameArena;
+
+    /// Size of the view of the worlds, in pixels
+    sf::Vector2f _viewSize;
+
+    /// Benchmark configuration
+    Config _config;
+
+    /// The scenarios to run
+    std::vector<Scenario> _scenarios;
+
+    /// Number of walls of the generated maps
+    int _mapWallsCount;
+
+    /// Scale of the worlds of the generated maps, relative to the view's size
+    float _mapWorldScale;
+
+    /// Seed of the generated maps and of the scripted controls
+    unsigned _seed;
+
+    /// Number of updates before the measured ones, during which the caches fill up
+    int _warmupUpdates;
+
+    /// Number of measured updates
+    int _updates;
+
+    /// Number of times each scenario is run
+    int _repetitions;
+
+    /// Relative increase of an update time percentile that counts as a regression
+    double _timeThreshold;
+
+    /// Increase of an update time percentile, in microseconds, that is too small to count as a regression, however big relatively
+    double _timeNoiseMicroseconds;
+
+    /// Relative increase of the allocations per update that counts as a regression
+    double _allocationThreshold;
+
+    /// Number of heap allocations per update allowed after the warmup, whatever the baseline
+    double _maxAllocationsPerUpdate;
+
+    /// Never opened, the scenarios' controls are scripted. Control states need a window all the same.
+    sf::RenderWindow _window;
+};
+
+} // namespace HideAndSeekAndShoot
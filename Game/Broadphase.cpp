@@ -0,0 +1,74 @@
+#include "Broadphase.h"
+
+namespace HideAndSeekAndShoot
+{
+
+void Broadphase::Resize(int count)
+{
+    if (count < _boxes.size())
+    {
+        // Removing the boxes that don't exist anymore from the order, keeping it otherwise the same
+        int kept = 0;
+        for (int i = 0; i < _order.size(); i++)
+        {
+            if (_order[i] < count)
+            {
+                _order[kept++] = _order[i];
+            }
+        }
+        _order.resize(kept);
+    }
+    else
+    {
+        for (int id = _boxes.size(); id < count; id++)
+        {
+            _order.push_back(id);
+        }
+    }
+
+    _boxes.resize(count);
+}
+
+void Broadphase::SetBox(int id, Box const& box)
+{
+    _boxes[id] = box;
+}
+
+void Broadphase::FindOverlappingPairs(std::pmr::vector<std::pair<int, int>>& pairs)
+{
+    SortBoxes();
+
+    for (int i = 0; i < _order.size(); i++)
+    {
+        Box const& boxA = _boxes[_order[i]];
+        // Only boxes starting before this one ends can overlap with it, and they are right after it in the order
+        for (int j = i + 1; j < _order.size() && _boxes[_order[j]].minX <= boxA.maxX; j++)
+        {
+            Box const& boxB = _boxes[_order[j]];
+            if (boxA.minY <= boxB.maxY && boxB.minY <= boxA.maxY)
+            {
+                pairs.emplace_back(_order[i], _order[j]);
+            }
+        }
+    }
+}
+
+void Broadphase::SortBoxes()
+{
+    // Insertion sort, which is almost linear for an almost sorted order
+    for (int i = 1; i < _order.size(); i++)
+    {
+        int const id = _order[i];
+        float const minX = _boxes[id].minX;
+
+        int j = i - 1;
+        while (j >= 0 && _boxes[_order[j]].minX > minX)
+        {
+            _order[j + 1] = _order[j];
+            j--;
+        }
+        _order[j + 1] = id;
+    }
+}
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * Sort-and-sweep broadphase, finding which of a set of axis-aligned boxes overlap.
+ * Boxes are kept sorted by their left side between calls, and are re-sorted with insertion sort.
+ * Since things move only a little between two frames, the order is almost unchanged,
+ * so re-sorting it is close to a linear pass, and so is the sweep over it,
+ * unless many boxes overlap on the x axis.
+ */
+class Broadphase
+{
+
+  public: /* types */
+
+    /// An axis-aligned box
+    struct Box
+    {
+        float minX;
+        float maxX;
+        float minY;
+        float maxY;
+    };
+
+  public:
+
+    /**
+     * Sets the number of boxes.
+     * Boxes that already exist keep their place in the sorted order, and new ones are added at its end.
+     * 
+     * @param[in] count
+     *  Number of boxes
+     */
+    void Resize(int count);
+
+    /**
+     * Sets a box's coordinates for the next search
+     * 
+     * @param[in] id
+     *  Index of the box, from 0 to the number of boxes
+     * @param[in] box
+     *  The box's coordinates
+     */
+    void SetBox(int id, Box const& box);
+
+    /**
+     * Finds all pairs of overlapping boxes
+     * 
+     * @param[out] pairs
+     *  Vector to which the pairs of indices of overlapping boxes are appended
+     */
+    void FindOverlappingPairs(std::pmr::vector<std::pair<int, int>>& pairs);
+
+  private: /* functions */
+
+    /// Sorts the boxes by their left side, starting from the order of the last search
+    void SortBoxes();
+
+  private: /* variables */
+
+    /// Coordinates of the boxes, by index
+    std::vector<Box> _boxes;
+
+    /// Indices of the boxes, sorted by their left side as of the last search
+    std::vector<int> _order;
+};
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,317 @@
+#include "ChunkedMap.h"
+
+#include "MapGenerator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+
+char const BINARY_MAGIC[4] = { 'H', 'S', 'S', 'C' };
+
+} // namespace
+
+namespace HideAndSeekAndShoot
+{
+
+ChunkedMap::ChunkedMap()
+    : _tilesPerSide(0),
+    _capacity(0),
+    _requestCount(0),
+    _tileBeingLoaded(-1),
+    _loading(false)
+{}
+
+ChunkedMap::~ChunkedMap()
+{
+    if (!_loadingThread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _loading = false;
+    }
+    _requestSignal.notify_one();
+    _loadingThread.join();
+}
+
+void ChunkedMap::Build(std::vector<std::vector<sf::Vector2f>> const& polygons, int tilesPerSide, std::string const& filename)
+{
+    if (tilesPerSide <= 0)
+    {
+        throw std::runtime_error("Error: The number of tiles per side of a chunked map must be positive.");
+    }
+
+    // A polygon is put in every tile that its box overlaps
+    int const tilesCount = tilesPerSide * tilesPerSide;
+    std::vector<std::vector<int>> tilePolygons(tilesCount);
+    for (int polygonInd = 0; polygonInd < polygons.size(); polygonInd++)
+    {
+        std::vector<sf::Vector2f> const& polygon = polygons[polygonInd];
+        if (polygon.empty())
+        {
+            continue;
+        }
+
+        sf::Vector2f boxMin = polygon[0], boxMax = polygon[0];
+        for (int verInd = 1; verInd < polygon.size(); verInd++)
+        {
+            boxMin = sf::Vector2f(std::min(boxMin.x, polygon[verInd].x), std::min(boxMin.y, polygon[verInd].y));
+            boxMax = sf::Vector2f(std::max(boxMax.x, polygon[verInd].x), std::max(boxMax.y, polygon[verInd].y));
+        }
+        int const minTileX = std::clamp((int)(boxMin.x * tilesPerSide), 0, tilesPerSide - 1);
+        int const minTileY = std::clamp((int)(boxMin.y * tilesPerSide), 0, tilesPerSide - 1);
+        int const maxTileX = std::clamp((int)(boxMax.x * tilesPerSide), 0, tilesPerSide - 1);
+        int const maxTileY = std::clamp((int)(boxMax.y * tilesPerSide), 0, tilesPerSide - 1);
+        for (int tileY = minTileY; tileY <= maxTileY; tileY++)
+        {
+            for (int tileX = minTileX; tileX <= maxTileX; tileX++)
+            {
+                tilePolygons[tileY * tilesPerSide + tileX].push_back(polygonInd);
+            }
+        }
+    }
+
+    // Tiles' data follows the header and the directory, so their offsets are known before writing them
+    std::vector<std::uint64_t> tileOffsets(tilesCount + 1);
+    tileOffsets[0] = sizeof(BINARY_MAGIC) + sizeof(std::uint32_t) + tileOffsets.size() * sizeof(std::uint64_t);
+    for (int tileInd = 0; tileInd < tilesCount; tileInd++)
+    {
+        std::uint64_t tileSize = sizeof(std::uint32_t);
+        for (int i = 0; i < tilePolygons[tileInd].size(); i++)
+        {
+            tileSize += 2 * sizeof(std::uint32_t) + polygons[tilePolygons[tileInd][i]].size() * 2 * sizeof(float);
+        }
+        tileOffsets[tileInd + 1] = tileOffsets[tileInd] + tileSize;
+    }
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Error: Cannot open file " + filename + " for writing.");
+    }
+
+    auto writeUint = [&file](std::uint32_t value) {
+        file.write(reinterpret_cast<char const*>(&value), sizeof(value));
+    };
+
+    file.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    writeUint(tilesPerSide);
+    file.write(reinterpret_cast<char const*>(tileOffsets.data()), tileOffsets.size() * sizeof(std::uint64_t));
+    for (int tileInd = 0; tileInd < tilesCount; tileInd++)
+    {
+        writeUint(tilePolygons[tileInd].size());
+        for (int i = 0; i < tilePolygons[tileInd].size(); i++)
+        {
+            int const polygonInd = tilePolygons[tileInd][i];
+            writeUint(polygonInd);
+            writeUint(polygons[polygonInd].size());
+            for (int verInd = 0; verInd < polygons[polygonInd].size(); verInd++)
+            {
+                float const coords[2] = { polygons[polygonInd][verInd].x, polygons[polygonInd][verInd].y };
+                file.write(reinterpret_cast<char const*>(coords), sizeof(coords));
+            }
+        }
+    }
+}
+
+void ChunkedMap::Open(std::string const& filename, int capacity)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Error: Cannot open chunked map file " + filename + ".");
+    }
+
+    char magic[sizeof(BINARY_MAGIC)];
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0)
+    {
+        throw std::runtime_error("Error: File " + filename + " is not a chunked map.");
+    }
+
+    std::uint32_t tilesPerSide = 0;
+    file.read(reinterpret_cast<char*>(&tilesPerSide), sizeof(tilesPerSide));
+    _tileOffsets.resize(file ? tilesPerSide * tilesPerSide + 1 : 0);
+    file.read(reinterpret_cast<char*>(_tileOffsets.data()), _tileOffsets.size() * sizeof(std::uint64_t));
+    if (!file || tilesPerSide == 0)
+    {
+        throw std::runtime_error("Error: Chunked map " + filename + " is truncated.");
+    }
+
+    _filename = filename;
+    _tilesPerSide = tilesPerSide;
+    _capacity = std::max(capacity, 1);
+
+    _loading = true;
+    _loadingThread = std::thread(&ChunkedMap::LoadTiles, this);
+}
+
+bool ChunkedMap::IsOpen() const
+{
+    return !_filename.empty();
+}
+
+int ChunkedMap::GetTilesPerSide() const
+{
+    return _tilesPerSide;
+}
+
+void ChunkedMap::Request(std::pmr::vector<int> const& tileInds)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _requestCount++;
+        _pendingTiles.clear();
+        for (int i = 0; i < tileInds.size(); i++)
+        {
+            auto const loaded = _loadedTiles.find(tileInds[i]);
+            if (loaded != _loadedTiles.end())
+            {
+                loaded->second.lastRequest = _requestCount;
+            }
+            else if (tileInds[i] != _tileBeingLoaded)
+            {
+                _pendingTiles.push_back(tileInds[i]);
+            }
+        }
+        UnloadSurplusTiles();
+    }
+    _requestSignal.notify_one();
+}
+
+std::shared_ptr<ChunkedMap::Tile const> ChunkedMap::WaitForTile(int tileInd)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_loadedTiles.find(tileInd) == _loadedTiles.end()
+        && tileInd != _tileBeingLoaded
+        && std::find(_pendingTiles.begin(), _pendingTiles.end(), tileInd) == _pendingTiles.end())
+    {
+        _pendingTiles.insert(_pendingTiles.begin(), tileInd);
+        _requestSignal.notify_one();
+    }
+    _loadSignal.wait(lock, [this, tileInd]() { return _loadError || _loadedTiles.find(tileInd) != _loadedTiles.end(); });
+    if (_loadError)
+    {
+        std::rethrow_exception(_loadError);
+    }
+    return _loadedTiles[tileInd].tile;
+}
+
+void ChunkedMap::LoadTiles()
+{
+    std::ifstream file(_filename, std::ios::binary);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        _requestSignal.wait(lock, [this]() { return !_pendingTiles.empty() || !_loading; });
+        if (!_loading)
+        {
+            return;
+        }
+
+        int const tileInd = _pendingTiles.front();
+        _pendingTiles.erase(_pendingTiles.begin());
+        _tileBeingLoaded = tileInd;
+
+        // The file is read without the lock, so that requests don't wait for it
+        lock.unlock();
+        std::shared_ptr<Tile const> tile;
+        std::exception_ptr error;
+        try
+        {
+            tile = ReadTile(file, tileInd);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+        _tileBeingLoaded = -1;
+
+        // A tile counts as requested when it is loaded, so that it isn't unloaded before it can be used
+        if (error)
+        {
+            _loadError = error;
+        }
+        else
+        {
+            _loadedTiles[tileInd] = { tile, _requestCount };
+            UnloadSurplusTiles();
+        }
+        _loadSignal.notify_all();
+    }
+}
+
+std::shared_ptr<ChunkedMap::Tile const> ChunkedMap::ReadTile(std::ifstream& file, int tileInd) const
+{
+    if (tileInd < 0 || tileInd + 1 >= _tileOffsets.size())
+    {
+        throw std::runtime_error("Error: Tile " + std::to_string(tileInd) + " is not in chunked map " + _filename + ".");
+    }
+
+    auto readUint = [&file]() -> std::uint32_t {
+        std::uint32_t value = 0;
+        file.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    };
+
+    file.clear();
+    file.seekg(_tileOffsets[tileInd]);
+    std::vector<std::vector<sf::Vector2f>> polygons(readUint());
+    std::vector<int> polygonInds(polygons.size());
+    for (int i = 0; i < polygons.size() && file; i++)
+    {
+        polygonInds[i] = readUint();
+        polygons[i].resize(readUint());
+        for (int verInd = 0; verInd < polygons[i].size() && file; verInd++)
+        {
+            float coords[2];
+            file.read(reinterpret_cast<char*>(coords), sizeof(coords));
+            polygons[i][verInd] = { coords[0], coords[1] };
+        }
+    }
+    if (!file)
+    {
+        throw std::runtime_error("Error: Chunked map " + _filename + " is truncated.");
+    }
+
+    // Walls are split into convex parts here, so that it doesn't hold up the world
+    std::shared_ptr<Tile> tile = std::make_shared<Tile>();
+    MapGenerator::SplitIntoConvexWalls(polygons, tile->relWalls, tile->polygonInds);
+    for (int wallInd = 0; wallInd < tile->polygonInds.size(); wallInd++)
+    {
+        tile->polygonInds[wallInd] = polygonInds[tile->polygonInds[wallInd]];
+    }
+    return tile;
+}
+
+void ChunkedMap::UnloadSurplusTiles()
+{
+    while (_loadedTiles.size() > _capacity)
+    {
+        auto oldest = _loadedTiles.end();
+        for (auto it = _loadedTiles.begin(); it != _loadedTiles.end(); it++)
+        {
+            if (it->second.lastRequest < _requestCount
+                && (oldest == _loadedTiles.end() || it->second.lastRequest < oldest->second.lastRequest))
+            {
+                oldest = it;
+            }
+        }
+        // The requested tiles are kept even if there are too many of them
+        if (oldest == _loadedTiles.end())
+        {
+            return;
+        }
+        _loadedTiles.erase(oldest);
+    }
+}
+
+} // namespace HideAndSeekAndShoot
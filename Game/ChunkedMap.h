@@ -0,0 +1,169 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <iosfwd>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * A map split into square tiles, streamed from a file so that maps too big for the memory can be played.
+ * The world is covered by a grid of tiles, and the file lists for each tile the walls that overlap it.
+ * Only the file's directory of tiles is kept in memory all the time, and tiles are loaded on a background thread
+ * when they are requested. Tiles that are no longer requested are unloaded once more than a given number
+ * of tiles are loaded, so the memory stays bounded however big the map is.
+ * 
+ * Coordinates are relative to the world's size, as for the other map formats.
+ */
+class ChunkedMap
+{
+
+  public: /* types */
+
+    /// The walls overlapping a tile
+    struct Tile
+    {
+        /// Convex walls, in relative coordinates
+        std::vector<std::vector<sf::Vector2f>> relWalls;
+        /**
+         * For each wall, index of the polygon of the whole map that it is a part of.
+         * A polygon overlapping several tiles is in each of them, with the same index.
+         */
+        std::vector<int> polygonInds;
+    };
+
+  public:
+
+    /// Creates a map that is not open, without any tiles
+    ChunkedMap();
+
+    /// Stops loading tiles
+    ~ChunkedMap();
+
+    /**
+     * Splits a map into tiles and saves them to a file. The format is the magic "HSSC", then the number of tiles per side,
+     * then the offset of each tile's data in the file, row by row, with the end of the last one, all as 64-bit values.
+     * A tile's data is the number of its polygons, and for each of them its index in the whole map,
+     * the number of its vertices and their coordinates, all as 32-bit values.
+     * 
+     * @param[in] polygons
+     *  Walls as polygons in relative coordinates
+     * @param[in] tilesPerSide
+     *  Number of columns and rows of tiles
+     * @param[in] filename
+     *  Name of the file to write
+     */
+    static void Build(std::vector<std::vector<sf::Vector2f>> const& polygons, int tilesPerSide, std::string const& filename);
+
+    /**
+     * Opens a file written by Build, reading only its directory of tiles, and starts loading tiles in the background.
+     * Throws an exception if the file cannot be read or is not in that format.
+     * 
+     * @param[in] filename
+     *  Name of the file to read
+     * @param[in] capacity
+     *  Number of tiles kept loaded. Requested tiles are kept even if there are more of them.
+     */
+    void Open(std::string const& filename, int capacity);
+
+    /// Returns whether a file is open
+    bool IsOpen() const;
+
+    /// Returns the number of columns and rows of tiles
+    int GetTilesPerSide() const;
+
+    /**
+     * Requests tiles to be loaded in the background, replacing the previous request.
+     * Tiles that are not requested anymore can be unloaded.
+     * 
+     * @param[in] tileInds
+     *  Indices of the tiles (row by row), in the order in which they should be loaded
+     */
+    void Request(std::pmr::vector<int> const& tileInds);
+
+    /**
+     * Returns a tile, waiting for it to be loaded if it isn't yet.
+     * Rethrows the exception with which loading a tile has failed, if any.
+     * 
+     * @param[in] tileInd
+     *  Index of the tile, which should have been requested
+     * 
+     * @return the tile, which stays valid even if it is unloaded from the map
+     */
+    std::shared_ptr<Tile const> WaitForTile(int tileInd);
+
+  private: /* types */
+
+    /// A loaded tile
+    struct LoadedTile
+    {
+        std::shared_ptr<Tile const> tile;
+        /// Number of the last request that asked for the tile
+        std::uint64_t lastRequest;
+    };
+
+  private: /* functions */
+
+    /// Loads the requested tiles, until the map is closed. Runs on the loading thread.
+    void LoadTiles();
+
+    /// Reads a tile from an open file
+    std::shared_ptr<Tile const> ReadTile(std::ifstream& file, int tileInd) const;
+
+    /// Unloads the tiles not asked for by the latest request, least recently requested first, while there are too many. Needs the lock.
+    void UnloadSurplusTiles();
+
+  private: /* variables */
+
+    /// Name of the open file, empty if none is open
+    std::string _filename;
+
+    /// Number of columns and rows of tiles
+    int _tilesPerSide;
+
+    /// Offset of each tile's data in the file, and the end of the last one
+    std::vector<std::uint64_t> _tileOffsets;
+
+    /// Number of tiles kept loaded
+    int _capacity;
+
+    /// Loaded tiles, by their indices
+    std::unordered_map<int, LoadedTile> _loadedTiles;
+
+    /// Requested tiles that are not loaded yet, in the order in which they should be loaded
+    std::vector<int> _pendingTiles;
+
+    /// Number of the latest request
+    std::uint64_t _requestCount;
+
+    /// Index of the tile being loaded, -1 if none is
+    int _tileBeingLoaded;
+
+    /// Exception with which loading a tile has failed, if any
+    std::exception_ptr _loadError;
+
+    /// Whether the loading thread should keep running
+    bool _loading;
+
+    /// Thread loading the tiles
+    std::thread _loadingThread;
+
+    /// Mutex guarding everything that the loading thread shares
+    std::mutex _mutex;
+
+    /// Signal that tiles were requested or the map is closed, and that a tile was loaded
+    std::condition_variable _requestSignal, _loadSignal;
+};
+
+} // namespace HideAndSeekAndShoot
@@ -22,10 +22,9 @@ ControlState::ControlState(
     _downKey(downKey),
     _leftKey(leftKey),
     _rightKey(rightKey),
-    _window(window),
-    _config(ConfigUtils::ReadConfig(CONTROLS_CONFIG_FILENAME))
+    _window(&window)
 {
-    ConfigTimeBetweenShoots();
+    ConfigTimeBetweenShoots(ConfigUtils::ReadConfig(CONTROLS_CONFIG_FILENAME));
     _timeSinceLastShootButtonPress = _timeBetweenShoots;
 }
 
@@ -36,7 +35,7 @@ void ControlState::Update()
     _leftPressed = sf::Keyboard::isKeyPressed(_leftKey);
     _rightPressed = sf::Keyboard::isKeyPressed(_rightKey);
 
-    _mousePosition = (sf::Vector2f)sf::Mouse::getPosition(_window);
+    _mousePosition = (sf::Vector2f)sf::Mouse::getPosition(*_window);
 
     _shootButtonPressed = sf::Mouse::isButtonPressed(sf::Mouse::Left);
     if (_shootButtonPressed)
@@ -53,6 +52,16 @@ void ControlState::Update()
     _timeSinceLastShootButtonPress++;
 }
 
+void ControlState::SetScripted(bool up, bool down, bool left, bool right, bool shoot, sf::Vector2f const mousePosition)
+{
+    _upPressed = up;
+    _downPressed = down;
+    _leftPressed = left;
+    _rightPressed = right;
+    _shootButtonPressed = shoot;
+    _mousePosition = mousePosition;
+}
+
 bool ControlState::IsUpPressed() const
 {
     return _upPressed;
@@ -83,10 +92,10 @@ sf::Vector2f ControlState::GetMousePosition() const
     return _mousePosition;
 }
 
-void ControlState::ConfigTimeBetweenShoots()
+void ControlState::ConfigTimeBetweenShoots(Config const& config)
 {
-    auto timeBetweenShootsConfig = _config.find("time_between_shoots");
-    if (timeBetweenShootsConfig != _config.end())
+    auto timeBetweenShootsConfig = config.find("time_between_shoots");
+    if (timeBetweenShootsConfig != config.end())
     {
         _timeBetweenShoots = std::stoi(timeBetweenShootsConfig->second);
     }
@@ -47,6 +47,19 @@ struct ControlState
      */
     void Update();
 
+    /**
+     * Sets the control state to scripted controls instead of the user input, for running the game without a user.
+     * Unlike the shoot button, scripted shots are not limited by the time between shots - the script decides when to shoot.
+     * 
+     * @param[in] up, down, left, right
+     *  Whether the UP, DOWN, LEFT and RIGHT keys are pressed
+     * @param[in] shoot
+     *  Whether the player shoots
+     * @param[in] mousePosition
+     *  Position of the mouse relative to the window
+     */
+    void SetScripted(bool up, bool down, bool left, bool right, bool shoot, sf::Vector2f const mousePosition);
+
     /// Functions used to check whether the UP, DOWN, LEFT or RIGHT key is currently pressed
     bool IsUpPressed() const;
     bool IsDownPressed() const;
@@ -65,8 +78,13 @@ struct ControlState
 
   private: /* functions */
 
-    /// Configures time between shots, as specified in the config
-    void ConfigTimeBetweenShoots();
+    /**
+     * Configures time between shots, as specified in the config
+     * 
+     * @param[in] config
+     *  Controls configuration. It is not kept, so that copying control states doesn't allocate.
+     */
+    void ConfigTimeBetweenShoots(Config const& config);
 
   private: /* variables */
 
@@ -86,11 +104,8 @@ struct ControlState
     /// Position of the mouse on the window
     sf::Vector2f _mousePosition;
 
-    /// Window on which the controls are applied
-    sf::RenderWindow const& _window;
-
-    /// Controls configuration
-    Config _config;
+    /// Window on which the controls are applied (a pointer, so that control states can be copied)
+    sf::RenderWindow const* _window;
 };
 
 } // namespace HideAndSeekAndShoot
\ No newline at end of file
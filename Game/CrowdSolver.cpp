@@ -0,0 +1,474 @@
+#include "CrowdSolver.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+float const NEIGHBOUR_DISTANCE_DEFAULT = 100.f;
+
+int const MAX_NEIGHBOURS_DEFAULT = 10;
+
+float const TIME_HORIZON_DEFAULT = 30.f;
+
+float const OBSTACLE_TIME_HORIZON_DEFAULT = 10.f;
+
+// Lines whose directions are closer to parallel than this are treated as parallel
+float const PARALLEL_EPSILON = 0.00001f;
+
+// Maximal number of cells of the grid of the agents, which keeps it small when agents are spread far apart
+int const AGENT_CELLS_COUNT_MAX = 1 << 16;
+
+float Dot(sf::Vector2f const a, sf::Vector2f const b)
+{
+    return a.x * b.x + a.y * b.y;
+}
+
+// Determinant of the matrix with the vectors as rows, positive if b is to the left of a
+float Det(sf::Vector2f const a, sf::Vector2f const b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+} // namespace
+
+namespace HideAndSeekAndShoot
+{
+
+CrowdSolver::CrowdSolver()
+    : _neighbourDistance(NEIGHBOUR_DISTANCE_DEFAULT),
+    _maxNeighbours(MAX_NEIGHBOURS_DEFAULT),
+    _timeHorizon(TIME_HORIZON_DEFAULT),
+    _obstacleTimeHorizon(OBSTACLE_TIME_HORIZON_DEFAULT)
+{}
+
+void CrowdSolver::SetParameters(float neighbourDistance, int maxNeighbours, float timeHorizon, float obstacleTimeHorizon)
+{
+    _neighbourDistance = neighbourDistance;
+    _maxNeighbours = maxNeighbours;
+    _timeHorizon = timeHorizon;
+    _obstacleTimeHorizon = obstacleTimeHorizon;
+}
+
+void CrowdSolver::Rescale(float scale)
+{
+    _neighbourDistance *= scale;
+}
+
+void CrowdSolver::Solve(
+    std::pmr::vector<Agent> const& agents,
+    WallGrid const& wallGrid,
+    WallEdgeTable const& wallEdges,
+    std::pmr::vector<sf::Vector2f>& velocities) const
+{
+    std::pmr::memory_resource* const memory = velocities.get_allocator().resource();
+    velocities.resize(agents.size());
+    if (agents.empty())
+    {
+        return;
+    }
+
+    /* Putting the agents into a grid with cells of the neighbour distance,
+       so that an agent's neighbours are in the cells around its own */
+    sf::Vector2f gridMin = agents[0].position, gridMax = agents[0].position;
+    for (int i = 1; i < agents.size(); i++)
+    {
+        gridMin.x = std::min(gridMin.x, agents[i].position.x);
+        gridMin.y = std::min(gridMin.y, agents[i].position.y);
+        gridMax.x = std::max(gridMax.x, agents[i].position.x);
+        gridMax.y = std::max(gridMax.y, agents[i].position.y);
+    }
+    float cellSize = std::max(_neighbourDistance, 1.f);
+    float const gridArea = (gridMax.x - gridMin.x + cellSize) * (gridMax.y - gridMin.y + cellSize);
+    cellSize = std::max(cellSize, std::sqrt(gridArea / AGENT_CELLS_COUNT_MAX));
+    int const cellsCountX = (int)((gridMax.x - gridMin.x) / cellSize) + 1;
+    int const cellsCountY = (int)((gridMax.y - gridMin.y) / cellSize) + 1;
+
+    auto getCellInd = [gridMin, cellSize, cellsCountX](sf::Vector2f const position) -> int {
+        return (int)((position.y - gridMin.y) / cellSize) * cellsCountX + (int)((position.x - gridMin.x) / cellSize);
+    };
+
+    std::pmr::vector<int> cellBegin(cellsCountX * cellsCountY + 1, 0, memory);
+    for (int i = 0; i < agents.size(); i++)
+    {
+        cellBegin[getCellInd(agents[i].position) + 1]++;
+    }
+    for (int cellInd = 0; cellInd + 1 < cellBegin.size(); cellInd++)
+    {
+        cellBegin[cellInd + 1] += cellBegin[cellInd];
+    }
+    std::pmr::vector<int> cellAgents(agents.size(), memory);
+    std::pmr::vector<int> cellFilled(cellBegin.begin(), cellBegin.end() - 1, memory);
+    for (int i = 0; i < agents.size(); i++)
+    {
+        cellAgents[cellFilled[getCellInd(agents[i].position)]++] = i;
+    }
+
+    // Vectors reused between agents, so that they are allocated only a few times per update
+    std::pmr::vector<std::pair<float, int>> neighbours(memory);
+    std::pmr::vector<int> wallInds(memory);
+    std::pmr::vector<Line> lines(memory);
+
+    for (int i = 0; i < agents.size(); i++)
+    {
+        Agent const& agent = agents[i];
+        if (!agent.movable)
+        {
+            velocities[i] = agent.velocity;
+            continue;
+        }
+
+        // Lines of the walls come first, since they are never violated for the sake of other agents
+        lines.clear();
+        AddObstacleLines(agent, wallGrid, wallEdges, wallInds, lines);
+        int const obstacleLinesCount = lines.size();
+
+        FindNeighbours(agents, i, cellBegin, cellAgents, gridMin, cellSize, cellsCountX, cellsCountY, neighbours);
+        for (int j = 0; j < neighbours.size(); j++)
+        {
+            AddAgentLine(agent, agents[neighbours[j].second], lines);
+        }
+
+        sf::Vector2f velocity;
+        int const failedLine = SolveLines(lines, agent.maxSpeed, agent.preferredVelocity, false, velocity);
+        if (failedLine < lines.size())
+        {
+            SolveLeastViolating(lines, obstacleLinesCount, failedLine, agent.maxSpeed, velocity);
+        }
+        velocities[i] = velocity;
+    }
+}
+
+void CrowdSolver::FindNeighbours(
+    std::pmr::vector<Agent> const& agents,
+    int agentInd,
+    std::pmr::vector<int> const& cellBegin,
+    std::pmr::vector<int> const& cellAgents,
+    sf::Vector2f const gridOrigin,
+    float cellSize,
+    int cellsCountX,
+    int cellsCountY,
+    std::pmr::vector<std::pair<float, int>>& neighbours) const
+{
+    neighbours.clear();
+    if (_maxNeighbours <= 0)
+    {
+        return;
+    }
+
+    sf::Vector2f const position = agents[agentInd].position;
+    int const minCellX = std::max((int)((position.x - _neighbourDistance - gridOrigin.x) / cellSize), 0);
+    int const minCellY = std::max((int)((position.y - _neighbourDistance - gridOrigin.y) / cellSize), 0);
+    int const maxCellX = std::min((int)((position.x + _neighbourDistance - gridOrigin.x) / cellSize), cellsCountX - 1);
+    int const maxCellY = std::min((int)((position.y + _neighbourDistance - gridOrigin.y) / cellSize), cellsCountY - 1);
+
+    // Once there are enough neighbours, only the ones closer than the furthest of them are taken
+    float rangeSq = _neighbourDistance * _neighbourDistance;
+    for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+    {
+        for (int cellX = minCellX; cellX <= maxCellX; cellX++)
+        {
+            int const cellInd = cellY * cellsCountX + cellX;
+            for (int k = cellBegin[cellInd]; k < cellBegin[cellInd + 1]; k++)
+            {
+                int const otherInd = cellAgents[k];
+                sf::Vector2f const diff = agents[otherInd].position - position;
+                float const distSq = Dot(diff, diff);
+                if (otherInd == agentInd || distSq >= rangeSq)
+                {
+                    continue;
+                }
+
+                // Inserting into the sorted neighbours, dropping the furthest one if there are too many
+                if (neighbours.size() < _maxNeighbours)
+                {
+                    neighbours.push_back({ distSq, otherInd });
+                }
+                int j = neighbours.size() - 1;
+                while (j > 0 && neighbours[j - 1].first > distSq)
+                {
+                    neighbours[j] = neighbours[j - 1];
+                    j--;
+                }
+                neighbours[j] = { distSq, otherInd };
+
+                if (neighbours.size() == _maxNeighbours)
+                {
+                    rangeSq = neighbours.back().first;
+                }
+            }
+        }
+    }
+}
+
+void CrowdSolver::AddObstacleLines(
+    Agent const& agent,
+    WallGrid const& wallGrid,
+    WallEdgeTable const& wallEdges,
+    std::pmr::vector<int>& wallInds,
+    std::pmr::vector<Line>& lines) const
+{
+    // Walls further than the agent can get within the time horizon don't limit its velocity
+    float const reach = _obstacleTimeHorizon * agent.maxSpeed;
+    float const range = reach + agent.radius;
+    wallInds.clear();
+    wallGrid.FindWallsInBox(
+        { agent.position.x - range, agent.position.x + range, agent.position.y - range, agent.position.y + range },
+        wallInds
+    );
+
+    float const invTimeHorizon = 1.f / _obstacleTimeHorizon;
+    for (int i = 0; i < wallInds.size(); i++)
+    {
+        for (int edgeInd = wallEdges.GetWallEdgesBegin(wallInds[i]); edgeInd < wallEdges.GetWallEdgesEnd(wallInds[i]); edgeInd++)
+        {
+            // Edges facing away from the agent are behind the ones facing it
+            sf::Vector2f const edgeNormal = wallEdges.GetEdgeNormal(edgeInd);
+            if (Dot(agent.position - wallEdges.GetEdgeStart(edgeInd), edgeNormal) < 0.f)
+            {
+                continue;
+            }
+
+            sf::Vector2f const fromEdge = agent.position - wallEdges.FindClosestPointOnEdge(edgeInd, agent.position);
+            float const dist = std::sqrt(Dot(fromEdge, fromEdge));
+            float const gap = dist - agent.radius;
+            if (gap > reach)
+            {
+                continue;
+            }
+
+            /* The agent may approach the edge's closest point by at most the gap within the time horizon.
+               An agent that is already touching the wall may only move along it or away from it. */
+            sf::Vector2f const away = (dist > 0.f) ? fromEdge / dist : edgeNormal;
+            Line line;
+            line.point = -away * (std::max(gap, 0.f) * invTimeHorizon);
+            line.direction = sf::Vector2f(away.y, -away.x);
+            lines.push_back(line);
+        }
+    }
+}
+
+void CrowdSolver::AddAgentLine(Agent const& agent, Agent const& neighbour, std::pmr::vector<Line>& lines) const
+{
+    sf::Vector2f const relPosition = neighbour.position - agent.position;
+    sf::Vector2f const relVelocity = agent.velocity - neighbour.velocity;
+    float const distSq = Dot(relPosition, relPosition);
+    float const combinedRadius = agent.radius + neighbour.radius;
+    float const combinedRadiusSq = combinedRadius * combinedRadius;
+    float const invTimeHorizon = 1.f / _timeHorizon;
+
+    Line line;
+    sf::Vector2f u;
+    if (distSq > combinedRadiusSq)
+    {
+        // Vector from the cutoff circle's center to the relative velocity
+        sf::Vector2f const w = relVelocity - invTimeHorizon * relPosition;
+        float const wLengthSq = Dot(w, w);
+        float const dotProduct = Dot(w, relPosition);
+
+        if (dotProduct < 0.f && dotProduct * dotProduct > combinedRadiusSq * wLengthSq)
+        {
+            // The relative velocity is closest to the cutoff circle
+            float const wLength = std::sqrt(wLengthSq);
+            sf::Vector2f const unitW = w / wLength;
+            line.direction = sf::Vector2f(unitW.y, -unitW.x);
+            u = (combinedRadius * invTimeHorizon - wLength) * unitW;
+        }
+        else
+        {
+            // The relative velocity is closest to one of the legs of the velocity obstacle
+            float const leg = std::sqrt(distSq - combinedRadiusSq);
+            if (Det(relPosition, w) > 0.f)
+            {
+                line.direction = sf::Vector2f(
+                    relPosition.x * leg - relPosition.y * combinedRadius,
+                    relPosition.x * combinedRadius + relPosition.y * leg
+                ) / distSq;
+            }
+            else
+            {
+                line.direction = -sf::Vector2f(
+                    relPosition.x * leg + relPosition.y * combinedRadius,
+                    -relPosition.x * combinedRadius + relPosition.y * leg
+                ) / distSq;
+            }
+            u = Dot(relVelocity, line.direction) * line.direction - relVelocity;
+        }
+    }
+    else
+    {
+        // The agents already overlap, so they have to get apart within a single update
+        sf::Vector2f const w = relVelocity - relPosition;
+        float const wLength = std::sqrt(Dot(w, w));
+        sf::Vector2f const unitW = (wLength > 0.f) ? w / wLength : sf::Vector2f(-1.f, 0.f);
+        line.direction = sf::Vector2f(unitW.y, -unitW.x);
+        u = (combinedRadius - wLength) * unitW;
+    }
+
+    // Movable neighbours take half of the effort of avoiding, and the others none of it
+    float const responsibility = neighbour.movable ? 0.5f : 1.f;
+    line.point = agent.velocity + responsibility * u;
+    lines.push_back(line);
+}
+
+bool CrowdSolver::SolveOnLine(
+    std::pmr::vector<Line> const& lines,
+    int lineInd,
+    float radius,
+    sf::Vector2f const optVelocity,
+    bool directionOpt,
+    sf::Vector2f& result)
+{
+    Line const& line = lines[lineInd];
+
+    // Part of the line within the circle of the maximal speed
+    float const dotProduct = Dot(line.point, line.direction);
+    float const discriminant = dotProduct * dotProduct + radius * radius - Dot(line.point, line.point);
+    if (discriminant < 0.f)
+    {
+        return false;
+    }
+    float const sqrtDiscriminant = std::sqrt(discriminant);
+    float tLeft = -dotProduct - sqrtDiscriminant;
+    float tRight = -dotProduct + sqrtDiscriminant;
+
+    // Cutting the part by each of the lines before
+    for (int i = 0; i < lineInd; i++)
+    {
+        float const denominator = Det(line.direction, lines[i].direction);
+        float const numerator = Det(lines[i].direction, line.point - lines[i].point);
+        if (std::fabs(denominator) <= PARALLEL_EPSILON)
+        {
+            // Parallel lines either allow the whole line or none of it
+            if (numerator < 0.f)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        float const t = numerator / denominator;
+        if (denominator >= 0.f)
+        {
+            tRight = std::min(tRight, t);
+        }
+        else
+        {
+            tLeft = std::max(tLeft, t);
+        }
+        if (tLeft > tRight)
+        {
+            return false;
+        }
+    }
+
+    if (directionOpt)
+    {
+        result = line.point + (Dot(optVelocity, line.direction) > 0.f ? tRight : tLeft) * line.direction;
+    }
+    else
+    {
+        float const t = Dot(line.direction, optVelocity - line.point);
+        result = line.point + std::min(std::max(t, tLeft), tRight) * line.direction;
+    }
+    return true;
+}
+
+int CrowdSolver::SolveLines(
+    std::pmr::vector<Line> const& lines,
+    float radius,
+    sf::Vector2f const optVelocity,
+    bool directionOpt,
+    sf::Vector2f& result)
+{
+    float const optLengthSq = Dot(optVelocity, optVelocity);
+    if (directionOpt)
+    {
+        // The optimization direction has unit length
+        result = optVelocity * radius;
+    }
+    else if (optLengthSq > radius * radius)
+    {
+        result = optVelocity / std::sqrt(optLengthSq) * radius;
+    }
+    else
+    {
+        result = optVelocity;
+    }
+
+    for (int i = 0; i < lines.size(); i++)
+    {
+        // Only if the result so far is not allowed by the line, the new result is on the line
+        if (Det(lines[i].direction, lines[i].point - result) > 0.f)
+        {
+            sf::Vector2f const prevResult = result;
+            if (!SolveOnLine(lines, i, radius, optVelocity, directionOpt, result))
+            {
+                result = prevResult;
+                return i;
+            }
+        }
+    }
+
+    return lines.size();
+}
+
+void CrowdSolver::SolveLeastViolating(
+    std::pmr::vector<Line> const& lines,
+    int obstacleLinesCount,
+    int beginLine,
+    float radius,
+    sf::Vector2f& result)
+{
+    std::pmr::vector<Line> projectedLines(lines.get_allocator().resource());
+    float distance = 0.f;
+
+    for (int i = beginLine; i < lines.size(); i++)
+    {
+        // Lines violated less than the result's current violation don't change it
+        if (Det(lines[i].direction, lines[i].point - result) <= distance)
+        {
+            continue;
+        }
+
+        /* The least violating velocity of this line and the ones before it is where the violations are equal,
+           so the other lines are replaced by the lines of equal violation with this one */
+        projectedLines.assign(lines.begin(), lines.begin() + obstacleLinesCount);
+        for (int j = obstacleLinesCount; j < i; j++)
+        {
+            Line projected;
+            float const determinant = Det(lines[i].direction, lines[j].direction);
+            if (std::fabs(determinant) <= PARALLEL_EPSILON)
+            {
+                // Lines in the same direction are violated in the same way, and opposite ones are equal in the middle
+                if (Dot(lines[i].direction, lines[j].direction) > 0.f)
+                {
+                    continue;
+                }
+                projected.point = 0.5f * (lines[i].point + lines[j].point);
+            }
+            else
+            {
+                projected.point = lines[i].point
+                    + (Det(lines[j].direction, lines[i].point - lines[j].point) / determinant) * lines[i].direction;
+            }
+
+            sf::Vector2f const direction = lines[j].direction - lines[i].direction;
+            projected.direction = direction / std::sqrt(Dot(direction, direction));
+            projectedLines.push_back(projected);
+        }
+
+        sf::Vector2f const prevResult = result;
+        sf::Vector2f const perpendicular(-lines[i].direction.y, lines[i].direction.x);
+        if (SolveLines(projectedLines, radius, perpendicular, true, result) < projectedLines.size())
+        {
+            // This can only fail because of rounding errors, in which case the result stays as it was
+            result = prevResult;
+        }
+
+        distance = Det(lines[i].direction, lines[i].point - result);
+    }
+}
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,242 @@
+#pragma once
+
+#include "WallEdgeTable.h"
+#include "WallGrid.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * Local avoidance steering for crowds, with optimal reciprocal collision avoidance (ORCA).
+ * Every agent gets the velocity closest to the one it prefers, among the velocities that don't collide
+ * with its nearest neighbours within a time horizon, assuming that they avoid it the same way,
+ * and that don't get into the walls nearby within a shorter time horizon.
+ * Each neighbour and each nearby wall edge allows only the velocities on one side of a line,
+ * so finding the velocity is a linear program in two dimensions, solved incrementally.
+ * Velocities are in pixels per frame, and time horizons in frames.
+ */
+class CrowdSolver
+{
+
+  public: /* types */
+
+    /// An agent taking part in the avoidance
+    struct Agent
+    {
+        /// Current position
+        sf::Vector2f position;
+        /// Velocity of the agent's last update, which its neighbours expect it to keep
+        sf::Vector2f velocity;
+        /// Velocity the agent would take if there was nothing to avoid
+        sf::Vector2f preferredVelocity;
+        /// Collision radius
+        float radius;
+        /// Maximal length of the agent's velocity
+        float maxSpeed;
+        /**
+         * Whether the agent's velocity is solved for.
+         * Agents that are not movable keep their velocity, so their neighbours avoid them fully on their own.
+         */
+        bool movable;
+    };
+
+  public:
+
+    /// Creates a solver with default parameters
+    CrowdSolver();
+
+    /**
+     * Sets the solver's parameters
+     * 
+     * @param[in] neighbourDistance
+     *  Only agents closer than this distance are avoided
+     * @param[in] maxNeighbours
+     *  Only up to this number of the nearest agents are avoided
+     * @param[in] timeHorizon
+     *  Velocities are collision-free with other agents for at least this number of frames
+     * @param[in] obstacleTimeHorizon
+     *  Velocities don't get into walls for at least this number of frames
+     */
+    void SetParameters(float neighbourDistance, int maxNeighbours, float timeHorizon, float obstacleTimeHorizon);
+
+    /**
+     * Scales the neighbour distance when the world is resized
+     * 
+     * @param[in] scale
+     *  Ratio of the world's new width to its old width
+     */
+    void Rescale(float scale);
+
+    /**
+     * Calculates the new velocities of all the movable agents
+     * 
+     * @param[in] agents
+     *  All the agents
+     * @param[in] wallGrid
+     *  Grid of the walls, for finding the walls near each agent
+     * @param[in] wallEdges
+     *  Table of the walls' edges, with the same wall indices as the grid
+     * @param[out] velocities
+     *  New velocity of each agent, by the agents' indices. Agents that are not movable keep their velocity.
+     *  Temporary memory of the solver is taken from the vector's memory resource.
+     */
+    void Solve(
+        std::pmr::vector<Agent> const& agents,
+        WallGrid const& wallGrid,
+        WallEdgeTable const& wallEdges,
+        std::pmr::vector<sf::Vector2f>& velocities) const;
+
+  private: /* types */
+
+    /// A line in the velocity space, allowing only the velocities to the left of its direction
+    struct Line
+    {
+        sf::Vector2f point;
+        sf::Vector2f direction;
+    };
+
+  private: /* functions */
+
+    /**
+     * Finds the nearest neighbours of an agent, using a grid of the agents
+     * 
+     * @param[in] agents
+     *  All the agents
+     * @param[in] agentInd
+     *  Index of the agent whose neighbours to find
+     * @param[in] cellBegin, cellAgents
+     *  Grid of the agents - beginning of each cell's range in the cells' agents, and the agents' indices, cell after cell
+     * @param[in] gridOrigin, cellSize, cellsCountX, cellsCountY
+     *  Position, cell size and number of columns and rows of the grid of the agents
+     * @param[out] neighbours
+     *  The neighbours, as pairs of squared distance and index, sorted by distance
+     */
+    void FindNeighbours(
+        std::pmr::vector<Agent> const& agents,
+        int agentInd,
+        std::pmr::vector<int> const& cellBegin,
+        std::pmr::vector<int> const& cellAgents,
+        sf::Vector2f const gridOrigin,
+        float cellSize,
+        int cellsCountX,
+        int cellsCountY,
+        std::pmr::vector<std::pair<float, int>>& neighbours) const;
+
+    /**
+     * Adds the lines keeping an agent out of the walls near it
+     * 
+     * @param[in] agent
+     *  The agent
+     * @param[in] wallGrid, wallEdges
+     *  The walls
+     * @param[in,out] wallInds
+     *  Vector for the indices of the walls near the agent, reused between agents
+     * @param[out] lines
+     *  Vector to which the lines are appended
+     */
+    void AddObstacleLines(
+        Agent const& agent,
+        WallGrid const& wallGrid,
+        WallEdgeTable const& wallEdges,
+        std::pmr::vector<int>& wallInds,
+        std::pmr::vector<Line>& lines) const;
+
+    /**
+     * Adds the line keeping an agent's velocity from colliding with a neighbour's
+     * 
+     * @param[in] agent, neighbour
+     *  The agent and its neighbour
+     * @param[out] lines
+     *  Vector to which the line is appended
+     */
+    void AddAgentLine(Agent const& agent, Agent const& neighbour, std::pmr::vector<Line>& lines) const;
+
+    /**
+     * Finds the best velocity on a single line, allowed by all the lines before it
+     * 
+     * @param[in] lines
+     *  The lines
+     * @param[in] lineInd
+     *  Index of the line to find the velocity on
+     * @param[in] radius
+     *  Maximal length of the velocity
+     * @param[in] optVelocity
+     *  Velocity to get the closest to, or direction to go the furthest in
+     * @param[in] directionOpt
+     *  true if the optimization velocity is a direction to go the furthest in
+     * @param[in,out] result
+     *  The found velocity, left unchanged if there is none
+     * 
+     * @return true if a velocity was found, false if the lines allow none on the line
+     */
+    static bool SolveOnLine(
+        std::pmr::vector<Line> const& lines,
+        int lineInd,
+        float radius,
+        sf::Vector2f const optVelocity,
+        bool directionOpt,
+        sf::Vector2f& result);
+
+    /**
+     * Finds the best velocity allowed by all the lines, adding the lines one by one
+     * 
+     * @param[in] lines
+     *  The lines
+     * @param[in] radius, optVelocity, directionOpt
+     *  As in SolveOnLine
+     * @param[out] result
+     *  The found velocity, or the best one allowed by the lines before the first failing one
+     * 
+     * @return number of lines, or index of the first line for which there is no allowed velocity
+     */
+    static int SolveLines(
+        std::pmr::vector<Line> const& lines,
+        float radius,
+        sf::Vector2f const optVelocity,
+        bool directionOpt,
+        sf::Vector2f& result);
+
+    /**
+     * Finds the velocity that violates the agents' lines the least, when there is none that is allowed by all of them.
+     * Lines of walls are kept as they are.
+     * 
+     * @param[in] lines
+     *  The lines, first the walls' ones and then the agents' ones
+     * @param[in] obstacleLinesCount
+     *  Number of the walls' lines
+     * @param[in] beginLine
+     *  Index of the line for which SolveLines failed
+     * @param[in] radius
+     *  Maximal length of the velocity
+     * @param[in,out] result
+     *  The velocity found by SolveLines, improved
+     */
+    static void SolveLeastViolating(
+        std::pmr::vector<Line> const& lines,
+        int obstacleLinesCount,
+        int beginLine,
+        float radius,
+        sf::Vector2f& result);
+
+  private: /* variables */
+
+    /// Only agents closer than this distance are avoided
+    float _neighbourDistance;
+
+    /// Only up to this number of the nearest agents are avoided
+    int _maxNeighbours;
+
+    /// Velocities are collision-free with other agents for at least this number of frames
+    float _timeHorizon;
+
+    /// Velocities don't get into walls for at least this number of frames
+    float _obstacleTimeHorizon;
+};
+
+} // namespace HideAndSeekAndShoot
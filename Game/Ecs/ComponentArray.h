@@ -0,0 +1,144 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/// An entity is only an index, which its components are stored by
+typedef int Entity;
+
+/**
+ * A dense array of components of a single type, each belonging to a different entity.
+ * The components are stored next to each other, so a system that updates all of them is a linear pass,
+ * and for each entity the index of its component is kept, so that the component of a given entity is found at once.
+ * A removed component is replaced with the last one, so the array stays dense,
+ * and it keeps its capacity, so after a while adding components doesn't allocate anymore.
+ * 
+ * The order of the components is the order in which they were added, except for those moved by removals,
+ * so systems that iterate the array always visit the entities in the same order.
+ */
+template <typename Component>
+class ComponentArray
+{
+
+  public:
+
+    /**
+     * Adds a component to an entity that doesn't have one yet
+     * 
+     * @param[in] entity
+     *  The entity
+     * @param[in] component
+     *  The component
+     * 
+     * @return the added component
+     */
+    Component& Add(Entity entity, Component component)
+    {
+        if (entity >= _inds.size())
+        {
+            _inds.resize(entity + 1, -1);
+        }
+        _inds[entity] = _components.size();
+        _entities.push_back(entity);
+        _components.push_back(std::move(component));
+        return _components.back();
+    }
+
+    /**
+     * Removes the component of an entity, moving the last component to its place
+     * 
+     * @param[in] entity
+     *  The entity, which has to have the component
+     */
+    void Remove(Entity entity)
+    {
+        int const ind = _inds[entity];
+        int const lastInd = _components.size() - 1;
+        if (ind != lastInd)
+        {
+            _components[ind] = std::move(_components[lastInd]);
+            _entities[ind] = _entities[lastInd];
+            _inds[_entities[ind]] = ind;
+        }
+        _components.pop_back();
+        _entities.pop_back();
+        _inds[entity] = -1;
+    }
+
+    /// Returns whether an entity has the component
+    bool Has(Entity entity) const
+    {
+        return entity < _inds.size() && _inds[entity] >= 0;
+    }
+
+    /// Returns the component of an entity, which has to have it
+    Component& Get(Entity entity)
+    {
+        return _components[_inds[entity]];
+    }
+    Component const& Get(Entity entity) const
+    {
+        return _components[_inds[entity]];
+    }
+
+    /// Returns the number of components
+    int GetSize() const
+    {
+        return _components.size();
+    }
+
+    /// Returns a component by its index in the array
+    Component& GetAt(int ind)
+    {
+        return _components[ind];
+    }
+    Component const& GetAt(int ind) const
+    {
+        return _components[ind];
+    }
+
+    /// Returns the entity of a component, by the component's index in the array
+    Entity GetEntityAt(int ind) const
+    {
+        return _entities[ind];
+    }
+
+    /**
+     * Reserves storage for a number of components,
+     * so that components which are expensive to move are not moved when the array grows
+     * 
+     * @param[in] count
+     *  Number of components
+     */
+    void Reserve(int count)
+    {
+        _components.reserve(count);
+        _entities.reserve(count);
+    }
+
+    /**
+     * Reserves storage for the components' indices of a number of entities,
+     * so that adding components to entities with higher indices than before doesn't allocate
+     * 
+     * @param[in] entitiesCount
+     *  Number of entities
+     */
+    void ReserveEntities(int entitiesCount)
+    {
+        _inds.reserve(entitiesCount);
+    }
+
+  private: /* variables */
+
+    /// The components, next to each other
+    std::vector<Component> _components;
+    /// For each component, its entity
+    std::vector<Entity> _entities;
+    /// For each entity, index of its component, or -1 if it has none
+    std::vector<int> _inds;
+};
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "Registry.h"
+#include "../Entities/FieldOfView.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <random>
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/// Position of an entity in the world, in pixels, and the rotation it is drawn with, in degrees
+struct Transform
+{
+    sf::Vector2f position;
+    float rotation;
+};
+
+/**
+ * Velocity of an entity, and the speed it can move with, in pixels per frame.
+ * A bullet flies with its velocity, and an enemy moved by crowd steering keeps the velocity of its last update.
+ */
+struct Velocity
+{
+    sf::Vector2f velocity;
+    float speed;
+};
+
+/**
+ * Circle with which a person collides with the walls and with other people, and how it moves when it runs into a wall.
+ * Essentially a person is a circle for the collision detection.
+ */
+struct Collider
+{
+    /// Radius of the circle, around the person's position
+    float radius;
+
+    /**
+     * Whether collisions with walls are checked coarsely, with the walls' bounding circles.
+     * It is much cheaper, but keeps the person further away from walls than needed.
+     */
+    bool coarse;
+
+    /**
+     * Step with which the person goes towards a wall it would run into with its speed, in pixels,
+     * so that it can get as close to the wall as this step, and isn't stopped a whole speed away from it
+     */
+    float movementPrecision;
+
+    /**
+     * Cosines and sines of the angles by which the person turns when going around obstacles, as x and y,
+     * shared by all the people of the same config
+     */
+    std::vector<sf::Vector2f> const* goAroundRotations;
+};
+
+/**
+ * Sprite of an entity, drawn centered at the entity's position and with its rotation.
+ * Only the texture and the scale are kept, and the sprite is made from them when it is drawn,
+ * so that entities stay small and the transform isn't kept twice.
+ */
+struct Sprite
+{
+    /// The texture, or nullptr for drawing nothing
+    sf::Texture const* texture;
+    /// Scale of the texture, giving the size from the entity's config
+    sf::Vector2f scale;
+};
+
+/// Point at which a person looks and aims, and towards which an enemy moves
+struct Aim
+{
+    sf::Vector2f targetPoint;
+};
+
+/// A person's gun, and the bullets it shoots
+struct Weapon
+{
+    /// The gun, an entity with its own transform and sprite, which is placed at the person's side
+    Entity gun;
+    /// Distance between the person and the gun, in pixels
+    float gunDistance;
+
+    /// Texture of the bullets
+    sf::Texture const* bulletTexture;
+    /// Scale of the bullets' texture
+    sf::Vector2f bulletScale;
+    /// Speed of the bullets, in pixels per frame
+    float bulletSpeed;
+};
+
+/**
+ * Trajectory of a bullet. The bullet's velocity is constant, so the trajectory is kept as a start position and tick,
+ * its position is evaluated from them in each update, and the tick at which it exits is calculated in advance.
+ */
+struct Trajectory
+{
+    /// Position from which the trajectory starts
+    sf::Vector2f startPosition;
+    /// Tick in whose update the bullet makes its first step from the start position
+    int startTick;
+    /// Tick in whose update the bullet hits a wall or leaves the world, after which it is removed
+    int exitTick;
+};
+
+/**
+ * Level of detail with which an enemy is simulated, depending on its distance to the player:
+ *  - Full: Updated every frame with exact collisions and a traced field of view
+ *  - Reduced: Updated once in a few frames with coarse collisions and without tracing its field of view
+ *  - Dormant: Like reduced, but updated even more rarely and not drawn at all
+ */
+enum class LodTier { Full, Reduced, Dormant };
+
+/// Modes of an enemy's AI
+enum class AiMode { Chase, Attack, Investigate, Wander, Count };
+
+/// State of an enemy's AI, its timers, and how it is simulated
+struct AiState
+{
+    /// Current mode of the AI
+    AiMode mode;
+
+    /// Position where the player was seen for the last time
+    sf::Vector2f lastSeenPosition;
+
+    /// Point to which the enemy is currently wandering
+    sf::Vector2f wanderPoint;
+    /// Whether a wander point is currently chosen
+    bool hasWanderPoint;
+
+    /// Number of frames until the next perception
+    int framesUntilPerception;
+
+    /// Number of frames until the enemy can shoot again
+    int framesUntilShot;
+    /// Whether the enemy wants to shoot in the current frame
+    bool shooting;
+
+    /// Velocity with which the enemy would like to move since its last update, in pixels per frame
+    sf::Vector2f preferredVelocity;
+
+    /// Number of frames between the enemy's last update and the one before it
+    int elapsedFrames;
+
+    /// Current level of detail
+    LodTier lodTier;
+    /// Number of the frame in which the enemy was last updated
+    int lastUpdateFrame;
+};
+
+/// Random generator of an enemy, for choosing wander points. It is big, so it is kept apart from the AI state.
+struct RandomGenerator
+{
+    std::mt19937 engine;
+};
+
+/// Registry of all the types of components in the world
+typedef Registry<
+    Transform,
+    Velocity,
+    Collider,
+    Sprite,
+    Aim,
+    Weapon,
+    Trajectory,
+    AiState,
+    RandomGenerator,
+    FieldOfView
+> EntityRegistry;
+
+} // namespace HideAndSeekAndShoot
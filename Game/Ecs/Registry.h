@@ -0,0 +1,118 @@
+#pragma once
+
+#include "ComponentArray.h"
+
+#include <tuple>
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * A registry of entities and their components, with a dense array for each type of component.
+ * An entity has no data of its own, it is what its components make it - a person is a transform, a velocity,
+ * a collider, a sprite and a weapon, and an enemy is a person with an AI state as well.
+ * 
+ * Indices of destroyed entities are given to the next created ones, the most recently freed first,
+ * so the arrays indexed by entities don't grow as long as entities are destroyed as fast as they are created.
+ * Nothing keeps an entity after it is destroyed, except for events scheduled for it,
+ * which check that the entity still has the component they were scheduled for.
+ */
+template <typename... Components>
+class Registry
+{
+
+  public:
+
+    /// Creates a registry without entities
+    Registry()
+        : _entitiesCount(0)
+    {}
+
+    /// Creates an entity without components
+    Entity Create()
+    {
+        if (!_freeEntities.empty())
+        {
+            Entity const entity = _freeEntities.back();
+            _freeEntities.pop_back();
+            return entity;
+        }
+        return _entitiesCount++;
+    }
+
+    /**
+     * Destroys an entity, removing all of its components
+     * 
+     * @param[in] entity
+     *  The entity
+     */
+    void Destroy(Entity entity)
+    {
+        (RemoveIfPresent<Components>(entity), ...);
+        _freeEntities.push_back(entity);
+    }
+
+    /**
+     * Reserves storage for a number of entities more than have been created so far,
+     * so that creating them and adding components to them doesn't allocate, once the arrays of the components have room
+     * 
+     * @param[in] count
+     *  Number of entities
+     */
+    void ReserveEntities(int count)
+    {
+        int const entitiesCount = _entitiesCount + count;
+        (GetComponents<Components>().ReserveEntities(entitiesCount), ...);
+        _freeEntities.reserve(entitiesCount);
+    }
+
+    /// Returns the array of the components of a type
+    template <typename Component>
+    ComponentArray<Component>& GetComponents()
+    {
+        return std::get<ComponentArray<Component>>(_componentArrays);
+    }
+    template <typename Component>
+    ComponentArray<Component> const& GetComponents() const
+    {
+        return std::get<ComponentArray<Component>>(_componentArrays);
+    }
+
+    /// Returns the component of a type of an entity, which has to have it
+    template <typename Component>
+    Component& GetComponent(Entity entity)
+    {
+        return GetComponents<Component>().Get(entity);
+    }
+    template <typename Component>
+    Component const& GetComponent(Entity entity) const
+    {
+        return GetComponents<Component>().Get(entity);
+    }
+
+  private: /* functions */
+
+    /// Removes the component of a type of an entity, if it has it
+    template <typename Component>
+    void RemoveIfPresent(Entity entity)
+    {
+        ComponentArray<Component>& components = GetComponents<Component>();
+        if (components.Has(entity))
+        {
+            components.Remove(entity);
+        }
+    }
+
+  private: /* variables */
+
+    /// Array of each type of component
+    std::tuple<ComponentArray<Components>...> _componentArrays;
+
+    /// Number of entities ever created, which is the index of the next new one
+    int _entitiesCount;
+    /// Indices of destroyed entities, to be given to created ones
+    std::vector<Entity> _freeEntities;
+};
+
+} // namespace HideAndSeekAndShoot
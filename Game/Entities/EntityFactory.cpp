@@ -0,0 +1,215 @@
+#include "EntityFactory.h"
+
+#include "../World.h"
+#include "../Game.h"
+#include "../Systems/AiSystem.h"
+#include "../Systems/RenderSystem.h"
+
+#include "../utils/configUtils.hpp"
+
+#include <cmath>
+
+namespace
+{
+
+auto constexpr PLAYER_CONFIG_FILENAME = "Game/config/player.conf";
+
+auto constexpr ENEMY_CONFIG_FILENAME = "Game/config/enemy.conf";
+
+auto constexpr GUN_CONFIG_FILENAME = "Game/config/gun.conf";
+
+auto constexpr BULLET_CONFIG_FILENAME = "Game/config/bullet.conf";
+
+float const SPEED_DEFAULT = 10.f;
+
+float const MOVEMENT_PRECISION_DEFAULT = 1.f;
+
+sf::Vector2f const INTIAL_POSITION_DEFAULT(0.2f, 0.7f);
+
+float const GO_AROUND_PRECISION_DEFAULT = 30.f;
+
+float const DIST_PERSON_REL_DEFAULT = 0.8f;
+
+float const BULLET_SPEED_REL_DEFAULT = 0.007f;
+
+} // namespace
+
+namespace HideAndSeekAndShoot
+{
+
+EntityFactory::EntityFactory(
+    World const* world,
+    EntityRegistry* registry,
+    AiSystem* aiSystem,
+    Resources::ResourceHandler<Resources::Texture::Id, sf::Texture> const* texHandler)
+    : _world(world),
+    _registry(registry),
+    _aiSystem(aiSystem),
+    _playerKind(LoadPersonKind(PLAYER_CONFIG_FILENAME, &texHandler->Get(Resources::Texture::Id::PlayerHead))),
+    _enemyKind(LoadPersonKind(ENEMY_CONFIG_FILENAME, &texHandler->Get(Resources::Texture::Id::EnemyHead))),
+    _gunConfig(ConfigUtils::ReadConfig(GUN_CONFIG_FILENAME)),
+    _gunTexture(&texHandler->Get(Resources::Texture::Id::Gun)),
+    _bulletConfig(ConfigUtils::ReadConfig(BULLET_CONFIG_FILENAME)),
+    _bulletTexture(&texHandler->Get(Resources::Texture::Id::Bullet))
+{}
+
+Config const& EntityFactory::GetEnemyConfig() const
+{
+    return _enemyKind.config;
+}
+
+Entity EntityFactory::CreatePlayer()
+{
+    return CreatePerson(_playerKind);
+}
+
+Entity EntityFactory::CreateEnemy(int index)
+{
+    Entity const enemy = CreatePerson(_enemyKind);
+    _aiSystem->AddAi(enemy, index);
+    return enemy;
+}
+
+void EntityFactory::DestroyPerson(Entity person)
+{
+    Entity const gun = _registry->GetComponent<Weapon>(person).gun;
+    _registry->Destroy(person);
+    _registry->Destroy(gun);
+}
+
+EntityFactory::PersonKind EntityFactory::LoadPersonKind(std::string const& configFilename, sf::Texture const* headTexture)
+{
+    PersonKind kind;
+    kind.config = ConfigUtils::ReadConfig(configFilename);
+    kind.headTexture = headTexture;
+
+    float goAroundPrecision = GO_AROUND_PRECISION_DEFAULT;
+    auto const goAroundPrecisionConfig = kind.config.find("go_around_precision");
+    if (goAroundPrecisionConfig != kind.config.end())
+    {
+        goAroundPrecision = std::stof(goAroundPrecisionConfig->second);
+    }
+
+    /* Cosines and sines are calculated in double precision and rounded,
+       which gives the same table with every math library */
+    for (int i = 1; i <= goAroundPrecision; i++)
+    {
+        double const angle = i * M_PI / goAroundPrecision;
+        kind.goAroundRotations.push_back(sf::Vector2f((float)std::cos(angle), (float)std::sin(angle)));
+    }
+
+    return kind;
+}
+
+Entity EntityFactory::CreatePerson(PersonKind const& kind)
+{
+    Config const& config = kind.config;
+
+    // Head size is specified in the config relative to the view's size
+    Sprite const head = { kind.headTexture, CalcSpriteScale(kind.headTexture, config, "head_size_x", "head_size_y") };
+    sf::FloatRect const headBounds = RenderSystem::MakeSprite(head, { sf::Vector2f(0.f, 0.f), 0.f }).getGlobalBounds();
+
+    // Collision radius is the radius from the center of the head to its corner, scaled with the scale from the config
+    float collisionRadius = std::sqrt(
+        headBounds.width * headBounds.width / 4 +
+        headBounds.height * headBounds.height / 4);
+    auto const collisionRadiusScaleConfig = config.find("collision_radius_scale");
+    if (collisionRadiusScaleConfig != config.end())
+    {
+        collisionRadius *= std::stof(collisionRadiusScaleConfig->second);
+    }
+
+    // Person speed is specified relative to the window's width, in pixels/second
+    float speed = SPEED_DEFAULT;
+    auto const speedConfig = config.find("speed");
+    if (speedConfig != config.end())
+    {
+        speed = std::stof(speedConfig->second) * _world->GetViewSize().x / (float)_world->GetGame()->GetFramerateLimit();
+    }
+
+    float movementPrecision = MOVEMENT_PRECISION_DEFAULT;
+    auto const movementPrecisionConfig = config.find("movement_precision");
+    if (movementPrecisionConfig != config.end())
+    {
+        movementPrecision = std::stof(movementPrecisionConfig->second);
+    }
+
+    sf::Vector2f relInitialPosition = INTIAL_POSITION_DEFAULT;
+    auto const initialPositionXConfig = config.find("initial_position_x");
+    auto const initialPositionYConfig = config.find("initial_position_y");
+    if (initialPositionXConfig != config.end() && initialPositionYConfig != config.end())
+    {
+        relInitialPosition = {
+            std::stof(initialPositionXConfig->second),
+            std::stof(initialPositionYConfig->second)
+        };
+    }
+    sf::Vector2f const initialPosition(
+        relInitialPosition.x * _world->GetSize().x,
+        relInitialPosition.y * _world->GetSize().y
+    );
+
+    // Distance of the gun from the person is specified relative to the person's head width
+    float distPersonRel = DIST_PERSON_REL_DEFAULT;
+    auto const distPersonConfig = _gunConfig.find("dist_person");
+    if (distPersonConfig != _gunConfig.end())
+    {
+        distPersonRel = std::stof(distPersonConfig->second);
+    }
+
+    // Bullet speed is specified relative to the view's width, in pixels/frame
+    float bulletSpeedRel = BULLET_SPEED_REL_DEFAULT;
+    auto const bulletSpeedConfig = _bulletConfig.find("speed");
+    if (bulletSpeedConfig != _bulletConfig.end())
+    {
+        bulletSpeedRel = std::stof(bulletSpeedConfig->second);
+    }
+
+    // The gun follows the person as soon as the person aims
+    Entity const gun = _registry->Create();
+    _registry->GetComponents<Transform>().Add(gun, { initialPosition, 0.f });
+    _registry->GetComponents<Sprite>().Add(gun, { _gunTexture, CalcSpriteScale(_gunTexture, _gunConfig) });
+
+    Entity const person = _registry->Create();
+    _registry->GetComponents<Transform>().Add(person, { initialPosition, 0.f });
+    _registry->GetComponents<Velocity>().Add(person, { sf::Vector2f(0.f, 0.f), speed });
+    _registry->GetComponents<Collider>().Add(person, { collisionRadius, false, movementPrecision, &kind.goAroundRotations });
+    _registry->GetComponents<Sprite>().Add(person, head);
+    _registry->GetComponents<Aim>().Add(person, { sf::Vector2f(0.f, 0.f) });
+    _registry->GetComponents<Weapon>().Add(person, {
+        gun,
+        distPersonRel * headBounds.width,
+        _bulletTexture,
+        CalcSpriteScale(_bulletTexture, _bulletConfig),
+        bulletSpeedRel * _world->GetViewSize().x
+    });
+
+    return person;
+}
+
+sf::Vector2f EntityFactory::CalcSpriteScale(
+    sf::Texture const* texture,
+    Config const& config,
+    std::string const& sizeXKey,
+    std::string const& sizeYKey) const
+{
+    auto const spriteSizeXConfig = config.find(sizeXKey);
+    auto const spriteSizeYConfig = config.find(sizeYKey);
+    if (texture == nullptr
+        || spriteSizeXConfig == config.end()
+        || spriteSizeYConfig == config.end())
+    {
+        return sf::Vector2f(1.f, 1.f);
+    }
+
+    // Calculate actual sizes by multiplying relative sizes with view's size
+    float const spriteSizeX = std::stof(spriteSizeXConfig->second) * _world->GetViewSize().x;
+    float const spriteSizeY = std::stof(spriteSizeYConfig->second) * _world->GetViewSize().y;
+
+    return sf::Vector2f(
+        spriteSizeX / (float)texture->getSize().x,
+        spriteSizeY / (float)texture->getSize().y
+    );
+}
+
+} // namespace HideAndSeekAndShoot
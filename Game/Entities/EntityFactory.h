@@ -0,0 +1,168 @@
+#pragma once
+
+#include "../Ecs/Components.h"
+
+#include "../resources/ResourceHandler.hpp"
+#include "../resources/ResourceIDs.hpp"
+
+#include <SFML/Graphics.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+typedef std::map<std::string, std::string> Config;
+
+namespace HideAndSeekAndShoot
+{
+
+class World;
+class AiSystem;
+
+/**
+ * Factory composing the world's people out of components.
+ * A person is an entity with a transform, a velocity, a collider, a sprite of its head, an aim and a weapon,
+ * and its gun is another entity, with a transform and a sprite. The player is just a person,
+ * and an enemy is a person that the AI system adds its AI to.
+ * 
+ * The configs of the people, the gun and the bullets are read once, when the factory is created,
+ * so creating many enemies doesn't read the same files again for each of them.
+ */
+class EntityFactory
+{
+
+  public:
+
+    /**
+     * Creates the factory, reading the configs of the people, the gun and the bullets
+     * 
+     * @param[in] world
+     *  Pointer to the world of the people, for its size and the size of its view
+     * @param[in] registry
+     *  Pointer to the registry in which the entities are created
+     * @param[in] aiSystem
+     *  Pointer to the system of the enemies' AI
+     * @param[in] texHandler
+     *  Pointer to textre handler with loaded textures
+     */
+    EntityFactory(
+      World const* world,
+      EntityRegistry* registry,
+      AiSystem* aiSystem,
+      Resources::ResourceHandler<Resources::Texture::Id, sf::Texture> const* texHandler
+    );
+
+    /// Returns the enemies' config, which configures their AI too
+    Config const& GetEnemyConfig() const;
+
+    /// Creates the player at its configured position, with its gun
+    Entity CreatePlayer();
+
+    /**
+     * Creates an enemy at its configured position, with its gun and its AI
+     * 
+     * @param[in] index
+     *  Index of the enemy in its world, which seeds its AI's random generator
+     * 
+     * @return the enemy
+     */
+    Entity CreateEnemy(int index);
+
+    /**
+     * Destroys a person together with its gun
+     * 
+     * @param[in] person
+     *  The person
+     */
+    void DestroyPerson(Entity person);
+
+  private: /* types */
+
+    /// Kind of a person - the player or an enemy - with what is read and precomputed for creating it
+    struct PersonKind
+    {
+        /// Config of the people of this kind
+        Config config;
+        /// Texture of their heads
+        sf::Texture const* headTexture;
+        /// Rotations of a person's velocity tried for going around walls, shared by the colliders of all of them
+        std::vector<sf::Vector2f> goAroundRotations;
+    };
+
+  private: /* functions */
+
+    /**
+     * Reads the config of a kind of person, and precomputes its rotations for going around walls
+     * 
+     * @param[in] configFilename
+     *  Name of the config file of the kind
+     * @param[in] headTexture
+     *  Texture of the heads of the people of the kind
+     * 
+     * @return the kind of person
+     */
+    static PersonKind LoadPersonKind(std::string const& configFilename, sf::Texture const* headTexture);
+
+    /**
+     * Creates a person of a kind, with its gun.
+     * Sizes, speeds and distances are relative to the view's size, so they are calculated when the person is created.
+     * 
+     * @param[in] kind
+     *  The kind of person
+     * 
+     * @return the person
+     */
+    Entity CreatePerson(PersonKind const& kind);
+
+    /**
+     * Calculates the scale of a sprite that fits it to the size from a config,
+     * which is written as a number between 0 and 1 relative to the view's size.
+     * If the config doesn't specify the size, the texture keeps its size.
+     * 
+     * @param[in] texture
+     *  Texture of the sprite
+     * @param[in] config
+     *  The config
+     * @param[in] sizeXKey, sizeYKey
+     *  Keys of the sprite's width and height in the config
+     * 
+     * @return the scale
+     */
+    sf::Vector2f CalcSpriteScale(
+      sf::Texture const* texture,
+      Config const& config,
+      std::string const& sizeXKey = "size_x",
+      std::string const& sizeYKey = "size_y"
+    ) const;
+
+  private: /* variables */
+
+    /// The world of the people
+    World const* _world;
+
+    /// Registry in which the entities are created
+    EntityRegistry* _registry;
+
+    /// System of the enemies' AI
+    AiSystem* _aiSystem;
+
+    /// The player's kind of person
+    PersonKind _playerKind;
+
+    /// The enemies' kind of person
+    PersonKind _enemyKind;
+
+    /// Config of the people's guns
+    Config _gunConfig;
+
+    /// Texture of the guns
+    sf::Texture const* _gunTexture;
+
+    /// Config of the bullets shot from the guns
+    Config _bulletConfig;
+
+    /// Texture of the bullets
+    sf::Texture const* _bulletTexture;
+};
+
+} // namespace HideAndSeekAndShoot
@@ -1,16 +1,32 @@
 #include "FieldOfView.h"
 
 #include "../World.h"
+#include "../RenderSnapshot.h"
 
 #include "../utils/geometryUtils.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace
 {
 
 float const ANGLE_DEFAULT = 2.f;
 
+float const COARSE_LINE_SPACING_DEFAULT = 0.16f;
+
 float const LINE_SPACING_DEFAULT = 0.02f;
 
+float const DIST_THRESHOLD_DEFAULT = 0.2f;
+
+float const COHERENCE_DIST_THRESHOLD_DEFAULT = 8.f;
+
+float const COHERENCE_ANGLE_THRESHOLD_DEFAULT = 0.05f;
+
+int const FULL_UPDATE_INTERVAL_DEFAULT = 15;
+
+sf::Color const FAN_COLOR(0, 0, 255, 70);
+
 /* Some upper limit of a line length.
     Needed for when we build lines from origin to "infinity" to check where they intersect with objects.
     This upper limit is the "infinity". It should be a line length that would never fit on the screen.
@@ -29,11 +45,19 @@ FieldOfView::FieldOfView(
     sf::Vector2f const targetDir)
     : _world(world),
     _origin(origin),
-    _targetDir(targetDir)
+    _targetDir(targetDir),
+    _fan(sf::TriangleFan, sf::VertexBuffer::Stream),
+    _fanUploaded(false)
 {
+    _coarseLineSpacing = COARSE_LINE_SPACING_DEFAULT;
     _lineSpacing = LINE_SPACING_DEFAULT;
+    _distThreshold = DIST_THRESHOLD_DEFAULT;
     _angle = ANGLE_DEFAULT;
 
+    _coherenceDistThreshold = COHERENCE_DIST_THRESHOLD_DEFAULT;
+    _coherenceAngleThreshold = COHERENCE_ANGLE_THRESHOLD_DEFAULT;
+    _fullUpdateInterval = FULL_UPDATE_INTERVAL_DEFAULT;
+
     InitLines();
     UpdateLines();
 }
@@ -43,6 +67,40 @@ void FieldOfView::Update()
     UpdateLines();
 }
 
+void FieldOfView::InvalidateCache()
+{
+    _framesSinceFullUpdate = _fullUpdateInterval;
+}
+
+void FieldOfView::AddToSnapshot(RenderSnapshot& snapshot) const
+{
+    snapshot.AddFan(_fanVertices.data(), _fanVertexCount);
+}
+
+sf::FloatRect FieldOfView::GetBounds() const
+{
+    return _fanBounds;
+}
+
+bool FieldOfView::Sees(sf::Vector2f const point) const
+{
+    sf::Vector2f const toPoint = GeometryUtils::GetVector(_origin, point);
+    if (toPoint == sf::Vector2f(0.f, 0.f))
+    {
+        return true;
+    }
+
+    // The point is within the field's angle if the angle to it from the target direction is at most half the field's angle
+    sf::Vector2f const pointDir = GeometryUtils::NormaliseVector(toPoint);
+    sf::Vector2f const targetDir = GeometryUtils::NormaliseVector(_targetDir);
+    if (pointDir.x * targetDir.x + pointDir.y * targetDir.y < cos(_angle / 2.f))
+    {
+        return false;
+    }
+
+    return _world->IsLineOfSightClear(_origin, point);
+}
+
 sf::Vector2f FieldOfView::GetOrigin() const
 {
     return _origin;
@@ -65,69 +123,251 @@ void FieldOfView::SetTargetDirection(sf::Vector2f const targetDir)
 
 void FieldOfView::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
-    target.draw(_lines, states);
+    if (sf::VertexBuffer::isAvailable())
+    {
+        if (!_fanUploaded)
+        {
+            _fan.update(_fanVertices.data(), _fanVertexCount, 0);
+            _fanUploaded = true;
+        }
+        target.draw(_fan, 0, _fanVertexCount, states);
+    }
+    else
+    {
+        target.draw(_fanVertices.data(), _fanVertexCount, sf::TriangleFan, states);
+    }
 }
 
 void FieldOfView::InitLines()
 {
-    int linesCount = _angle / _lineSpacing + 1;
-    _lines = sf::VertexArray(sf::Lines, linesCount * 2);
+    // Adjust the coarse spacing so that the coarse lines divide the angle evenly
+    int coarseIntervals = std::max(1, (int)std::ceil(_angle / _coarseLineSpacing));
+    _coarseLineSpacing = _angle / coarseIntervals;
 
-    for (int i = 0; i < _lines.getVertexCount(); i++)
+    // Find how many times the coarse spacing has to be bisected to get down to the fine spacing
+    _maxSubdivisionDepth = 0;
+    while (_coarseLineSpacing / (1 << _maxSubdivisionDepth) > _lineSpacing)
     {
-        _lines[i].color = sf::Color::Blue;
+        _maxSubdivisionDepth++;
+    }
+
+    int maxLinesCount = coarseIntervals * (1 << _maxSubdivisionDepth) + 1;
+    // The fan consists of the origin, followed by the end of each line
+    _fanVertices = std::vector<sf::Vertex>(maxLinesCount + 1, sf::Vertex(_origin, FAN_COLOR));
+    _fanVertexCount = 0;
+
+    _coarseHits = std::vector<LineHit>(coarseIntervals + 1);
+    _prevCoarseHits = std::vector<LineHit>(coarseIntervals + 1);
+    // Make sure the next update is a full one, since there is nothing in the cache
+    _framesSinceFullUpdate = _fullUpdateInterval;
+
+    if (sf::VertexBuffer::isAvailable() && !_fan.create(_fanVertices.size()))
+    {
+        throw std::runtime_error("Error: Cannot create vertex buffer for the field of view.");
     }
 }
 
 void FieldOfView::UpdateLines()
 {
-    // Set current vector to leftmost vector of the field
-    sf::Vector2f currVec = GeometryUtils::RotateVector(_targetDir, -_angle / 2.f);
-    // Make current vector to be of "infinite" length
-    currVec = GeometryUtils::NormaliseVector(currVec) * INFINITE_LINE_LENGTH;
-    for (int i = 0; i < _lines.getVertexCount() / 2; i++)
+    // The lines blocking the coarse lines in the last update can be reused only if the field has barely moved since
+    bool useCache = IsCoherentWithCache();
+    _framesSinceFullUpdate = useCache ? _framesSinceFullUpdate + 1 : 0;
+
+    // Cast the coarse lines, keeping the ones from the last update for the cache
+    std::swap(_coarseHits, _prevCoarseHits);
+    for (int i = 0; i < _coarseHits.size(); i++)
+    {
+        float angle = -_angle / 2.f + i * _coarseLineSpacing;
+        if (!useCache || !CastLineWithCachedEdge(i, angle, _coarseHits[i]))
+        {
+            _coarseHits[i] = CastLine(angle);
+        }
+    }
+    _cacheOrigin = _origin;
+    _cacheTargetDir = _targetDir;
+
+    _fanVertexCount = 0;
+    AppendFanVertex(_origin);
+
+    // Start from the leftmost line of the field, and subdivide between each two coarse lines where needed
+    AppendFanVertex(_coarseHits[0].end);
+    for (int i = 1; i < _coarseHits.size(); i++)
+    {
+        SubdivideLines(
+            _coarseHits[i - 1], -_angle / 2.f + (i - 1) * _coarseLineSpacing,
+            _coarseHits[i], -_angle / 2.f + i * _coarseLineSpacing,
+            _maxSubdivisionDepth
+        );
+        AppendFanVertex(_coarseHits[i].end);
+    }
+
+    sf::Vector2f boundsMin = _origin, boundsMax = _origin;
+    for (int i = 1; i < _fanVertexCount; i++)
+    {
+        sf::Vector2f const& pos = _fanVertices[i].position;
+        boundsMin = sf::Vector2f(std::min(boundsMin.x, pos.x), std::min(boundsMin.y, pos.y));
+        boundsMax = sf::Vector2f(std::max(boundsMax.x, pos.x), std::max(boundsMax.y, pos.y));
+    }
+    _fanBounds = sf::FloatRect(boundsMin, boundsMax - boundsMin);
+
+    _fanUploaded = false;
+}
+
+bool FieldOfView::IsCoherentWithCache() const
+{
+    if (_framesSinceFullUpdate + 1 >= _fullUpdateInterval)
     {
-        _lines[i * 2].position = _origin;
-        _lines[i * 2 + 1].position = FindIntersectionEndOfLine(_origin, _origin + currVec);
+        return false;
+    }
 
-        currVec = GeometryUtils::RotateVector(currVec, _lineSpacing);
+    if (GeometryUtils::CalcDist(_origin, _cacheOrigin) > _coherenceDistThreshold)
+    {
+        return false;
     }
+
+    sf::Vector2f const dir = GeometryUtils::NormaliseVector(_targetDir);
+    sf::Vector2f const cacheDir = GeometryUtils::NormaliseVector(_cacheTargetDir);
+    // Compare cosines, so that the angle between the directions doesn't have to be calculated
+    return dir.x * cacheDir.x + dir.y * cacheDir.y >= cos(_coherenceAngleThreshold);
 }
 
-sf::Vector2f FieldOfView::FindIntersectionEndOfLine(sf::Vector2f lineOrigin, sf::Vector2f lineInfiniteEnd) const
+bool FieldOfView::CastLineWithCachedEdge(int lineInd, float angle, LineHit& hit) const
 {
-    sf::Vector2f intersectionEnd = lineInfiniteEnd;
+    LineHit const& cachedHit = _prevCoarseHits[lineInd];
+    WallEdgeTable const& wallEdges = _world->GetWallEdges();
+    if (cachedHit.edgeInd < 0 || cachedHit.edgeInd >= wallEdges.GetEdgesCount())
+    {
+        return false;
+    }
 
-    // Traverse all walls in the world
-    for (sf::ConvexShape const& wall : _world->GetWalls())
+    /* Near a silhouette, another wall could have moved in front of the line.
+       So the cached edge is trusted only if the neighbouring lines were blocked by it too. */
+    for (int neighbourInd : { lineInd - 1, lineInd + 1 })
     {
-        // Traverse lines of the wall
-        int pointCount = wall.getPointCount();
-        for (int i = 0; i < pointCount; i++)
+        if (neighbourInd < 0 || neighbourInd >= _prevCoarseHits.size())
         {
-            // Get point A and B, where AB is the current line of the wall
-            sf::Vector2f A = wall.getPoint(i);
-            sf::Vector2f B = wall.getPoint(
-                (i + 1) % pointCount
-            );
+            continue;
+        }
+        if (_prevCoarseHits[neighbourInd].edgeInd != cachedHit.edgeInd)
+        {
+            return false;
+        }
+    }
 
-            if (!GeometryUtils::SegmentsIntersect(A, B, lineOrigin, lineInfiniteEnd))
-            {
-                continue;
-            }
-            sf::Vector2f currIntersection = GeometryUtils::FindSegmentsIntersection(
-                A, B, lineOrigin, lineInfiniteEnd
-            );
-            if ((currIntersection.x == lineOrigin.x
-                && fabs(currIntersection.y - lineOrigin.y) < fabs(intersectionEnd.y - lineOrigin.y))
-                || fabs(currIntersection.x - lineOrigin.x) < fabs(intersectionEnd.x - lineOrigin.x))
+    sf::Vector2f const lineVector = GetLineVector(angle);
+    float fraction;
+    if (!wallEdges.EdgeCrossesSegment(cachedHit.edgeInd, _origin, _origin + lineVector, fraction))
+    {
+        return false;
+    }
+
+    hit = {
+        _origin + lineVector * fraction,
+        GeometryUtils::GetVectorLength(lineVector) * fraction,
+        cachedHit.edgeInd
+    };
+    return true;
+}
+
+void FieldOfView::SubdivideLines(
+    LineHit const& leftHit, float leftAngle,
+    LineHit const& rightHit, float rightAngle,
+    int depth)
+{
+    if (depth <= 0 || !NeedsSubdivision(leftHit, rightHit))
+    {
+        return;
+    }
+
+    float midAngle = (leftAngle + rightAngle) / 2.f;
+    LineHit midHit = CastLine(midAngle);
+
+    SubdivideLines(leftHit, leftAngle, midHit, midAngle, depth - 1);
+    AppendFanVertex(midHit.end);
+    SubdivideLines(midHit, midAngle, rightHit, rightAngle, depth - 1);
+}
+
+bool FieldOfView::NeedsSubdivision(LineHit const& leftHit, LineHit const& rightHit) const
+{
+    if (leftHit.edgeInd != rightHit.edgeInd)
+    {
+        return true;
+    }
+
+    if (fabs(leftHit.dist - rightHit.dist) > _distThreshold * std::max(leftHit.dist, rightHit.dist))
+    {
+        return true;
+    }
+
+    // A thin wall can stand between the lines without being hit by either of them
+    return HasWallVertexBetween(leftHit, rightHit);
+}
+
+bool FieldOfView::HasWallVertexBetween(LineHit const& leftHit, LineHit const& rightHit) const
+{
+    sf::Vector2f const toLeft = leftHit.end - _origin, toRight = rightHit.end - _origin;
+    float const orientation = toLeft.x * toRight.y - toLeft.y * toRight.x;
+    if (orientation == 0.f)
+    {
+        return false;
+    }
+
+    // A point is in the triangle if it is on the same side of each of its sides as the triangle itself
+    auto const isInTriangle = [this, &leftHit, &rightHit, toLeft, toRight, orientation](sf::Vector2f const point) -> bool {
+        sf::Vector2f const toPoint = point - _origin;
+        sf::Vector2f const alongEnds = rightHit.end - leftHit.end, toPointFromLeft = point - leftHit.end;
+        return (toLeft.x * toPoint.y - toLeft.y * toPoint.x) * orientation > 0.f
+            && (toPoint.x * toRight.y - toPoint.y * toRight.x) * orientation > 0.f
+            && (alongEnds.x * toPointFromLeft.y - alongEnds.y * toPointFromLeft.x) * orientation > 0.f;
+    };
+
+    // Only the cells the thin triangle covers are searched, rather than its box, which is most of the world for a diagonal one
+    WallEdgeTable const& wallEdges = _world->GetWallEdges();
+    bool const noVertex = _world->GetWallGrid().VisitWallsInTriangle(_origin, leftHit.end, rightHit.end, [&wallEdges, &isInTriangle](int wallInd) -> bool {
+        // Each vertex of a wall is the start of one of its edges
+        for (int edgeInd = wallEdges.GetWallEdgesBegin(wallInd); edgeInd < wallEdges.GetWallEdgesEnd(wallInd); edgeInd++)
+        {
+            if (isInTriangle(wallEdges.GetEdgeStart(edgeInd)))
             {
-                intersectionEnd = currIntersection;
+                return false;
             }
         }
-    }
+        return true;
+    });
+    return !noVertex;
+}
+
+FieldOfView::LineHit FieldOfView::CastLine(float angle) const
+{
+    return FindIntersectionEndOfLine(_origin, _origin + GetLineVector(angle));
+}
+
+sf::Vector2f FieldOfView::GetLineVector(float angle) const
+{
+    // Rotate the target direction to get the line's direction, and make it of "infinite" length
+    return GeometryUtils::RotateVector(
+        GeometryUtils::NormaliseVector(_targetDir) * INFINITE_LINE_LENGTH,
+        angle
+    );
+}
+
+void FieldOfView::AppendFanVertex(sf::Vector2f const position)
+{
+    _fanVertices[_fanVertexCount].position = position;
+    _fanVertexCount++;
+}
+
+FieldOfView::LineHit FieldOfView::FindIntersectionEndOfLine(sf::Vector2f lineOrigin, sf::Vector2f lineInfiniteEnd) const
+{
+    float fraction;
+    int const edgeInd = _world->FindNearestWallCrossing(lineOrigin, lineInfiniteEnd, fraction);
 
-    return intersectionEnd;
+    sf::Vector2f const lineVector = lineInfiniteEnd - lineOrigin;
+    return {
+        lineOrigin + lineVector * fraction,
+        GeometryUtils::GetVectorLength(lineVector) * fraction,
+        edgeInd
+    };
 }
 
 } // namespace HideAndSeekAndShoot
\ No newline at end of file
@@ -8,11 +8,24 @@ namespace HideAndSeekAndShoot
 {
 
 class World;
+class RenderSnapshot;
 
 /**
  * A class representing the field of view of an entity looking at some direction.
- * The field of view can be visualised as many evenly-spaced lines going out of the entity
- * towards infinity, until blocked by an object or the map's border
+ * The field of view is found by casting many lines going out of the entity
+ * towards infinity, until blocked by an object or the map's border.
+ * It is visualised as a filled area - a triangle fan from the entity through the ends of those lines.
+ * 
+ * The lines are not evenly-spaced. A coarse fan of lines is cast first,
+ * and then the angle between two neighbouring lines is recursively bisected,
+ * but only if the two lines hit different edges, their lengths differ a lot, or a wall's vertex lies between them.
+ * Two neighbouring lines blocked by the same edge, with no wall's vertex between them,
+ * already give the exact shape of the field between them, because the edge is straight
+ * and a wall in front of it would have a vertex between the lines. So lines are cast densely only around corners.
+ * 
+ * Between consecutive updates the field usually moves only slightly,
+ * so the edges that blocked the coarse lines in the last update are tested first,
+ * and only lines for which that test fails are cast against all walls.
  */
 class FieldOfView : public sf::Drawable
 {
@@ -41,6 +54,34 @@ class FieldOfView : public sf::Drawable
     /// Updates the field of view according to current data
     void Update();
 
+    /**
+     * Makes the next update a full one, without reusing lines from the previous updates.
+     * Needed when the walls have moved.
+     */
+    void InvalidateCache();
+
+    /**
+     * Adds the field's triangle fan to a render snapshot
+     * 
+     * @param[out] snapshot
+     *  Snapshot to add the field to
+     */
+    void AddToSnapshot(RenderSnapshot& snapshot) const;
+
+    /// Returns the rectangle containing the triangle fan of the latest update
+    sf::FloatRect GetBounds() const;
+
+    /**
+     * Checks whether a point is seen in the field of view,
+     * meaning that it is within the field's angle and no wall blocks the line to it.
+     * 
+     * @param[in] point
+     *  The point to check
+     * 
+     * @return true if the point is seen, false otherwise
+     */
+    bool Sees(sf::Vector2f const point) const;
+
     /// Getter and setter for field of view's origin. The point from where the field is "viewed"
     sf::Vector2f GetOrigin() const;
     void SetOrigin(sf::Vector2f const origin);
@@ -49,29 +90,104 @@ class FieldOfView : public sf::Drawable
     sf::Vector2f GetTargetDirection() const;
     void SetTargetDirection(sf::Vector2f const targetDir);
 
+  private: /* types */
+
+    /// Result of casting a single line of the field of view
+    struct LineHit
+    {
+        /// The intersection end of the line
+        sf::Vector2f end;
+        /// Distance from the origin to the intersection end
+        float dist;
+        /// Index of the blocking edge in the world's wall edge table, or -1 if the line is not blocked
+        int edgeInd;
+    };
+
   private: /* functions */
 
     /**
      * Draws the field of view to a render target,
-     * which consists of drawing the lines representing the field of view.
+     * which consists of drawing the triangle fan representing the field of view.
      * 
      * @param[in] target
-     *  Render target where the field (lines) will be drawn
+     *  Render target where the field (triangle fan) will be drawn
      * @param[in] states
      *  Render states/mode for the drawing
      */
     void draw(sf::RenderTarget& target, sf::RenderStates states) const;
 
     /**
-     * Initializes the lines that visually represent the field of view, according to current angle and spacing
-     * (WARNING: does not initialize line's positions. Only their count in the vertex array.
-     *  To set their positions accordingly, use UpdateLines() method)
+     * Initializes the triangle fan that visually represents the field of view, according to current angle and spacings
+     * (WARNING: does not initialize the fan's positions. Only its maximum vertex count and the vertex buffer.
+     *  To set the positions accordingly, use UpdateLines() method)
      */
     void InitLines();
 
-    /// Updates the lines that visually represent the field of view, according to the current origin, target direction and angle
+    /**
+     * Updates the lines of the field of view, according to the current origin, target direction and angle,
+     * and streams the resulting triangle fan to the vertex buffer
+     */
     void UpdateLines();
 
+    /**
+     * Casts lines between two already cast lines, by recursively bisecting the angle between them,
+     * as long as they need subdivision. The ends of the new lines are appended to the fan in order.
+     * 
+     * @param[in] leftHit, leftAngle
+     *  The left line and its angle relative to the target direction
+     * @param[in] rightHit, rightAngle
+     *  The right line and its angle relative to the target direction
+     * @param[in] depth
+     *  How many more times the angle can be bisected
+     */
+    void SubdivideLines(
+        LineHit const& leftHit, float leftAngle,
+        LineHit const& rightHit, float rightAngle,
+        int depth
+    );
+
+    /// Checks whether more lines are needed between two neighbouring lines
+    bool NeedsSubdivision(LineHit const& leftHit, LineHit const& rightHit) const;
+
+    /**
+     * Checks whether a vertex of some wall lies in the triangle between the origin and the ends of two neighbouring lines.
+     * A wall too thin to be hit by either of the lines, but standing between them, always has such a vertex.
+     */
+    bool HasWallVertexBetween(LineHit const& leftHit, LineHit const& rightHit) const;
+
+    /// Checks whether the field has moved and turned little enough since the last update, so that the cache can be used
+    bool IsCoherentWithCache() const;
+
+    /**
+     * Casts a coarse line only against the edge that blocked it in the last update.
+     * 
+     * @param[in] lineInd
+     *  Index of the coarse line
+     * @param[in] angle
+     *  Angle of the line relative to the target direction, in radians
+     * @param[out] hit
+     *  Where and by what the line is blocked, if the cached edge is still blocking it
+     * 
+     * @return true if the cached edge is still blocking the line, false if the line has to be cast against all walls
+     */
+    bool CastLineWithCachedEdge(int lineInd, float angle, LineHit& hit) const;
+
+    /**
+     * Casts a line of the field of view
+     * 
+     * @param[in] angle
+     *  Angle of the line relative to the target direction, in radians
+     * 
+     * @return where and by what the line is blocked
+     */
+    LineHit CastLine(float angle) const;
+
+    /// Returns the vector from the origin to the "infinite" end of a line with the given angle relative to the target direction
+    sf::Vector2f GetLineVector(float angle) const;
+
+    /// Appends a vertex to the end of the triangle fan
+    void AppendFanVertex(sf::Vector2f const position);
+
     /**
      * Finds the intersection end of a line going from some origin point towards some infinite end point.
      * The intersection end of the line is the first point on the line (starting from the origin,
@@ -82,9 +198,9 @@ class FieldOfView : public sf::Drawable
      * @param[in] lineInfiniteEnd
      *  The infinite end point of the line
      * 
-     * @return the found intersection end of the line
+     * @return the found intersection end of the line, together with the edge that it lies on
      */
-    sf::Vector2f FindIntersectionEndOfLine(sf::Vector2f lineOrigin, sf::Vector2f lineInfiniteEnd) const;
+    LineHit FindIntersectionEndOfLine(sf::Vector2f lineOrigin, sf::Vector2f lineInfiniteEnd) const;
 
   private: /* variables */
 
@@ -100,11 +216,56 @@ class FieldOfView : public sf::Drawable
     /// Angle of the field of view, in radians
     float _angle;
 
-    /// Angle between two consecutive lines from the evenly-spaced lines representing the field of view
+    /// Angle between two consecutive lines of the coarse fan that is cast first
+    float _coarseLineSpacing;
+
+    /// Largest angle between two consecutive lines where subdivision is needed. Subdivision goes down to it, and not further
     float _lineSpacing;
 
-    /// The evenly-spaced lines visually representing the field of view
-    sf::VertexArray _lines;
+    /// How many times the angle between two coarse lines is bisected at most, which is the fewest that get down to the fine spacing
+    int _maxSubdivisionDepth;
+
+    /* Two neighbouring lines blocked by the same edge are subdivided anyway
+       if their lengths differ by more than this part of the longer one */
+    float _distThreshold;
+
+    /* Vertices of the triangle fan visually representing the field of view.
+       The first one is the origin, and the rest are the ends of the lines.
+       Allocated once in InitLines() for the maximum number of lines and updated in place each frame. */
+    std::vector<sf::Vertex> _fanVertices;
+
+    /// Number of vertices of the triangle fan used in the current frame
+    int _fanVertexCount;
+
+    /// Rectangle containing the triangle fan, found when the fan is updated
+    sf::FloatRect _fanBounds;
+
+    /// Results of casting the coarse lines in the current and in the last update
+    std::vector<LineHit> _coarseHits, _prevCoarseHits;
+
+    /// Origin and target direction of the field in the last update, when the cached coarse lines were cast
+    sf::Vector2f _cacheOrigin, _cacheTargetDir;
+
+    /// The cache is used only if the origin has moved less than this distance since the last update, in pixels
+    float _coherenceDistThreshold;
+
+    /// The cache is used only if the target direction has turned less than this angle since the last update, in radians
+    float _coherenceAngleThreshold;
+
+    /* Even if the field barely moves, all lines are cast against all walls once in that many updates,
+       so that walls missed by the cache cannot stay hidden for long */
+    int _fullUpdateInterval;
+
+    /// Number of updates since all coarse lines were cast against all walls
+    int _framesSinceFullUpdate;
+
+    /* Vertex buffer for the triangle fan, streamed from _fanVertices when it is drawn (if vertex buffers are available).
+       Uploading when drawing, instead of when updating, keeps the update free of graphics calls,
+       so that it can run on a thread other than the rendering one. */
+    mutable sf::VertexBuffer _fan;
+
+    /// Whether the vertex buffer has the fan of the latest update
+    mutable bool _fanUploaded;
 };
 
 } // namespace HideAndSeekAndShoot
\ No newline at end of file
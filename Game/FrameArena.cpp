@@ -0,0 +1,22 @@
+#include "FrameArena.h"
+
+namespace HideAndSeekAndShoot
+{
+
+FrameArena::FrameArena(std::size_t capacity)
+    : _buffer(capacity),
+    _resource(_buffer.data(), _buffer.size(), std::pmr::new_delete_resource())
+{}
+
+std::pmr::memory_resource* FrameArena::GetResource()
+{
+    return &_resource;
+}
+
+void FrameArena::Reset()
+{
+    // Releasing a monotonic buffer resource makes it start again from the beginning of the initial buffer
+    _resource.release();
+}
+
+} // namespace HideAndSeekAndShoot
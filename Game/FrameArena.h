@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * A linear (bump) allocator for memory that lives only during a single frame.
+ * Containers that are filled and thrown away in the same frame can use its memory resource
+ * (for example with std::pmr::vector), instead of allocating from the heap each frame.
+ * Allocating is just moving a pointer forward, and all of the memory is reclaimed at once with Reset(),
+ * which has to be called at the beginning of each frame.
+ * If a frame needs more memory than the arena's capacity, the extra memory is taken from the heap,
+ * so that nothing breaks, but then the capacity should be increased.
+ */
+class FrameArena
+{
+
+  public:
+
+    /**
+     * Creates an arena, allocating all of its memory up front.
+     * 
+     * @param[in] capacity
+     *  Number of bytes that can be allocated in a single frame without touching the heap
+     */
+    FrameArena(std::size_t capacity);
+
+    FrameArena(FrameArena const&) = delete;
+    FrameArena& operator=(FrameArena const&) = delete;
+
+    /// Returns the memory resource from which transient containers should allocate
+    std::pmr::memory_resource* GetResource();
+
+    /**
+     * Reclaims all memory allocated during the last frame.
+     * Everything allocated from the arena before this call must not be used after it.
+     */
+    void Reset();
+
+  private: /* variables */
+
+    /// The memory of the arena, allocated once
+    std::vector<std::byte> _buffer;
+
+    /// Memory resource bumping a pointer through the buffer
+    std::pmr::monotonic_buffer_resource _resource;
+};
+
+} // namespace HideAndSeekAndShoot
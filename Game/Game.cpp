@@ -1,7 +1,12 @@
 #include "Game.h"
+#include "Benchmark.h"
 
 #include "utils/configUtils.hpp"
 
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
 namespace
 {
 
@@ -10,6 +15,8 @@ int const WINDOW_WIDTH_DEFAULT = 1280;
 int const WINDOW_HEIGHT_DEFAULT = 720;
 int const FRAMERATE_LIMIT_DEFAULT = 60;
 
+std::size_t const FRAME_ARENA_CAPACITY = 1 << 20;
+
 auto constexpr BACKGROUND_TEXTURE_FILENAME = "Game/resources/textures/background.png";
 auto constexpr WALL_TEXTURE_FILENAME = "Game/resources/textures/wall.png";
 auto constexpr PLAYER_HEAD_TEXTURE_FILENAME = "Game/resources/textures/playerHead.png";
@@ -24,26 +31,55 @@ sf::Keyboard::Key const KEY_QUIT_GAME = sf::Keyboard::Escape;
 namespace HideAndSeekAndShoot
 {
 
-Game::Game()
+Game::Game(bool headless)
     : _config(ConfigUtils::ReadConfig(GAME_CONFIG_FILENAME)),
-    _controlState(_window)
+    _controlState(_window),
+    _frameArena(FRAME_ARENA_CAPACITY),
+    _allocationReport(_config),
+    _simulationRunning(false),
+    _sampledControlState(_window),
+    _hasSampledControls(false)
 {
-    ConfigWindow();
+    ConfigFramerateLimit();
+    if (!headless)
+    {
+        ConfigWindow();
+    }
+    ConfigPipeline();
+    ConfigStateHashLog();
     LoadResources();
 
+    // Benchmarks create their own worlds
+    if (headless)
+    {
+        return;
+    }
+
     _world = std::make_unique<World>(
         this,
         &_textureHandler,
+        &_frameArena,
         (sf::Vector2f)_window.getSize()
     );
 }
 
 void Game::Run()
 {
+    if (_pipelined)
+    {
+        RunPipelined();
+        return;
+    }
+
     /* The game loop.
        Updating and rendering until the player closes the game */
     while (_window.isOpen())
     {
+        // Memory allocated from the frame arena during the last frame is not needed anymore
+        _frameArena.Reset();
+        // Heap allocations are counted per frame
+        _allocationReport.EndFrame(_world->GetLineOfSightStats());
+
         sf::Event event;
         while (_window.pollEvent(event))
         {
@@ -54,6 +90,11 @@ void Game::Run()
             {
                 _window.close();
             }
+            // When the window is resized, the world is resized to fill it, instead of being stretched
+            else if (event.type == sf::Event::Resized)
+            {
+                OnResize(event.size.width, event.size.height);
+            }
         }
 
         // first clear previous frame
@@ -67,25 +108,194 @@ void Game::Run()
     }
 }
 
+bool Game::RunBenchmark(std::string const& baselineFilename, bool updateBaseline)
+{
+    Benchmark benchmark(this, &_textureHandler, &_frameArena, (sf::Vector2f)ConfigResolution());
+    return benchmark.Run(baselineFilename, updateBaseline, std::cout);
+}
+
 int Game::GetFramerateLimit() const
 {
     return _framerateLimit;
 }
 
 Game::~Game()
-{ /* nothing */ }
+{
+    StopSimulation();
+}
 
 void Game::Update()
 {
     _controlState.Update();
     _world->Update(_controlState);
+    LogStateHash();
 }
 
 void Game::Draw()
 {
+    AllocationTag tag("Draw");
+    _window.setView(_world->GetCameraView());
     _window.draw(*_world);
 }
 
+void Game::RunPipelined()
+{
+    // The first frame is drawn from a snapshot of the world as it was created
+    _world->TakeSnapshot(_snapshots.GetWriteBuffer());
+    _snapshots.Publish();
+
+    StartSimulation();
+
+    while (_window.isOpen())
+    {
+        _allocationReport.EndFrame(_world->GetLineOfSightStats());
+
+        sf::Event event;
+        while (_window.pollEvent(event))
+        {
+            if ((event.type == sf::Event::KeyPressed
+                && event.key.code == KEY_QUIT_GAME)
+                || event.type == sf::Event::Closed)
+            {
+                _window.close();
+            }
+            else if (event.type == sf::Event::Resized)
+            {
+                // The world cannot be resized while it is being updated
+                StopSimulation();
+                OnResize(event.size.width, event.size.height);
+                _world->TakeSnapshot(_snapshots.GetWriteBuffer());
+                _snapshots.Publish();
+                StartSimulation();
+            }
+        }
+
+        SampleControls();
+
+        // If the simulation hasn't published a new snapshot since the last frame, the last one is drawn again
+        _snapshots.Acquire();
+
+        _window.clear();
+        {
+            AllocationTag tag("Draw");
+            RenderSnapshot const& snapshot = _snapshots.GetReadBuffer();
+            _window.setView(snapshot.GetView());
+            // The static layer is drawn straight from the world, as its walls are guarded by a mutex when they are streamed
+            _world->DrawStaticLayer(_window, snapshot.GetView());
+            _window.draw(snapshot);
+        }
+        _window.display();
+    }
+
+    StopSimulation();
+}
+
+void Game::StartSimulation()
+{
+    _simulationRunning = true;
+    _simulationThread = std::thread(&Game::Simulate, this);
+}
+
+void Game::StopSimulation()
+{
+    if (!_simulationThread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_simulationMutex);
+        _simulationRunning = false;
+    }
+    _simulationSignal.notify_one();
+    _simulationThread.join();
+}
+
+void Game::Simulate()
+{
+    ControlState controlState(_window);
+    while (true)
+    {
+        /* Each sample of the controls is used for exactly one update,
+           so that the world is updated once per drawn frame and no shot is lost or repeated */
+        {
+            std::unique_lock<std::mutex> lock(_simulationMutex);
+            _simulationSignal.wait(lock, [this]() { return _hasSampledControls || !_simulationRunning; });
+            if (!_simulationRunning)
+            {
+                return;
+            }
+            controlState = _sampledControlState;
+            _hasSampledControls = false;
+        }
+
+        // Only this thread allocates from the frame arena in pipelined mode
+        _frameArena.Reset();
+
+        _world->Update(controlState);
+        LogStateHash();
+        _world->TakeSnapshot(_snapshots.GetWriteBuffer());
+        _snapshots.Publish();
+    }
+}
+
+void Game::SampleControls()
+{
+    {
+        std::lock_guard<std::mutex> lock(_simulationMutex);
+        /* If the simulation is still busy with the previous sample, the controls are sampled in the next frame,
+           so that the time between shots is counted in updates of the world, as in the sequential mode */
+        if (_hasSampledControls)
+        {
+            return;
+        }
+        // Controls are read from the window, which belongs to this thread
+        _controlState.Update();
+        _sampledControlState = _controlState;
+        _hasSampledControls = true;
+    }
+    _simulationSignal.notify_one();
+}
+
+void Game::OnResize(unsigned width, unsigned height)
+{
+    // The window's view is set to the world's camera whenever the world is drawn
+    sf::Vector2f const size((float)width, (float)height);
+    _world->Resize(size);
+}
+
+void Game::ConfigPipeline()
+{
+    auto const pipelinedConfig = _config.find("pipelined");
+    _pipelined = (pipelinedConfig != _config.end() && pipelinedConfig->second == "on");
+}
+
+void Game::ConfigStateHashLog()
+{
+    auto const stateHashLogConfig = _config.find("state_hash_log");
+    if (stateHashLogConfig == _config.end())
+    {
+        return;
+    }
+
+    _stateHashLog.open(stateHashLogConfig->second);
+    if (!_stateHashLog)
+    {
+        throw std::runtime_error("Error: Cannot open state hash log " + stateHashLogConfig->second + ".");
+    }
+}
+
+void Game::LogStateHash()
+{
+    if (!_stateHashLog.is_open())
+    {
+        return;
+    }
+
+    // One hash per line, so that the logs of two runs can be compared with any diff tool
+    _stateHashLog << std::hex << std::setw(16) << std::setfill('0') << _world->CalcStateHash() << '\n';
+}
+
 void Game::ConfigWindow()
 {
     auto const fullscreenConfig = _config.find("fullscreen");
@@ -104,55 +314,86 @@ void Game::ConfigWindow()
     }
     else
     {
-        int width = WINDOW_WIDTH_DEFAULT;
-        int height = WINDOW_HEIGHT_DEFAULT;
-        auto const resolutionConfig = _config.find("resolution");
-        if (resolutionConfig != _config.end())
-        {
-            std::string const resolution = resolutionConfig->second;
-
-            // The 'x' acting as the separator between width and height in a resolution (eg. 640x460)
-            size_t xIndex = resolution.find('x');
-            if (xIndex == std::string::npos)
-            {
-                throw std::runtime_error("Resolution specified in the game config file is not in the correct format.");
-            }
-            
-            // Separate width and height from the resolution
-            width = std::stoi(resolution.substr(0, xIndex));
-            height = std::stoi(resolution.substr(xIndex + 1));
-        }
-
         // Create window with the resolution
+        sf::Vector2u const resolution = ConfigResolution();
         _window.create(
-            sf::VideoMode(width, height),
+            sf::VideoMode(resolution.x, resolution.y),
             "Hide and Seek and Shoot",
             sf::Style::Default
         );
     }
 
+    _window.setFramerateLimit(_framerateLimit);
+
+    // Enable vertical sync for screens that get screen tearing
+    _window.setVerticalSyncEnabled(true);
+}
+
+sf::Vector2u Game::ConfigResolution() const
+{
+    int width = WINDOW_WIDTH_DEFAULT;
+    int height = WINDOW_HEIGHT_DEFAULT;
+    auto const resolutionConfig = _config.find("resolution");
+    if (resolutionConfig != _config.end())
+    {
+        std::string const resolution = resolutionConfig->second;
+
+        // The 'x' acting as the separator between width and height in a resolution (eg. 640x460)
+        size_t xIndex = resolution.find('x');
+        if (xIndex == std::string::npos)
+        {
+            throw std::runtime_error("Resolution specified in the game config file is not in the correct format.");
+        }
+        
+        // Separate width and height from the resolution
+        width = std::stoi(resolution.substr(0, xIndex));
+        height = std::stoi(resolution.substr(xIndex + 1));
+    }
+    return sf::Vector2u(width, height);
+}
+
+void Game::ConfigFramerateLimit()
+{
     // Get framerate limit from the config, if specified, otherwise use default
-    int framerateLimit = FRAMERATE_LIMIT_DEFAULT;
+    _framerateLimit = FRAMERATE_LIMIT_DEFAULT;
     auto const framerateLimitConfig = _config.find("framerate_limit");
     if (framerateLimitConfig != _config.end())
     {
-        framerateLimit = std::stoi(framerateLimitConfig->second);
+        _framerateLimit = std::stoi(framerateLimitConfig->second);
     }
-    _window.setFramerateLimit(framerateLimit);
-    _framerateLimit = framerateLimit;
-
-    // Enable vertical sync for screens that get screen tearing
-    _window.setVerticalSyncEnabled(true);
 }
 
 void Game::LoadResources()
 {
-    _textureHandler.Load(Resources::Texture::Id::Background, BACKGROUND_TEXTURE_FILENAME);
-    _textureHandler.Load(Resources::Texture::Id::Wall, WALL_TEXTURE_FILENAME);
-    _textureHandler.Load(Resources::Texture::Id::PlayerHead, PLAYER_HEAD_TEXTURE_FILENAME);
-    _textureHandler.Load(Resources::Texture::Id::EnemyHead, ENEMY_HEAD_TEXTURE_FILENAME);
-    _textureHandler.Load(Resources::Texture::Id::Gun, GUN_TEXTURE_FILENAME);
-    _textureHandler.Load(Resources::Texture::Id::Bullet, BULLET_TEXTURE_FILENAME);
+    // Textures are decoded in parallel, so loading takes as long as the slowest one
+    _textureHandler.LoadAsync(Resources::Texture::Id::Background, BACKGROUND_TEXTURE_FILENAME);
+    _textureHandler.LoadAsync(Resources::Texture::Id::Wall, WALL_TEXTURE_FILENAME);
+    _textureHandler.LoadAsync(Resources::Texture::Id::PlayerHead, PLAYER_HEAD_TEXTURE_FILENAME);
+    _textureHandler.LoadAsync(Resources::Texture::Id::EnemyHead, ENEMY_HEAD_TEXTURE_FILENAME);
+    _textureHandler.LoadAsync(Resources::Texture::Id::Gun, GUN_TEXTURE_FILENAME);
+    _textureHandler.LoadAsync(Resources::Texture::Id::Bullet, BULLET_TEXTURE_FILENAME);
+
+    /* The world scales its entities according to their textures' sizes,
+       so it cannot be created before all textures are uploaded.
+       Until then we keep the window responsive and show empty frames. */
+    while (!_textureHandler.UploadReady())
+    {
+        sf::Event event;
+        while (_window.pollEvent(event))
+        {
+            if (event.type == sf::Event::Closed)
+            {
+                _window.close();
+            }
+        }
+
+        // A headless game has no window to show them
+        if (_window.isOpen())
+        {
+            _window.clear();
+            _window.display();
+        }
+    }
 }
 
 } // namespace HideAndSeekAndShoot
\ No newline at end of file
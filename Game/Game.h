@@ -2,12 +2,20 @@
 
 #include "World.h"
 #include "ControlState.h"
+#include "FrameArena.h"
+#include "AllocationTracker.h"
+#include "RenderSnapshot.h"
+#include "TripleBuffer.hpp"
 #include "resources/ResourceHandler.hpp"
 #include "resources/ResourceIDs.hpp"
 
 #include <SFML/Graphics.hpp>
 
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
 #include <string>
+#include <thread>
 
 typedef std::map<std::string, std::string> Config;
 
@@ -24,14 +32,30 @@ class Game
 
     /**
      * Sets up a new game.
+     * 
+     * @param[in] headless (optional)
+     *  Whether to set up the game without a window and a world, only for running benchmarks.
+     *  Textures are still loaded, so a graphics driver is needed all the same.
      */
-    Game();
+    explicit Game(bool headless = false);
 
     /**
      * Runs the game.
      */
     void Run();
 
+    /**
+     * Runs the benchmark scenarios specified in the benchmark config, and compares their results with a baseline.
+     * 
+     * @param[in] baselineFilename
+     *  Name of the file with the baseline results
+     * @param[in] updateBaseline
+     *  Whether to save the results as the new baseline instead of comparing with it
+     * 
+     * @return true if no metric has regressed beyond its threshold, false otherwise
+     */
+    bool RunBenchmark(std::string const& baselineFilename, bool updateBaseline);
+
     /// Returns game's framerate limit
     int GetFramerateLimit() const;
 
@@ -48,10 +72,51 @@ class Game
     /// Draws the game to the window
     void Draw();
 
+    /**
+     * Runs the game loop in pipelined mode.
+     * The world is updated on a simulation thread, which publishes a render snapshot after each update,
+     * while this thread draws the latest published snapshot.
+     * This way updating the next frame overlaps with drawing the current one.
+     */
+    void RunPipelined();
+
+    /// Starts the simulation thread of the pipelined mode
+    void StartSimulation();
+
+    /// Stops the simulation thread of the pipelined mode and waits for it to finish its current update
+    void StopSimulation();
+
+    /**
+     * The loop of the simulation thread.
+     * Updates the world each time there are new controls, and publishes a snapshot of it.
+     */
+    void Simulate();
+
+    /// Samples the controls for the simulation thread, if it has taken the previous sample
+    void SampleControls();
+
+    /// Handles a window resize, resizing the world to fill the window
+    void OnResize(unsigned width, unsigned height);
+
+    /// Configures whether the game runs in pipelined mode, as specified in the config
+    void ConfigPipeline();
+
+    /// Opens the file to which the world's state hash is logged after each update, if one is specified in the config
+    void ConfigStateHashLog();
+
+    /// Logs the hash of the world's state after an update, if a state hash log is open
+    void LogStateHash();
+
     /// Configures and creates the window with resolution and framerate limit specified in the config.
     void ConfigWindow();
 
-    /// Loads all needed resources into the resource handlers
+    /// Returns the resolution of a window that isn't fullscreen, as specified in the config
+    sf::Vector2u ConfigResolution() const;
+
+    /// Configures the framerate limit, as specified in the config
+    void ConfigFramerateLimit();
+
+    /// Loads all needed resources into the resource handlers, decoding them in parallel in the background
     void LoadResources();
 
   private: /* variables */
@@ -73,6 +138,39 @@ class Game
 
     /// Handler for texture resources
     Resources::ResourceHandler<Resources::Texture::Id, sf::Texture> _textureHandler;
+
+    /// Arena for memory that lives only during a single frame, reset at the beginning of each frame
+    FrameArena _frameArena;
+
+    /// Rolling report of the heap allocations per frame
+    AllocationReport _allocationReport;
+
+    /// Whether the game runs in pipelined mode, updating and drawing on different threads
+    bool _pipelined;
+
+    /// Render snapshots passed from the simulation thread to the rendering one in pipelined mode
+    TripleBuffer<RenderSnapshot> _snapshots;
+
+    /// Thread on which the world is updated in pipelined mode
+    std::thread _simulationThread;
+
+    /// Whether the simulation thread should keep running
+    bool _simulationRunning;
+
+    /// Controls sampled by the rendering thread, that the simulation thread has not taken yet
+    ControlState _sampledControlState;
+
+    /// Whether there are sampled controls that the simulation thread has not taken yet
+    bool _hasSampledControls;
+
+    /// Mutex protecting the sampled controls and whether the simulation is running
+    std::mutex _simulationMutex;
+
+    /// Signaled when controls are sampled or when the simulation should stop
+    std::condition_variable _simulationSignal;
+
+    /// File to which the world's state hash is logged after each update, for comparing runs
+    std::ofstream _stateHashLog;
 };
 
 } // namespace HideAndSeekAndShoot
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include "LineOfSightCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+/* Any point of a cell is within half of the cell's diagonal from its center.
+   The distance is a little larger, so that rounding can't leave out a wall that a line between the cells touches. */
+float const CELL_RADIUS_TO_SIZE = 0.71f;
+
+} // namespace
+
+namespace HideAndSeekAndShoot
+{
+
+LineOfSightCache::LineOfSightCache()
+    : _cellsCountX(1),
+    _cellsCountY(1),
+    _cellSize(1.f),
+    _worldSize(0.f, 0.f),
+    _capacity(0),
+    _firstEntry(-1),
+    _lastEntry(-1),
+    _index(&_indexMemory),
+    _queries(0),
+    _hits(0),
+    _misses(0),
+    _rayCasts(0)
+{}
+
+void LineOfSightCache::Reset(sf::Vector2f const worldSize, float cellSize, int capacity)
+{
+    _worldSize = worldSize;
+    _cellSize = cellSize;
+    _cellsCountX = std::max((int)std::ceil(worldSize.x / cellSize), 1);
+    _cellsCountY = std::max((int)std::ceil(worldSize.y / cellSize), 1);
+    _capacity = std::max(capacity, 0);
+
+    _entries.clear();
+    _entries.reserve(_capacity);
+    _index.clear();
+    _index.reserve(_capacity);
+    _firstEntry = -1;
+    _lastEntry = -1;
+}
+
+bool LineOfSightCache::IsLineClear(
+    sf::Vector2f const pointA,
+    sf::Vector2f const pointB,
+    WallGrid const& wallGrid,
+    WallEdgeTable const& wallEdges)
+{
+    auto castLine = [&]() -> bool {
+        return wallGrid.VisitWallsAlongSegment(pointA, pointB, 0.f, [&](int wallInd) -> bool {
+            return !wallEdges.IsSegmentBlockedByWall(wallInd, pointA, pointB);
+        });
+    };
+
+    _queries.fetch_add(1, std::memory_order_relaxed);
+
+    // Points outside of the world are not in any cell
+    int const cellA = FindCell(pointA);
+    int const cellB = FindCell(pointB);
+    if (_capacity == 0 || cellA < 0 || cellB < 0)
+    {
+        _rayCasts.fetch_add(1, std::memory_order_relaxed);
+        return castLine();
+    }
+
+    // Lines of sight are symmetric, so the key of a pair doesn't depend on the order of its cells
+    std::uint64_t const key = ((std::uint64_t)std::min(cellA, cellB) << 32) | (std::uint64_t)std::max(cellA, cellB);
+    int entryInd;
+    auto const found = _index.find(key);
+    if (found != _index.end())
+    {
+        _hits.fetch_add(1, std::memory_order_relaxed);
+        entryInd = found->second;
+        Unlink(entryInd);
+        LinkFirst(entryInd);
+    }
+    else
+    {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        entryInd = AddEntry(cellA, cellB, wallGrid, wallEdges);
+    }
+
+    Entry const& entry = _entries[entryInd];
+    if (entry.wallsCount < 0)
+    {
+        _rayCasts.fetch_add(1, std::memory_order_relaxed);
+        return castLine();
+    }
+    for (int i = 0; i < entry.wallsCount; i++)
+    {
+        if (wallEdges.IsSegmentBlockedByWall(entry.wallInds[i], pointA, pointB))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+LineOfSightCache::Stats LineOfSightCache::GetStats() const
+{
+    return {
+        _queries.load(std::memory_order_relaxed),
+        _hits.load(std::memory_order_relaxed),
+        _misses.load(std::memory_order_relaxed),
+        _rayCasts.load(std::memory_order_relaxed)
+    };
+}
+
+int LineOfSightCache::FindCell(sf::Vector2f const point) const
+{
+    if (point.x < 0.f || point.y < 0.f || point.x > _worldSize.x || point.y > _worldSize.y)
+    {
+        return -1;
+    }
+    int const cellX = std::min((int)(point.x / _cellSize), _cellsCountX - 1);
+    int const cellY = std::min((int)(point.y / _cellSize), _cellsCountY - 1);
+    return cellY * _cellsCountX + cellX;
+}
+
+int LineOfSightCache::AddEntry(int cellA, int cellB, WallGrid const& wallGrid, WallEdgeTable const& wallEdges)
+{
+    int entryInd;
+    if (_entries.size() < _capacity)
+    {
+        entryInd = _entries.size();
+        _entries.emplace_back();
+    }
+    else
+    {
+        entryInd = _lastEntry;
+        Unlink(entryInd);
+        _index.erase(_entries[entryInd].key);
+    }
+
+    Entry& entry = _entries[entryInd];
+    entry.key = ((std::uint64_t)std::min(cellA, cellB) << 32) | (std::uint64_t)std::max(cellA, cellB);
+    entry.wallsCount = 0;
+
+    /* Every line between a point of one cell and a point of the other stays within the cells' radius
+       of the line between their centers, so only the walls that come that close to it can block such a line */
+    sf::Vector2f const centerA(
+        (cellA % _cellsCountX + 0.5f) * _cellSize,
+        (cellA / _cellsCountX + 0.5f) * _cellSize
+    );
+    sf::Vector2f const centerB(
+        (cellB % _cellsCountX + 0.5f) * _cellSize,
+        (cellB / _cellsCountX + 0.5f) * _cellSize
+    );
+    float const cellRadius = _cellSize * CELL_RADIUS_TO_SIZE;
+    wallGrid.VisitWallsAlongSegment(centerA, centerB, cellRadius, [&](int wallInd) -> bool {
+        // Walls spanning several cells of the grid are visited several times
+        if (std::find(entry.wallInds.begin(), entry.wallInds.begin() + entry.wallsCount, wallInd)
+                != entry.wallInds.begin() + entry.wallsCount
+            || !wallEdges.IsSegmentNearWall(wallInd, centerA, centerB, cellRadius))
+        {
+            return true;
+        }
+        if (entry.wallsCount == PAIR_WALLS_MAX)
+        {
+            entry.wallsCount = -1;
+            return false;
+        }
+        entry.wallInds[entry.wallsCount++] = wallInd;
+        return true;
+    });
+
+    _index.emplace(entry.key, entryInd);
+    LinkFirst(entryInd);
+    return entryInd;
+}
+
+void LineOfSightCache::Unlink(int entryInd)
+{
+    Entry& entry = _entries[entryInd];
+    (entry.prev >= 0 ? _entries[entry.prev].next : _firstEntry) = entry.next;
+    (entry.next >= 0 ? _entries[entry.next].prev : _lastEntry) = entry.prev;
+}
+
+void LineOfSightCache::LinkFirst(int entryInd)
+{
+    Entry& entry = _entries[entryInd];
+    entry.prev = -1;
+    entry.next = _firstEntry;
+    (_firstEntry >= 0 ? _entries[_firstEntry].prev : _lastEntry) = entryInd;
+    _firstEntry = entryInd;
+}
+
+} // namespace HideAndSeekAndShoot
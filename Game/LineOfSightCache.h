@@ -0,0 +1,150 @@
+#pragma once
+
+#include "LineOfSightStats.h"
+#include "WallEdgeTable.h"
+#include "WallGrid.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * A bounded cache of the walls that can block the lines of sight between two coarse cells of the world.
+ * The world is split into square cells, and for a pair of cells the cache keeps the few walls
+ * that come close enough to the line between the cells' centers to block some line between a point of one cell
+ * and a point of the other. Every line of sight between the two cells is checked exactly against just these walls,
+ * so most lines are found clear without looking at any wall, and the answers are the same as without the cache.
+ * Pairs near too many walls are marked as such, and their lines are cast through the wall grid instead.
+ * 
+ * Pairs are filled lazily on their first query, and the least recently used pair is evicted when the cache is full.
+ * Walls never move, so the cache has to be reset only when they are regenerated.
+ * The cache is used only by the thread updating the world, but its statistics can be read from any thread.
+ */
+class LineOfSightCache
+{
+
+  public: /* types */
+
+    /// Counts of the queries made since the cache was created, in their own header so that reports can use them alone
+    typedef LineOfSightStats Stats;
+
+  public:
+
+    /// Creates a cache with a single cell and no capacity, which casts every line
+    LineOfSightCache();
+
+    /**
+     * Empties the cache and sets up its cells.
+     * Has to be called whenever the walls change.
+     * 
+     * @param[in] worldSize
+     *  Size of the world, which the cells cover
+     * @param[in] cellSize
+     *  Side of a cell. Larger cells make more lines share a pair, but also get more walls near each pair.
+     * @param[in] capacity
+     *  Maximal number of pairs of cells in the cache, 0 for no caching at all
+     */
+    void Reset(sf::Vector2f const worldSize, float cellSize, int capacity);
+
+    /**
+     * Checks whether a line is not blocked by any of the walls
+     * 
+     * @param[in] pointA, pointB
+     *  End points of the line
+     * @param[in] wallGrid
+     *  Grid of the walls, for finding the walls near a pair of cells and for casting lines
+     * @param[in] wallEdges
+     *  Table of the walls' edges, with the same wall indices as the grid
+     * 
+     * @return true if no wall blocks the line, false otherwise
+     */
+    bool IsLineClear(
+        sf::Vector2f const pointA,
+        sf::Vector2f const pointB,
+        WallGrid const& wallGrid,
+        WallEdgeTable const& wallEdges);
+
+    /// Returns the counts of the queries made so far
+    Stats GetStats() const;
+
+  private: /* types */
+
+    /// Maximal number of walls kept for a pair of cells
+    static int const PAIR_WALLS_MAX = 6;
+
+    /// A cached pair of cells, linked with the other pairs in the order of their use
+    struct Entry
+    {
+        /// Key of the pair of cells
+        std::uint64_t key;
+        /// Previous (more recently used) and next (less recently used) entries, or -1 if there are none
+        int prev, next;
+        /// Number of walls near the pair, or -1 if there are more than PAIR_WALLS_MAX of them
+        int wallsCount;
+        /// Indices of the walls near the pair
+        std::array<int, PAIR_WALLS_MAX> wallInds;
+    };
+
+  private: /* functions */
+
+    /// Returns the index of the cell containing a point, or -1 if the point is outside of the world
+    int FindCell(sf::Vector2f const point) const;
+
+    /**
+     * Adds a pair of cells to the cache, evicting the least recently used pair if it is full
+     * 
+     * @param[in] cellA, cellB
+     *  Indices of the cells
+     * @param[in] wallGrid, wallEdges
+     *  The walls
+     * 
+     * @return index of the pair's entry
+     */
+    int AddEntry(int cellA, int cellB, WallGrid const& wallGrid, WallEdgeTable const& wallEdges);
+
+    /// Unlinks an entry from the order of use
+    void Unlink(int entryInd);
+
+    /// Links an entry as the most recently used one
+    void LinkFirst(int entryInd);
+
+  private: /* variables */
+
+    /// Number of columns and rows of cells
+    int _cellsCountX, _cellsCountY;
+
+    /// Side of a cell
+    float _cellSize;
+
+    /// Size of the world
+    sf::Vector2f _worldSize;
+
+    /// Maximal number of entries
+    int _capacity;
+
+    /// The entries, in no particular order
+    std::vector<Entry> _entries;
+
+    /// Most and least recently used entries, or -1 if there are none
+    int _firstEntry, _lastEntry;
+
+    /// Memory for the index of the entries, so that evicted entries' nodes are reused instead of allocating new ones
+    std::pmr::unsynchronized_pool_resource _indexMemory;
+
+    /// Index of the entries by the keys of their pairs of cells
+    std::pmr::unordered_map<std::uint64_t, int> _index;
+
+    /// Counts of the queries
+    std::atomic<std::size_t> _queries, _hits, _misses, _rayCasts;
+};
+
+} // namespace HideAndSeekAndShoot
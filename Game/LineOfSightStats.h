@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+namespace HideAndSeekAndShoot
+{
+
+/// Counts of the line of sight queries made since a line of sight cache was created
+struct LineOfSightStats
+{
+    /// All the queries
+    std::size_t queries;
+    /// Queries whose pair of cells was in the cache
+    std::size_t hits;
+    /// Queries whose pair of cells had to be added to the cache
+    std::size_t misses;
+    /// Queries answered by casting the line through the wall grid, instead of with the walls of a pair of cells
+    std::size_t rayCasts;
+};
+
+} // namespace HideAndSeekAndShoot
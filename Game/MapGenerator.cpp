@@ -0,0 +1,419 @@
+#include "MapGenerator.h"
+
+#include "utils/polygonUtils.hpp"
+#include "utils/randomUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace
+{
+
+// Thickness of maze walls, relative to the size of a maze cell
+float const MAZE_WALL_THICKNESS = 0.2f;
+
+// Number of lots along each side of a city block
+int const CITY_BLOCK_LOTS = 3;
+
+// Ratio of city lots that are left empty
+float const CITY_EMPTY_LOT_RATIO = 0.1f;
+
+// Maximal random shrinking of a building from each side, relative to the room it has in its lot
+float const CITY_BUILDING_JITTER = 0.15f;
+
+// Ratio of sparse map cells that get a wall, the others are left empty
+float const SPARSE_OCCUPANCY = 0.33f;
+
+// Minimal size of a wall in a sparse map, relative to the room it has in its cell
+float const SPARSE_MIN_WALL_SIZE = 0.3f;
+
+char const BINARY_MAGIC[4] = { 'H', 'S', 'S', 'M' };
+
+} // namespace
+
+namespace HideAndSeekAndShoot
+{
+
+MapGenerator::MapGenerator(Style style, unsigned seed, float passageWidth)
+    : _style(style),
+    _passageWidth(passageWidth),
+    _rng(seed)
+{}
+
+std::vector<std::vector<sf::Vector2f>> MapGenerator::Generate(int wallsCount)
+{
+    if (wallsCount <= 0)
+    {
+        return {};
+    }
+
+    switch (_style)
+    {
+    case Style::Maze:
+        return GenerateMaze(wallsCount);
+    case Style::City:
+        return GenerateCity(wallsCount);
+    default:
+        return GenerateSparse(wallsCount);
+    }
+}
+
+MapGenerator::Style MapGenerator::ParseStyle(std::string const& name)
+{
+    if (name == "maze")
+    {
+        return Style::Maze;
+    }
+    if (name == "city")
+    {
+        return Style::City;
+    }
+    if (name == "sparse")
+    {
+        return Style::Sparse;
+    }
+    throw std::runtime_error("Error: Unknown map style \"" + name + "\". Expected maze, city or sparse.");
+}
+
+void MapGenerator::SaveAsConfig(std::vector<std::vector<sf::Vector2f>> const& walls, std::string const& filename)
+{
+    std::ofstream file(filename);
+    if (!file)
+    {
+        throw std::runtime_error("Error: Cannot open file " + filename + " for writing.");
+    }
+
+    file << std::setprecision(9);
+    file << "walls_count=" << walls.size();
+    for (int wallInd = 0; wallInd < walls.size(); wallInd++)
+    {
+        std::string const prefix = "wall" + std::to_string(wallInd) + "_vert";
+        file << "\n" << prefix << "_count=" << walls[wallInd].size();
+        for (int verInd = 0; verInd < walls[wallInd].size(); verInd++)
+        {
+            file << "\n" << prefix << verInd << "_x=" << walls[wallInd][verInd].x;
+            file << "\n" << prefix << verInd << "_y=" << walls[wallInd][verInd].y;
+        }
+    }
+}
+
+void MapGenerator::SaveAsBinary(std::vector<std::vector<sf::Vector2f>> const& walls, std::string const& filename)
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Error: Cannot open file " + filename + " for writing.");
+    }
+
+    auto writeUint = [&file](std::uint32_t value) {
+        file.write(reinterpret_cast<char const*>(&value), sizeof(value));
+    };
+
+    file.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    writeUint(walls.size());
+    for (int wallInd = 0; wallInd < walls.size(); wallInd++)
+    {
+        writeUint(walls[wallInd].size());
+        for (int verInd = 0; verInd < walls[wallInd].size(); verInd++)
+        {
+            float const coords[2] = { walls[wallInd][verInd].x, walls[wallInd][verInd].y };
+            file.write(reinterpret_cast<char const*>(coords), sizeof(coords));
+        }
+    }
+}
+
+std::vector<std::vector<sf::Vector2f>> MapGenerator::LoadBinary(std::string const& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Error: Cannot open map file " + filename + ".");
+    }
+
+    auto readUint = [&file]() -> std::uint32_t {
+        std::uint32_t value = 0;
+        file.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    };
+
+    char magic[sizeof(BINARY_MAGIC)];
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0)
+    {
+        throw std::runtime_error("Error: File " + filename + " is not a binary map.");
+    }
+
+    // Counts are checked against the bytes left before anything is allocated for them, so a corrupt count cannot exhaust memory
+    std::streamoff const dataBegin = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::uint64_t bytesLeft = file.tellg() - dataBegin;
+    file.seekg(dataBegin);
+    auto readCount = [&readUint, &bytesLeft, &filename](std::uint64_t itemBytes) -> std::uint32_t {
+        if (bytesLeft < sizeof(std::uint32_t))
+        {
+            throw std::runtime_error("Error: Binary map " + filename + " is truncated.");
+        }
+        bytesLeft -= sizeof(std::uint32_t);
+        std::uint32_t const count = readUint();
+        if (count > bytesLeft / itemBytes)
+        {
+            throw std::runtime_error("Error: Binary map " + filename + " has more items than it has bytes for.");
+        }
+        bytesLeft -= count * itemBytes;
+        return count;
+    };
+
+    // Each wall takes at least its number of vertices, whose bytes are given back here and taken again as it is read
+    std::vector<std::vector<sf::Vector2f>> walls(readCount(sizeof(std::uint32_t)));
+    bytesLeft += walls.size() * sizeof(std::uint32_t);
+    for (int wallInd = 0; wallInd < walls.size() && file; wallInd++)
+    {
+        walls[wallInd].resize(readCount(2 * sizeof(float)));
+        for (int verInd = 0; verInd < walls[wallInd].size() && file; verInd++)
+        {
+            float coords[2];
+            file.read(reinterpret_cast<char*>(coords), sizeof(coords));
+            walls[wallInd][verInd] = { coords[0], coords[1] };
+        }
+    }
+    if (!file)
+    {
+        throw std::runtime_error("Error: Binary map " + filename + " is truncated.");
+    }
+
+    return walls;
+}
+
+void MapGenerator::SplitIntoConvexWalls(
+    std::vector<std::vector<sf::Vector2f>> const& polygons,
+    std::vector<std::vector<sf::Vector2f>>& walls,
+    std::vector<int>& wallPolygonInds)
+{
+    walls.clear();
+    wallPolygonInds.clear();
+    for (int polygonInd = 0; polygonInd < polygons.size(); polygonInd++)
+    {
+        if (polygons[polygonInd].size() < 3)
+        {
+            throw std::runtime_error("Error: Wall " + std::to_string(polygonInd) + " has less than 3 vertices.");
+        }
+
+        std::vector<std::vector<sf::Vector2f>> const parts = PolygonUtils::DecomposeIntoConvex(polygons[polygonInd]);
+        for (int partInd = 0; partInd < parts.size(); partInd++)
+        {
+            walls.push_back(parts[partInd]);
+            wallPolygonInds.push_back(polygonInd);
+        }
+    }
+}
+
+std::vector<std::vector<sf::Vector2f>> MapGenerator::GenerateMaze(int wallsCount)
+{
+    // A maze of n x n cells has roughly n * n walls left after carving, before merging them
+    int const n = std::max(2, (int)std::ceil(std::sqrt((float)wallsCount)));
+    float const cellSize = 1.f / n;
+    float const thickness = cellSize * MAZE_WALL_THICKNESS;
+    if (cellSize - thickness < _passageWidth)
+    {
+        ThrowDoesNotFit(wallsCount);
+    }
+
+    /* Carving passages with a randomized depth-first search, so every cell can be reached.
+       openRight[r][c] is whether cells (r, c) and (r, c + 1) are connected,
+       and openDown[r][c] is whether cells (r, c) and (r + 1, c) are connected. */
+    std::vector<std::vector<bool>> openRight(n, std::vector<bool>(n, false));
+    std::vector<std::vector<bool>> openDown(n, std::vector<bool>(n, false));
+    std::vector<std::vector<bool>> visited(n, std::vector<bool>(n, false));
+    std::vector<sf::Vector2i> stack = { { 0, 0 } };
+    visited[0][0] = true;
+    while (!stack.empty())
+    {
+        sf::Vector2i const cell = stack.back();
+        sf::Vector2i neighbours[4];
+        int neighboursCount = 0;
+        for (sf::Vector2i const step : { sf::Vector2i(0, 1), sf::Vector2i(0, -1), sf::Vector2i(1, 0), sf::Vector2i(-1, 0) })
+        {
+            sf::Vector2i const next = cell + step;
+            if (next.x >= 0 && next.x < n && next.y >= 0 && next.y < n && !visited[next.y][next.x])
+            {
+                neighbours[neighboursCount++] = next;
+            }
+        }
+
+        if (neighboursCount == 0)
+        {
+            stack.pop_back();
+            continue;
+        }
+
+        sf::Vector2i const next = neighbours[RandomUtils::UniformInt(_rng, 0, neighboursCount - 1)];
+        if (next.y == cell.y)
+        {
+            openRight[cell.y][std::min(cell.x, next.x)] = true;
+        }
+        else
+        {
+            openDown[std::min(cell.y, next.y)][cell.x] = true;
+        }
+        visited[next.y][next.x] = true;
+        stack.push_back(next);
+    }
+
+    std::vector<std::vector<sf::Vector2f>> walls;
+
+    /* Vertical walls are merged along their line, and cover the junctions they pass through,
+       so that horizontal walls only touch them and never overlap them */
+    auto hasVerticalWall = [&openRight, n](int row, int line) -> bool {
+        return row >= 0 && row < n && line >= 0 && line < n - 1 && !openRight[row][line];
+    };
+    for (int line = 0; line < n - 1; line++)
+    {
+        float const x = (line + 1) * cellSize;
+        for (int row = 0; row < n; row++)
+        {
+            if (!hasVerticalWall(row, line))
+            {
+                continue;
+            }
+            int lastRow = row;
+            while (hasVerticalWall(lastRow + 1, line))
+            {
+                lastRow++;
+            }
+            walls.push_back(MakeRectWall(
+                x - thickness / 2.f,
+                std::max(0.f, row * cellSize - thickness / 2.f),
+                x + thickness / 2.f,
+                std::min(1.f, (lastRow + 1) * cellSize + thickness / 2.f)
+            ));
+            row = lastRow;
+        }
+    }
+
+    // Horizontal walls are merged across junctions without a vertical wall, and stop at the ones with a vertical wall
+    auto hasHorizontalWall = [&openDown, n](int line, int column) -> bool {
+        return column >= 0 && column < n && !openDown[line][column];
+    };
+    auto junctionHasVerticalWall = [&hasVerticalWall](int line, int column) -> bool {
+        return hasVerticalWall(line, column - 1) || hasVerticalWall(line + 1, column - 1);
+    };
+    for (int line = 0; line < n - 1; line++)
+    {
+        float const y = (line + 1) * cellSize;
+        for (int column = 0; column < n; column++)
+        {
+            if (!hasHorizontalWall(line, column))
+            {
+                continue;
+            }
+            int lastColumn = column;
+            while (hasHorizontalWall(line, lastColumn + 1) && !junctionHasVerticalWall(line, lastColumn + 1))
+            {
+                lastColumn++;
+            }
+            walls.push_back(MakeRectWall(
+                column * cellSize + (junctionHasVerticalWall(line, column) ? thickness / 2.f : 0.f),
+                y - thickness / 2.f,
+                (lastColumn + 1) * cellSize - (junctionHasVerticalWall(line, lastColumn + 1) ? thickness / 2.f : 0.f),
+                y + thickness / 2.f
+            ));
+            column = lastColumn;
+        }
+    }
+
+    return walls;
+}
+
+std::vector<std::vector<sf::Vector2f>> MapGenerator::GenerateCity(int wallsCount)
+{
+    int const n = std::max(1, (int)std::ceil(std::sqrt(wallsCount / (1.f - CITY_EMPTY_LOT_RATIO))));
+    float const lotSize = 1.f / n;
+    // Alleys between lots in a block are one passage wide, and streets between blocks are two
+    float const room = lotSize - 2.f * _passageWidth;
+    if (room <= 0.f)
+    {
+        ThrowDoesNotFit(wallsCount);
+    }
+
+    float const maxJitter = room * CITY_BUILDING_JITTER;
+    auto sideInset = [this, n](int lotInd, bool lowSide) -> float {
+        int const neighbourInd = lowSide ? lotInd - 1 : lotInd + 1;
+        if (neighbourInd < 0 || neighbourInd >= n)
+        {
+            return _passageWidth / 2.f;
+        }
+        bool const sameBlock = (lotInd / CITY_BLOCK_LOTS) == (neighbourInd / CITY_BLOCK_LOTS);
+        return sameBlock ? _passageWidth / 2.f : _passageWidth;
+    };
+
+    std::vector<std::vector<sf::Vector2f>> walls;
+    for (int row = 0; row < n; row++)
+    {
+        for (int column = 0; column < n; column++)
+        {
+            if (RandomUtils::UniformFloat(_rng, 0.f, 1.f) < CITY_EMPTY_LOT_RATIO)
+            {
+                continue;
+            }
+            // Random values are drawn one statement at a time, since the order of evaluating arguments is unspecified
+            float const left = column * lotSize + sideInset(column, true) + RandomUtils::UniformFloat(_rng, 0.f, maxJitter);
+            float const top = row * lotSize + sideInset(row, true) + RandomUtils::UniformFloat(_rng, 0.f, maxJitter);
+            float const right = (column + 1) * lotSize - sideInset(column, false) - RandomUtils::UniformFloat(_rng, 0.f, maxJitter);
+            float const bottom = (row + 1) * lotSize - sideInset(row, false) - RandomUtils::UniformFloat(_rng, 0.f, maxJitter);
+            walls.push_back(MakeRectWall(left, top, right, bottom));
+        }
+    }
+
+    return walls;
+}
+
+std::vector<std::vector<sf::Vector2f>> MapGenerator::GenerateSparse(int wallsCount)
+{
+    // Walls are put in randomly chosen cells of a grid, each one inside its cell, half a passage away from the cell's sides
+    int const n = std::max(1, (int)std::ceil(std::sqrt(wallsCount / SPARSE_OCCUPANCY)));
+    float const cellSize = 1.f / n;
+    float const room = cellSize - _passageWidth;
+    if (room <= 0.f)
+    {
+        ThrowDoesNotFit(wallsCount);
+    }
+
+    std::vector<int> cells(n * n);
+    for (int i = 0; i < cells.size(); i++)
+    {
+        cells[i] = i;
+    }
+    RandomUtils::Shuffle(cells, _rng);
+
+    std::vector<std::vector<sf::Vector2f>> walls;
+    for (int i = 0; i < wallsCount; i++)
+    {
+        float const width = RandomUtils::UniformFloat(_rng, SPARSE_MIN_WALL_SIZE * room, room);
+        float const height = RandomUtils::UniformFloat(_rng, SPARSE_MIN_WALL_SIZE * room, room);
+        float const left = (cells[i] % n) * cellSize + _passageWidth / 2.f + RandomUtils::UniformFloat(_rng, 0.f, room - width);
+        float const top = (cells[i] / n) * cellSize + _passageWidth / 2.f + RandomUtils::UniformFloat(_rng, 0.f, room - height);
+        walls.push_back(MakeRectWall(left, top, left + width, top + height));
+    }
+
+    return walls;
+}
+
+std::vector<sf::Vector2f> MapGenerator::MakeRectWall(float left, float top, float right, float bottom)
+{
+    return { { left, top }, { right, top }, { right, bottom }, { left, bottom } };
+}
+
+void MapGenerator::ThrowDoesNotFit(int wallsCount) const
+{
+    throw std::runtime_error(
+        "Error: " + std::to_string(wallsCount) + " walls don't fit in the map with passage width "
+        + std::to_string(_passageWidth) + ". Use fewer walls or a narrower passage."
+    );
+}
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * A seeded procedural generator of maps - walls in coordinates relative to the world's size.
+ * Generated walls are rectangles that don't overlap each other,
+ * and there is at least a given passage width between any two of them that don't touch,
+ * so that people can pass everywhere between walls.
+ * The same style, number of walls, seed and passage width always give the same map.
+ * 
+ * There are a few preset styles:
+ *  - Maze: A maze on a square grid, where every cell can be reached from every other
+ *  - City: Blocks of buildings separated by alleys, with wider streets between blocks and some empty lots
+ *  - Sparse: Rectangles of random sizes, scattered randomly over the map
+ */
+class MapGenerator
+{
+
+  public: /* types */
+
+    /// Preset styles of generated maps
+    enum class Style { Maze, City, Sparse };
+
+  public: /* constants */
+
+    /**
+     * Passage width used when none is specified, relative to the world's height - wide enough for people of the default size
+     * in a world of the view's size. The world divides it by its scale, as people's size is relative to the view.
+     */
+    static constexpr float PASSAGE_WIDTH_DEFAULT = 0.1f;
+
+  public:
+
+    /**
+     * Creates a generator
+     * 
+     * @param[in] style
+     *  Style of the generated maps
+     * @param[in] seed
+     *  Seed for the random generator
+     * @param[in] passageWidth
+     *  Minimal distance between any two walls, relative to the world's height, which is the smaller side of the world
+     */
+    MapGenerator(Style style, unsigned seed, float passageWidth);
+
+    /**
+     * Generates a map.
+     * Throws an exception if that many walls don't fit with the passage width.
+     * 
+     * @param[in] wallsCount
+     *  Approximate number of walls to generate. The exact number depends on the style.
+     * 
+     * @return walls, each as a vector of its vertices' coordinates relative to the world's size
+     */
+    std::vector<std::vector<sf::Vector2f>> Generate(int wallsCount);
+
+    /**
+     * Parses a style from its name - "maze", "city" or "sparse".
+     * Throws an exception for an unknown name.
+     */
+    static Style ParseStyle(std::string const& name);
+
+    /**
+     * Saves walls to a file in the format of the walls config file
+     * 
+     * @param[in] walls
+     *  Walls in relative coordinates
+     * @param[in] filename
+     *  Name of the file to write
+     */
+    static void SaveAsConfig(std::vector<std::vector<sf::Vector2f>> const& walls, std::string const& filename);
+
+    /**
+     * Saves walls to a file in a binary format, much faster to load than the config format for big maps.
+     * The format is the magic "HSSM", then the number of walls, and then for each wall
+     * the number of its vertices followed by their coordinates, all as 32-bit values.
+     * 
+     * @param[in] walls
+     *  Walls in relative coordinates
+     * @param[in] filename
+     *  Name of the file to write
+     */
+    static void SaveAsBinary(std::vector<std::vector<sf::Vector2f>> const& walls, std::string const& filename);
+
+    /**
+     * Loads walls from a file in the binary format written by SaveAsBinary.
+     * Throws an exception if the file cannot be read, is not in that format, or has counts that don't fit its size.
+     * 
+     * @param[in] filename
+     *  Name of the file to read
+     * 
+     * @return walls in relative coordinates
+     */
+    static std::vector<std::vector<sf::Vector2f>> LoadBinary(std::string const& filename);
+
+    /**
+     * Splits walls that can be any simple polygons into convex walls, the way the world uses them.
+     * Throws an exception for a polygon with less than 3 vertices.
+     * 
+     * @param[in] polygons
+     *  Walls as polygons
+     * @param[out] walls
+     *  The convex walls, the parts of each polygon next to each other
+     * @param[out] wallPolygonInds
+     *  For each convex wall, index of the polygon that it is a part of
+     */
+    static void SplitIntoConvexWalls(
+        std::vector<std::vector<sf::Vector2f>> const& polygons,
+        std::vector<std::vector<sf::Vector2f>>& walls,
+        std::vector<int>& wallPolygonInds);
+
+  private: /* functions */
+
+    /// Generates a maze with approximately that many walls
+    std::vector<std::vector<sf::Vector2f>> GenerateMaze(int wallsCount);
+
+    /// Generates a city with approximately that many walls
+    std::vector<std::vector<sf::Vector2f>> GenerateCity(int wallsCount);
+
+    /// Generates a sparse map with exactly that many walls
+    std::vector<std::vector<sf::Vector2f>> GenerateSparse(int wallsCount);
+
+    /**
+     * Creates an axis-aligned rectangular wall
+     * 
+     * @param[in] left, top, right, bottom
+     *  Sides of the rectangle, in relative coordinates
+     * 
+     * @return vertices of the wall
+     */
+    static std::vector<sf::Vector2f> MakeRectWall(float left, float top, float right, float bottom);
+
+    /// Throws an exception saying that the walls don't fit with the passage width
+    void ThrowDoesNotFit(int wallsCount) const;
+
+  private: /* variables */
+
+    /// Style of the generated maps
+    Style _style;
+
+    /// Minimal distance between two walls, relative to the world's height
+    float _passageWidth;
+
+    /// Random generator
+    std::mt19937 _rng;
+};
+
+} // namespace HideAndSeekAndShoot
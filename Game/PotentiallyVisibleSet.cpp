@@ -0,0 +1,354 @@
+#include "PotentiallyVisibleSet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+
+char const BINARY_MAGIC[4] = { 'H', 'S', 'S', 'P' };
+
+/* Margin of the relative coordinates within which a point counts as being on a line,
+   so that rounding in the world's pixel coordinates can't make a hidden edge visible */
+float const SIDE_MARGIN = 1e-5f;
+
+// Lines have to cross an occluding edge at least this fraction of it away from its ends
+float const OCCLUDER_END_MARGIN = 1e-4f;
+
+/* Only that many edges nearest to a region are tried as occluders, which bounds the building time on big open maps,
+   where most edges are visible anyway and each of them would be tried against every occluder */
+int const OCCLUDERS_MAX = 512;
+
+// Number of times a part of an edge can be split, for it to be hidden behind several occluders
+int const SPLIT_DEPTH = 4;
+
+/// Returns the signed distance of a point in front of an edge's line
+float CalcSide(HideAndSeekAndShoot::WallEdgeTable const& wallEdges, int edgeInd, sf::Vector2f const point)
+{
+    sf::Vector2f const toPoint = point - wallEdges.GetEdgeStart(edgeInd);
+    sf::Vector2f const normal = wallEdges.GetEdgeNormal(edgeInd);
+    return toPoint.x * normal.x + toPoint.y * normal.y;
+}
+
+} // namespace
+
+namespace HideAndSeekAndShoot
+{
+
+PotentiallyVisibleSet::PotentiallyVisibleSet()
+    : _regionsPerSide(0),
+    _wallsCount(0),
+    _regionWallsBegin(1, 0),
+    _worldSize(1.f, 1.f)
+{}
+
+void PotentiallyVisibleSet::Build(
+    std::vector<std::vector<sf::Vector2f>> const& relWalls,
+    std::vector<int> const& wallPolygonInds,
+    int regionsPerSide)
+{
+    if (regionsPerSide <= 0)
+    {
+        throw std::runtime_error("Error: The number of regions per side of the potentially visible set must be positive.");
+    }
+
+    // The walls' edges in relative coordinates, as in the world's table
+    std::vector<sf::ConvexShape> walls(relWalls.size());
+    for (int wallInd = 0; wallInd < relWalls.size(); wallInd++)
+    {
+        walls[wallInd].setPointCount(relWalls[wallInd].size());
+        for (int verInd = 0; verInd < relWalls[wallInd].size(); verInd++)
+        {
+            walls[wallInd].setPoint(verInd, relWalls[wallInd][verInd]);
+        }
+    }
+    WallEdgeTable wallEdges;
+    wallEdges.Build(walls, wallPolygonInds);
+
+    _regionsPerSide = regionsPerSide;
+    _wallsCount = relWalls.size();
+    _regionWallsBegin.assign(1, 0);
+    _regionWalls.clear();
+
+    float const regionSize = 1.f / regionsPerSide;
+    std::vector<bool> candidates(wallEdges.GetEdgesCount());
+    std::vector<int> occluders;
+    std::vector<std::pair<float, int>> occluderDists;
+    for (int regionY = 0; regionY < regionsPerSide; regionY++)
+    {
+        for (int regionX = 0; regionX < regionsPerSide; regionX++)
+        {
+            sf::Vector2f const corners[4] = {
+                { regionX * regionSize, regionY * regionSize },
+                { (regionX + 1) * regionSize, regionY * regionSize },
+                { (regionX + 1) * regionSize, (regionY + 1) * regionSize },
+                { regionX * regionSize, (regionY + 1) * regionSize }
+            };
+            sf::Vector2f const center = (corners[0] + corners[2]) / 2.f;
+
+            /* Lines are blocked only by edges they cross from the front, so edges that the whole region is behind are never hit.
+               Edges that the whole region is in front of can hide the edges behind them. */
+            occluderDists.clear();
+            for (int edgeInd = 0; edgeInd < candidates.size(); edgeInd++)
+            {
+                float minSide = CalcSide(wallEdges, edgeInd, corners[0]);
+                float maxSide = minSide;
+                for (int i = 1; i < 4; i++)
+                {
+                    float const side = CalcSide(wallEdges, edgeInd, corners[i]);
+                    minSide = std::min(minSide, side);
+                    maxSide = std::max(maxSide, side);
+                }
+                candidates[edgeInd] = (maxSide >= -SIDE_MARGIN);
+                if (minSide > SIDE_MARGIN)
+                {
+                    sf::Vector2f const closest = wallEdges.FindClosestPointOnEdge(edgeInd, center);
+                    sf::Vector2f const toClosest = closest - center;
+                    occluderDists.push_back({ toClosest.x * toClosest.x + toClosest.y * toClosest.y, edgeInd });
+                }
+            }
+
+            // The nearest edges hide the most of the world
+            int const occludersCount = std::min<int>(occluderDists.size(), OCCLUDERS_MAX);
+            std::partial_sort(occluderDists.begin(), occluderDists.begin() + occludersCount, occluderDists.end());
+            occluders.clear();
+            for (int i = 0; i < occludersCount; i++)
+            {
+                occluders.push_back(occluderDists[i].second);
+            }
+
+            // A wall is potentially visible if any of its edges is
+            for (int wallInd = 0; wallInd < _wallsCount; wallInd++)
+            {
+                for (int edgeInd = wallEdges.GetWallEdgesBegin(wallInd); edgeInd < wallEdges.GetWallEdgesEnd(wallInd); edgeInd++)
+                {
+                    if (candidates[edgeInd]
+                        && !IsHidden(corners, wallEdges.GetEdgeStart(edgeInd), wallEdges.GetEdgeEnd(edgeInd), occluders, wallEdges, SPLIT_DEPTH))
+                    {
+                        _regionWalls.push_back(wallInd);
+                        break;
+                    }
+                }
+            }
+            _regionWallsBegin.push_back(_regionWalls.size());
+        }
+    }
+}
+
+void PotentiallyVisibleSet::Save(std::string const& filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Error: Cannot open file " + filename + " for writing.");
+    }
+
+    auto writeUint = [&file](std::uint32_t value) {
+        file.write(reinterpret_cast<char const*>(&value), sizeof(value));
+    };
+
+    file.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    writeUint(_regionsPerSide);
+    writeUint(_wallsCount);
+    for (int i = 0; i < _regionWallsBegin.size(); i++)
+    {
+        writeUint(_regionWallsBegin[i]);
+    }
+    for (int i = 0; i < _regionWalls.size(); i++)
+    {
+        writeUint(_regionWalls[i]);
+    }
+}
+
+void PotentiallyVisibleSet::Load(std::string const& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Error: Cannot open potentially visible set file " + filename + ".");
+    }
+
+    auto readUint = [&file]() -> std::uint32_t {
+        std::uint32_t value = 0;
+        file.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    };
+
+    char magic[sizeof(BINARY_MAGIC)];
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0)
+    {
+        throw std::runtime_error("Error: File " + filename + " is not a potentially visible set.");
+    }
+
+    // The counts are checked against the file's size before anything is allocated for them
+    std::streamoff const dataBegin = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::uint64_t const valuesCount = (file.tellg() - dataBegin) / sizeof(std::uint32_t);
+    file.seekg(dataBegin);
+
+    std::uint64_t const regionsPerSide = readUint();
+    _wallsCount = readUint();
+    std::uint64_t const regionsCount = regionsPerSide * regionsPerSide;
+    if (!file || regionsCount + 3 > valuesCount)
+    {
+        Clear();
+        throw std::runtime_error("Error: Potentially visible set " + filename + " is truncated.");
+    }
+    _regionsPerSide = regionsPerSide;
+    _regionWallsBegin.resize(regionsCount + 1);
+    for (int i = 0; i < _regionWallsBegin.size() && file; i++)
+    {
+        _regionWallsBegin[i] = readUint();
+    }
+    if (!file || (std::uint64_t)_regionWallsBegin.back() != valuesCount - regionsCount - 3)
+    {
+        Clear();
+        throw std::runtime_error("Error: Potentially visible set " + filename + " is truncated or has trailing data.");
+    }
+    _regionWalls.resize(_regionWallsBegin.back());
+    for (int i = 0; i < _regionWalls.size() && file; i++)
+    {
+        _regionWalls[i] = readUint();
+    }
+    if (!file)
+    {
+        Clear();
+        throw std::runtime_error("Error: Potentially visible set " + filename + " is truncated.");
+    }
+
+    // Ranges out of order or walls out of range would be read out of bounds when lines are cast
+    if (!IsConsistent())
+    {
+        Clear();
+        throw std::runtime_error("Error: Potentially visible set " + filename + " is corrupt.");
+    }
+}
+
+bool PotentiallyVisibleSet::IsConsistent() const
+{
+    if (_regionWallsBegin.empty() || _regionWallsBegin.front() != 0 || _regionWallsBegin.back() != (int)_regionWalls.size())
+    {
+        return false;
+    }
+    for (int regionInd = 0; regionInd + 1 < _regionWallsBegin.size(); regionInd++)
+    {
+        if (_regionWallsBegin[regionInd] > _regionWallsBegin[regionInd + 1])
+        {
+            return false;
+        }
+        // Walls of a region are in increasing order, which FindNearestCrossingAmong relies on
+        for (int i = _regionWallsBegin[regionInd]; i < _regionWallsBegin[regionInd + 1]; i++)
+        {
+            if (_regionWalls[i] < 0 || _regionWalls[i] >= _wallsCount
+                || (i > _regionWallsBegin[regionInd] && _regionWalls[i] <= _regionWalls[i - 1]))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void PotentiallyVisibleSet::Clear()
+{
+    _regionsPerSide = 0;
+    _wallsCount = 0;
+    _regionWallsBegin.clear();
+    _regionWalls.clear();
+}
+
+bool PotentiallyVisibleSet::IsEmpty() const
+{
+    return _regionsPerSide == 0;
+}
+
+int PotentiallyVisibleSet::GetWallsCount() const
+{
+    return _wallsCount;
+}
+
+void PotentiallyVisibleSet::SetWorldSize(sf::Vector2f const worldSize)
+{
+    _worldSize = worldSize;
+}
+
+int PotentiallyVisibleSet::FindRegion(sf::Vector2f const point) const
+{
+    if (_regionsPerSide == 0
+        || point.x < 0.f || point.y < 0.f || point.x > _worldSize.x || point.y > _worldSize.y)
+    {
+        return -1;
+    }
+    int const regionX = std::min((int)(point.x / _worldSize.x * _regionsPerSide), _regionsPerSide - 1);
+    int const regionY = std::min((int)(point.y / _worldSize.y * _regionsPerSide), _regionsPerSide - 1);
+    return regionY * _regionsPerSide + regionX;
+}
+
+int const* PotentiallyVisibleSet::GetRegionWallsBegin(int regionInd) const
+{
+    return _regionWalls.data() + _regionWallsBegin[regionInd];
+}
+
+int const* PotentiallyVisibleSet::GetRegionWallsEnd(int regionInd) const
+{
+    return _regionWalls.data() + _regionWallsBegin[regionInd + 1];
+}
+
+bool PotentiallyVisibleSet::IsHidden(
+    sf::Vector2f const (&corners)[4],
+    sf::Vector2f const pointA,
+    sf::Vector2f const pointB,
+    std::vector<int> const& occluders,
+    WallEdgeTable const& wallEdges,
+    int depth)
+{
+    for (int i = 0; i < occluders.size(); i++)
+    {
+        int const occluderInd = occluders[i];
+        if (CalcSide(wallEdges, occluderInd, pointA) > -SIDE_MARGIN || CalcSide(wallEdges, occluderInd, pointB) > -SIDE_MARGIN)
+        {
+            continue;
+        }
+
+        /* The part is behind the occluder's line and the region is in front of it, so every line between them crosses that line.
+           Where it crosses, as a fraction of the occluder, is a linear-fractional function of the line's end points,
+           so it is the furthest along the occluder for lines between corners of the region and ends of the part.
+           If all of those cross the occluder itself, so does every line between the region and the part. */
+        sf::Vector2f const start = wallEdges.GetEdgeStart(occluderInd);
+        sf::Vector2f const dir = wallEdges.GetEdgeEnd(occluderInd) - start;
+        bool hides = true;
+        for (int cornerInd = 0; cornerInd < 4 && hides; cornerInd++)
+        {
+            for (sf::Vector2f const end : { pointA, pointB })
+            {
+                sf::Vector2f const line = end - corners[cornerInd];
+                sf::Vector2f const fromStart = corners[cornerInd] - start;
+                float const fraction = (fromStart.x * line.y - fromStart.y * line.x) / (dir.x * line.y - dir.y * line.x);
+                if (fraction < OCCLUDER_END_MARGIN || fraction > 1.f - OCCLUDER_END_MARGIN)
+                {
+                    hides = false;
+                    break;
+                }
+            }
+        }
+        if (hides)
+        {
+            return true;
+        }
+    }
+
+    if (depth == 0)
+    {
+        return false;
+    }
+    sf::Vector2f const middle = (pointA + pointB) / 2.f;
+    return IsHidden(corners, pointA, middle, occluders, wallEdges, depth - 1)
+        && IsHidden(corners, middle, pointB, occluders, wallEdges, depth - 1);
+}
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "WallEdgeTable.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <string>
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * Potentially visible sets of the walls, for regions of the world.
+ * The world is split into a grid of regions, and for each region the set lists the walls
+ * that might be the first thing a line cast from a point in the region runs into.
+ * Every edge of all the other walls is either facing away from the whole region, or proven to be hidden from all of it
+ * behind edges nearer to it, so lines cast from the region can be checked against only the listed walls.
+ * 
+ * Visibility doesn't change when the world is scaled, so the sets are built once in relative coordinates,
+ * which makes building them an offline step for big maps - they can be saved to a file and loaded with the map.
+ */
+class PotentiallyVisibleSet
+{
+
+  public: /* constants */
+
+    /// Number of columns and rows of regions used when none is specified
+    static int const REGIONS_PER_SIDE_DEFAULT = 32;
+
+  public:
+
+    /// Creates an empty set, without any regions
+    PotentiallyVisibleSet();
+
+    /**
+     * Builds the sets for walls. Takes a while for big maps.
+     * 
+     * @param[in] relWalls
+     *  The walls in relative coordinates, which have to be convex
+     * @param[in] wallPolygonInds
+     *  For each wall, index of the polygon that it is a part of, as for the world's table of the walls' edges
+     * @param[in] regionsPerSide
+     *  Number of columns and rows of regions
+     */
+    void Build(
+        std::vector<std::vector<sf::Vector2f>> const& relWalls,
+        std::vector<int> const& wallPolygonInds,
+        int regionsPerSide);
+
+    /**
+     * Saves the sets to a file in a binary format. The format is the magic "HSSP",
+     * then the number of regions per side, the number of walls, the beginning of each region's range
+     * in the regions' walls with the end of the last one, and the regions' walls, all as 32-bit values.
+     * 
+     * @param[in] filename
+     *  Name of the file to write
+     */
+    void Save(std::string const& filename) const;
+
+    /**
+     * Loads the sets from a file written by Save.
+     * Throws an exception, leaving the set empty, if the file cannot be read, is not in that format,
+     * or has regions' ranges out of order or walls out of range.
+     * 
+     * @param[in] filename
+     *  Name of the file to read
+     */
+    void Load(std::string const& filename);
+
+    /// Returns whether there are no regions, in which case no point is in any region
+    bool IsEmpty() const;
+
+    /// Returns the number of walls the sets were built for, for checking that they match the walls
+    int GetWallsCount() const;
+
+    /// Sets the size of the world in pixels, which the regions cover
+    void SetWorldSize(sf::Vector2f const worldSize);
+
+    /// Returns the index of the region containing a point, or -1 if the point is outside of the world or the set is empty
+    int FindRegion(sf::Vector2f const point) const;
+
+    /// Returns the beginning of the range of indices of a region's potentially visible walls, which are in increasing order
+    int const* GetRegionWallsBegin(int regionInd) const;
+
+    /// Returns the end of the range of indices of a region's potentially visible walls
+    int const* GetRegionWallsEnd(int regionInd) const;
+
+  private: /* functions */
+
+    /// Checks whether the regions' ranges are in order and their walls in increasing order and in range
+    bool IsConsistent() const;
+
+    /// Removes all regions, leaving the set empty
+    void Clear();
+
+    /**
+     * Checks whether a part of an edge is hidden from a whole region, by splitting it into smaller parts
+     * until each of them is hidden behind a single occluding edge
+     * 
+     * @param[in] corners
+     *  Corners of the region
+     * @param[in] pointA, pointB
+     *  End points of the part of the edge
+     * @param[in] occluders
+     *  Indices of the edges that can hide something from the region, which is entirely in front of them
+     * @param[in] wallEdges
+     *  Table of the walls' edges
+     * @param[in] depth
+     *  How many more times the part can be split
+     * 
+     * @return true if the part is proven to be hidden, false if it might be visible
+     */
+    static bool IsHidden(
+        sf::Vector2f const (&corners)[4],
+        sf::Vector2f const pointA,
+        sf::Vector2f const pointB,
+        std::vector<int> const& occluders,
+        WallEdgeTable const& wallEdges,
+        int depth);
+
+  private: /* variables */
+
+    /// Number of columns and rows of regions, 0 if the set is empty
+    int _regionsPerSide;
+
+    /// Number of walls the sets were built for
+    int _wallsCount;
+
+    /// Beginning of each region's range in the regions' walls, by region index (row by row), and the end of the last one
+    std::vector<int> _regionWallsBegin;
+
+    /// Indices of the regions' potentially visible walls, region after region
+    std::vector<int> _regionWalls;
+
+    /// Size of the world in pixels
+    sf::Vector2f _worldSize;
+};
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,52 @@
+#include "RenderSnapshot.h"
+
+namespace HideAndSeekAndShoot
+{
+
+void RenderSnapshot::Clear()
+{
+    _sprites.clear();
+    _fanVertices.clear();
+    _fanStarts.assign(1, 0);
+}
+
+void RenderSnapshot::SetView(sf::View const& view)
+{
+    _view = view;
+}
+
+sf::View const& RenderSnapshot::GetView() const
+{
+    return _view;
+}
+
+void RenderSnapshot::AddSprite(sf::Sprite const& sprite)
+{
+    _sprites.push_back(sprite);
+}
+
+void RenderSnapshot::AddFan(sf::Vertex const* vertices, int count)
+{
+    _fanVertices.insert(_fanVertices.end(), vertices, vertices + count);
+    _fanStarts.push_back(_fanVertices.size());
+}
+
+void RenderSnapshot::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    for (int fanInd = 0; fanInd + 1 < _fanStarts.size(); fanInd++)
+    {
+        target.draw(
+            _fanVertices.data() + _fanStarts[fanInd],
+            _fanStarts[fanInd + 1] - _fanStarts[fanInd],
+            sf::TriangleFan,
+            states
+        );
+    }
+
+    for (int i = 0; i < _sprites.size(); i++)
+    {
+        target.draw(_sprites[i], states);
+    }
+}
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * Everything needed for drawing a single frame of the world, copied out of the world after it is updated.
+ * A snapshot doesn't point to any entities, only to textures, so it can be drawn on one thread
+ * while the world is being updated for the next frame on another.
+ * Its storage is kept between frames, so filling it again doesn't allocate once it is big enough.
+ */
+class RenderSnapshot : public sf::Drawable
+{
+
+  public:
+
+    /// Removes everything from the snapshot, keeping its storage
+    void Clear();
+
+    /// Sets the view of the world in which the snapshot is drawn
+    void SetView(sf::View const& view);
+
+    /// Returns the view of the world in which the snapshot is drawn, over the static layer of the world seen in it
+    sf::View const& GetView() const;
+
+    /// Adds a sprite, drawn on top of the sprites added before it
+    void AddSprite(sf::Sprite const& sprite);
+
+    /**
+     * Adds a triangle fan, drawn beneath all sprites
+     * 
+     * @param[in] vertices
+     *  Vertices of the fan
+     * @param[in] count
+     *  Number of vertices of the fan
+     */
+    void AddFan(sf::Vertex const* vertices, int count);
+
+  private: /* functions */
+
+    /**
+     * Draws the snapshot on the given render target
+     * 
+     * @param[in] target
+     *  RenderTarget object on which to draw the snapshot
+     */
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+
+  private: /* variables */
+
+    /// View of the world in which the snapshot is drawn
+    sf::View _view;
+
+    /// Sprites of the entities, in the order in which they are drawn
+    std::vector<sf::Sprite> _sprites;
+
+    /// Vertices of all triangle fans, one after another
+    std::vector<sf::Vertex> _fanVertices;
+    /// Index of the first vertex of each triangle fan, with one more element at the end for the total number of vertices
+    std::vector<int> _fanStarts;
+};
+
+} // namespace HideAndSeekAndShoot
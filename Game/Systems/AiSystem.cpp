@@ -0,0 +1,443 @@
+#include "AiSystem.h"
+
+#include "MovementSystem.h"
+#include "WeaponSystem.h"
+#include "../World.h"
+
+#include "../utils/geometryUtils.hpp"
+#include "../utils/hashUtils.hpp"
+#include "../utils/randomUtils.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+
+int const PERCEPTION_INTERVAL_DEFAULT = 6;
+
+float const ATTACK_DISTANCE_REL_DEFAULT = 0.25f;
+
+float const ARRIVE_DISTANCE_REL_DEFAULT = 0.03f;
+
+int const SHOOT_INTERVAL_DEFAULT = 45;
+
+// Number of random points to try before giving up on finding a reachable wander point in the current frame
+int const WANDER_POINT_ATTEMPTS = 20;
+
+// Names of the AI's modes and events in the config, in the order of their enums
+char const* const AI_MODE_NAMES[] = { "chase", "attack", "investigate", "wander" };
+char const* const AI_EVENT_NAMES[] = { "see_near", "see_far", "lose", "arrive", "stuck" };
+
+} // namespace
+
+namespace HideAndSeekAndShoot
+{
+
+AiSystem::AiSystem(World const* world, EntityRegistry* registry, MovementSystem* movementSystem, WeaponSystem* weaponSystem)
+    : _world(world),
+    _registry(registry),
+    _movementSystem(movementSystem),
+    _weaponSystem(weaponSystem),
+    _player(-1),
+    _crowdSteering(false)
+{}
+
+void AiSystem::Configure(Config const& config)
+{
+    _perceptionInterval = PERCEPTION_INTERVAL_DEFAULT;
+    auto const perceptionIntervalConfig = config.find("perception_interval");
+    if (perceptionIntervalConfig != config.end())
+    {
+        _perceptionInterval = std::max(1, std::stoi(perceptionIntervalConfig->second));
+    }
+
+    // Distances are specified relative to the view's width
+    float attackDistanceRel = ATTACK_DISTANCE_REL_DEFAULT;
+    auto const attackDistanceConfig = config.find("attack_distance");
+    if (attackDistanceConfig != config.end())
+    {
+        attackDistanceRel = std::stof(attackDistanceConfig->second);
+    }
+    _attackDistance = attackDistanceRel * _world->GetViewSize().x;
+
+    float arriveDistanceRel = ARRIVE_DISTANCE_REL_DEFAULT;
+    auto const arriveDistanceConfig = config.find("arrive_distance");
+    if (arriveDistanceConfig != config.end())
+    {
+        arriveDistanceRel = std::stof(arriveDistanceConfig->second);
+    }
+    _arriveDistance = arriveDistanceRel * _world->GetViewSize().x;
+
+    _shootInterval = SHOOT_INTERVAL_DEFAULT;
+    auto const shootIntervalConfig = config.find("shoot_interval");
+    if (shootIntervalConfig != config.end())
+    {
+        _shootInterval = std::stoi(shootIntervalConfig->second);
+    }
+
+    ConfigTransitions(config);
+}
+
+void AiSystem::SetPlayer(Entity player)
+{
+    _player = player;
+}
+
+void AiSystem::SetCrowdSteering(bool crowdSteering)
+{
+    _crowdSteering = crowdSteering;
+}
+
+void AiSystem::AddAi(Entity enemy, int index)
+{
+    AiState state;
+    state.mode = AiMode::Wander;
+    state.lastSeenPosition = sf::Vector2f(0.f, 0.f);
+    state.wanderPoint = sf::Vector2f(0.f, 0.f);
+    state.hasWanderPoint = false;
+    // Spread perceptions of different enemies across different frames
+    state.framesUntilPerception = index % _perceptionInterval;
+    state.framesUntilShot = 0;
+    state.shooting = false;
+    state.preferredVelocity = sf::Vector2f(0.f, 0.f);
+    state.elapsedFrames = 1;
+    state.lodTier = LodTier::Full;
+    state.lastUpdateFrame = -1;
+    _registry->GetComponents<AiState>().Add(enemy, state);
+
+    /* The generator depends only on the world's seed and the enemy's index,
+       so every world created with the same config simulates the same game */
+    std::seed_seq seeds{ _world->GetSeed(), (unsigned)index };
+    _registry->GetComponents<RandomGenerator>().Add(enemy, { std::mt19937(seeds) });
+
+    _registry->GetComponents<FieldOfView>().Add(enemy, FieldOfView(_world));
+}
+
+void AiSystem::Update(Entity enemy, int elapsedFrames)
+{
+    AiState& state = _registry->GetComponent<AiState>(enemy);
+    if (state.framesUntilPerception <= 0)
+    {
+        Perceive(enemy);
+        state.framesUntilPerception = _perceptionInterval;
+    }
+    state.framesUntilPerception -= elapsedFrames;
+
+    UpdateTargetPoint(enemy);
+
+    UpdateShooting(state, elapsedFrames);
+
+    state.elapsedFrames = elapsedFrames;
+    sf::Vector2f const pos = _registry->GetComponent<Transform>(enemy).position;
+    sf::Vector2f const targetPoint = _registry->GetComponent<Aim>(enemy).targetPoint;
+
+    if (_crowdSteering)
+    {
+        // When attacking, the enemy would like to stand still, but it still makes way for others
+        state.preferredVelocity = sf::Vector2f(0.f, 0.f);
+        if (state.mode != AiMode::Attack && targetPoint != pos)
+        {
+            // The enemy would like to get right to its target point, without overshooting it
+            float const speed = _registry->GetComponent<Velocity>(enemy).speed;
+            sf::Vector2f const toTarget = GeometryUtils::GetVector(pos, targetPoint) / (float)elapsedFrames;
+            float const dist = GeometryUtils::GetVectorLength(toTarget);
+            state.preferredVelocity = (dist > speed) ? toTarget * (speed / dist) : toTarget;
+        }
+        // The rest of the update is done when the enemy is moved
+        return;
+    }
+
+    // When attacking, the enemy stands still and only shoots
+    if (state.mode != AiMode::Attack)
+    {
+        _movementSystem->MoveTowards(enemy, targetPoint, (float)elapsedFrames);
+        GiveUpIfStuck(enemy, pos);
+    }
+
+    // The enemy aims from where it moved to, so its gun is drawn and shoots beside it
+    _weaponSystem->PointAtTarget(enemy);
+    UpdateFieldOfView(enemy);
+}
+
+void AiSystem::MoveWithVelocity(Entity enemy, sf::Vector2f const velocity)
+{
+    AiState const& state = _registry->GetComponent<AiState>(enemy);
+    Transform& transform = _registry->GetComponent<Transform>(enemy);
+    sf::Vector2f const prevPos = transform.position;
+    sf::Vector2f const step = velocity * (float)state.elapsedFrames;
+    if (step != sf::Vector2f(0.f, 0.f))
+    {
+        // Crowd steering keeps away from walls only approximately, so close to corners the enemy may go around them on its own
+        if (_movementSystem->IsPositionValid(enemy, prevPos + step))
+        {
+            transform.position = prevPos + step;
+        }
+        else if (state.mode != AiMode::Attack)
+        {
+            _movementSystem->MoveTowards(enemy, _registry->GetComponent<Aim>(enemy).targetPoint, (float)state.elapsedFrames);
+        }
+    }
+    _registry->GetComponent<Velocity>(enemy).velocity = velocity;
+
+    if (state.mode != AiMode::Attack)
+    {
+        GiveUpIfStuck(enemy, prevPos);
+    }
+
+    _weaponSystem->PointAtTarget(enemy);
+    UpdateFieldOfView(enemy);
+}
+
+void AiSystem::SetLodTier(Entity enemy, LodTier const tier)
+{
+    AiState& state = _registry->GetComponent<AiState>(enemy);
+    bool const detailed = (tier == LodTier::Full);
+
+    // The field of view has not been traced while in low detail, so it has to be traced before it is drawn again
+    if (detailed && state.lodTier != LodTier::Full)
+    {
+        _registry->GetComponent<FieldOfView>(enemy).Update();
+    }
+
+    state.lodTier = tier;
+    _registry->GetComponent<Collider>(enemy).coarse = !detailed;
+}
+
+void AiSystem::InvalidateWallsCaches()
+{
+    ComponentArray<FieldOfView>& fieldsOfView = _registry->GetComponents<FieldOfView>();
+    for (int i = 0; i < fieldsOfView.GetSize(); i++)
+    {
+        fieldsOfView.GetAt(i).InvalidateCache();
+    }
+}
+
+void AiSystem::Rescale(sf::Vector2f const scale)
+{
+    // Distances are relative to the view's width
+    _attackDistance *= scale.x;
+    _arriveDistance *= scale.x;
+
+    ComponentArray<AiState>& states = _registry->GetComponents<AiState>();
+    for (int i = 0; i < states.GetSize(); i++)
+    {
+        Entity const enemy = states.GetEntityAt(i);
+        AiState& state = states.GetAt(i);
+        state.lastSeenPosition = sf::Vector2f(state.lastSeenPosition.x * scale.x, state.lastSeenPosition.y * scale.y);
+        state.wanderPoint = sf::Vector2f(state.wanderPoint.x * scale.x, state.wanderPoint.y * scale.y);
+        state.preferredVelocity = sf::Vector2f(state.preferredVelocity.x * scale.x, state.preferredVelocity.y * scale.y);
+
+        // Velocities scale with the world like the positions
+        Velocity& velocity = _registry->GetComponent<Velocity>(enemy);
+        velocity.velocity = sf::Vector2f(velocity.velocity.x * scale.x, velocity.velocity.y * scale.y);
+
+        // Lines cached by the field of view were blocked by the walls before they were moved
+        FieldOfView& fieldOfView = _registry->GetComponent<FieldOfView>(enemy);
+        fieldOfView.InvalidateCache();
+        fieldOfView.SetOrigin(_registry->GetComponent<Transform>(enemy).position);
+        if (state.lodTier == LodTier::Full)
+        {
+            fieldOfView.Update();
+        }
+    }
+}
+
+void AiSystem::HashState(Entity enemy, std::uint64_t& hash) const
+{
+    AiState const& state = _registry->GetComponent<AiState>(enemy);
+    HashUtils::HashValue(hash, (int)state.mode);
+    HashUtils::HashVector(hash, state.lastSeenPosition);
+    HashUtils::HashVector(hash, state.wanderPoint);
+    HashUtils::HashValue(hash, state.hasWanderPoint);
+    HashUtils::HashValue(hash, state.framesUntilPerception);
+    HashUtils::HashValue(hash, state.framesUntilShot);
+    HashUtils::HashValue(hash, state.shooting);
+    HashUtils::HashVector(hash, state.preferredVelocity);
+    HashUtils::HashValue(hash, state.elapsedFrames);
+
+    // The generator's next value stands for its whole state, which is too big to hash every update
+    std::mt19937 rng = _registry->GetComponent<RandomGenerator>(enemy).engine;
+    HashUtils::HashValue(hash, (std::uint32_t)rng());
+}
+
+void AiSystem::Perceive(Entity enemy)
+{
+    AiState& state = _registry->GetComponent<AiState>(enemy);
+    sf::Vector2f const playerPos = _registry->GetComponent<Transform>(_player).position;
+
+    if (_registry->GetComponent<FieldOfView>(enemy).Sees(playerPos))
+    {
+        state.lastSeenPosition = playerPos;
+        float const dist = GeometryUtils::CalcDist(_registry->GetComponent<Transform>(enemy).position, playerPos);
+        Transition(state, (dist <= _attackDistance) ? AiEvent::SeePlayerNear : AiEvent::SeePlayerFar);
+    }
+    else
+    {
+        Transition(state, AiEvent::LosePlayer);
+    }
+}
+
+void AiSystem::Transition(AiState& state, AiEvent const event) const
+{
+    AiMode const nextMode = _transitions[(int)state.mode][(int)event];
+    if (nextMode == AiMode::Wander && (state.mode != AiMode::Wander || event == AiEvent::Stuck))
+    {
+        state.hasWanderPoint = false;
+    }
+    state.mode = nextMode;
+}
+
+void AiSystem::UpdateTargetPoint(Entity enemy)
+{
+    AiState& state = _registry->GetComponent<AiState>(enemy);
+    sf::Vector2f& targetPoint = _registry->GetComponent<Aim>(enemy).targetPoint;
+    sf::Vector2f const pos = _registry->GetComponent<Transform>(enemy).position;
+
+    // The player is not where they were seen
+    if (state.mode == AiMode::Investigate && GeometryUtils::CalcDist(pos, state.lastSeenPosition) < _arriveDistance)
+    {
+        Transition(state, AiEvent::Arrive);
+    }
+
+    switch (state.mode)
+    {
+    case AiMode::Chase:
+    case AiMode::Attack:
+        // Between perceptions the enemy keeps following the player it has seen
+        targetPoint = _registry->GetComponent<Transform>(_player).position;
+        break;
+
+    case AiMode::Investigate:
+        targetPoint = state.lastSeenPosition;
+        break;
+
+    case AiMode::Wander:
+        if (!state.hasWanderPoint || GeometryUtils::CalcDist(pos, state.wanderPoint) < _arriveDistance)
+        {
+            state.hasWanderPoint = ChooseWanderPoint(enemy, state.wanderPoint);
+        }
+        targetPoint = state.hasWanderPoint ? state.wanderPoint : pos;
+        break;
+
+    default:
+        break;
+    }
+}
+
+void AiSystem::UpdateShooting(AiState& state, int elapsedFrames) const
+{
+    state.shooting = false;
+    if (state.framesUntilShot > 0)
+    {
+        state.framesUntilShot -= elapsedFrames;
+    }
+
+    // The enemy shoots from time to time, whenever it sees the player
+    if ((state.mode == AiMode::Chase || state.mode == AiMode::Attack) && state.framesUntilShot <= 0)
+    {
+        state.shooting = true;
+        state.framesUntilShot = _shootInterval;
+    }
+}
+
+void AiSystem::GiveUpIfStuck(Entity enemy, sf::Vector2f const prevPos)
+{
+    // If the enemy got stuck on its way to a point, it may give up on that point
+    if (_registry->GetComponent<Transform>(enemy).position == prevPos)
+    {
+        Transition(_registry->GetComponent<AiState>(enemy), AiEvent::Stuck);
+    }
+}
+
+void AiSystem::UpdateFieldOfView(Entity enemy)
+{
+    FieldOfView& fieldOfView = _registry->GetComponent<FieldOfView>(enemy);
+    sf::Vector2f const pos = _registry->GetComponent<Transform>(enemy).position;
+    sf::Vector2f const targetPoint = _registry->GetComponent<Aim>(enemy).targetPoint;
+    fieldOfView.SetOrigin(pos);
+    // The enemy looks towards its target point, unless it has already reached it
+    if (targetPoint != pos)
+    {
+        fieldOfView.SetTargetDirection(
+            GeometryUtils::GetVector(pos, targetPoint)
+        );
+    }
+    // Only the lines of the field of view are skipped in low detail, perception needs just its origin and direction
+    if (_registry->GetComponent<AiState>(enemy).lodTier == LodTier::Full)
+    {
+        fieldOfView.Update();
+    }
+}
+
+bool AiSystem::ChooseWanderPoint(Entity enemy, sf::Vector2f& point)
+{
+    std::mt19937& rng = _registry->GetComponent<RandomGenerator>(enemy).engine;
+    sf::Vector2f const pos = _registry->GetComponent<Transform>(enemy).position;
+    sf::Vector2f const worldSize = _world->GetSize();
+
+    /* For now only points that can be reached in a straight line are chosen.
+       (Later it can be any point, with the path found by an A* algorithm) */
+    for (int attempt = 0; attempt < WANDER_POINT_ATTEMPTS; attempt++)
+    {
+        // Braced initialization draws the coordinates in order, so the same seed gives the same point everywhere
+        sf::Vector2f const candidate{ RandomUtils::UniformFloat(rng, 0.f, worldSize.x), RandomUtils::UniformFloat(rng, 0.f, worldSize.y) };
+        if (_movementSystem->IsPositionValid(enemy, candidate) && _world->IsLineOfSightClear(pos, candidate))
+        {
+            point = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void AiSystem::ConfigTransitions(Config const& config)
+{
+    // By default an event doesn't change the mode
+    for (int modeInd = 0; modeInd < (int)AiMode::Count; modeInd++)
+    {
+        _transitions[modeInd].fill((AiMode)modeInd);
+    }
+
+    // Seeing the player makes the enemy chase them, or attack them if they are close enough
+    for (int modeInd = 0; modeInd < (int)AiMode::Count; modeInd++)
+    {
+        _transitions[modeInd][(int)AiEvent::SeePlayerNear] = AiMode::Attack;
+        _transitions[modeInd][(int)AiEvent::SeePlayerFar] = AiMode::Chase;
+    }
+    // If the player was seen until now, the enemy goes to check where they were seen for the last time
+    _transitions[(int)AiMode::Chase][(int)AiEvent::LosePlayer] = AiMode::Investigate;
+    _transitions[(int)AiMode::Attack][(int)AiEvent::LosePlayer] = AiMode::Investigate;
+    // An enemy that finds no one where the player was seen, or gets stuck on its way, is lost and wanders
+    _transitions[(int)AiMode::Investigate][(int)AiEvent::Arrive] = AiMode::Wander;
+    _transitions[(int)AiMode::Investigate][(int)AiEvent::Stuck] = AiMode::Wander;
+
+    for (int modeInd = 0; modeInd < (int)AiMode::Count; modeInd++)
+    {
+        for (int eventInd = 0; eventInd < (int)AiEvent::Count; eventInd++)
+        {
+            auto const transitionConfig = config.find(
+                std::string("transition_") + AI_MODE_NAMES[modeInd] + "_" + AI_EVENT_NAMES[eventInd]
+            );
+            if (transitionConfig != config.end())
+            {
+                _transitions[modeInd][eventInd] = ParseAiMode(transitionConfig->second);
+            }
+        }
+    }
+}
+
+AiMode AiSystem::ParseAiMode(std::string const& name)
+{
+    for (int modeInd = 0; modeInd < (int)AiMode::Count; modeInd++)
+    {
+        if (name == AI_MODE_NAMES[modeInd])
+        {
+            return (AiMode)modeInd;
+        }
+    }
+    throw std::runtime_error("Error: Unknown enemy AI state \"" + name + "\" in the enemy config.");
+}
+
+} // namespace HideAndSeekAndShoot
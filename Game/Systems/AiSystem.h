@@ -0,0 +1,256 @@
+#pragma once
+
+#include "../Ecs/Components.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+
+typedef std::map<std::string, std::string> Config;
+
+namespace HideAndSeekAndShoot
+{
+
+class World;
+class MovementSystem;
+class WeaponSystem;
+
+/**
+ * System of the enemies' AI. An enemy is a person with an AI state, a random generator and a field of view,
+ * and it is controlled by a simple AI state machine:
+ *  - Chase: The player is seen, so the enemy moves towards them
+ *  - Attack: The player is seen and close enough, so the enemy stands and shoots at them
+ *  - Investigate: The player is not seen anymore, so the enemy goes to where it last saw them
+ *  - Wander: The enemy has no idea where the player is, so it goes to random reachable points
+ * 
+ * The modes change on events - seeing the player near or far, losing sight of them, arriving where the player was seen,
+ * and getting stuck on the way. Which mode each event leads to from each mode is taken from the enemy config,
+ * with keys like transition_chase_lose=investigate, and the transitions not in the config keep to the defaults above.
+ * 
+ * Checking whether the player is seen (perception) is the expensive part,
+ * so it is not done every frame, but once in a configurable number of frames.
+ * Different enemies do it in different frames, so that they don't all do it together.
+ */
+class AiSystem
+{
+
+  public:
+
+    /**
+     * Creates the system
+     * 
+     * @param[in] world
+     *  Pointer to the world of the enemies, for its size, its walls and its seed
+     * @param[in] registry
+     *  Pointer to the registry of the world's entities
+     * @param[in] movementSystem
+     *  Pointer to the system moving the enemies
+     * @param[in] weaponSystem
+     *  Pointer to the system pointing the enemies and their guns towards their target points
+     */
+    AiSystem(World const* world, EntityRegistry* registry, MovementSystem* movementSystem, WeaponSystem* weaponSystem);
+
+    /**
+     * Configures the AI - perception interval, distances, shooting interval and transitions, as specified in a config.
+     * Has to be done before any enemy is added.
+     * 
+     * @param[in] config
+     *  The enemies' config
+     */
+    void Configure(Config const& config);
+
+    /// Sets the player, who is chased by the enemies
+    void SetPlayer(Entity player);
+
+    /**
+     * Sets whether the enemies are moved by crowd steering.
+     * Such an enemy doesn't move in its update, only decides on the velocity it would like to move with.
+     * Then it is moved by MoveWithVelocity, with a velocity that avoids the other enemies.
+     * 
+     * @param[in] crowdSteering
+     *  true for being moved by crowd steering, false for moving on their own
+     */
+    void SetCrowdSteering(bool crowdSteering);
+
+    /**
+     * Makes a person an enemy, adding an AI state, a random generator and a field of view to it
+     * 
+     * @param[in] enemy
+     *  The person
+     * @param[in] index
+     *  Index of the enemy in its world. Together with the world's seed it seeds the enemy's random generator,
+     *  and it spreads different enemies' perceptions across different frames.
+     */
+    void AddAi(Entity enemy, int index);
+
+    /**
+     * Updates an enemy - perceives the player, if it is time for that, and acts according to its mode
+     * 
+     * @param[in] enemy
+     *  The enemy
+     * @param[in] elapsedFrames
+     *  Number of frames since the enemy's last update.
+     *  Enemies that are far from the player are not updated every frame,
+     *  and then they do at once what they would have done in all the skipped frames.
+     */
+    void Update(Entity enemy, int elapsedFrames);
+
+    /**
+     * Moves an enemy with a velocity chosen by crowd steering, for all the frames since its last update,
+     * and finishes its update.
+     * If the velocity would get the enemy into a wall, it goes around the wall on its own instead.
+     * 
+     * @param[in] enemy
+     *  The enemy
+     * @param[in] velocity
+     *  Velocity to move with, in pixels per frame
+     */
+    void MoveWithVelocity(Entity enemy, sf::Vector2f const velocity);
+
+    /**
+     * Sets the level of detail with which an enemy is simulated.
+     * Enemies that are not simulated in full detail use coarse collisions with walls,
+     * and their field of view is not traced and drawn, only used for checking whether they see the player.
+     * 
+     * @param[in] enemy
+     *  The enemy
+     * @param[in] tier
+     *  The level of detail
+     */
+    void SetLodTier(Entity enemy, LodTier const tier);
+
+    /// Forgets the walls' edges cached by the fields of view, which has to be done when the world's walls are replaced
+    void InvalidateWallsCaches();
+
+    /**
+     * Scales the enemies' remembered positions and velocities, and the distances of the AI, when the world is resized.
+     * The fields of view are traced again, so the positions have to be resized before.
+     * 
+     * @param[in] scale
+     *  Ratio of the world's new size to its old size, for each axis
+     */
+    void Rescale(sf::Vector2f const scale);
+
+    /**
+     * Adds an enemy's AI state, its timers and its random generator's state to a hash of the world's state
+     * 
+     * @param[in] enemy
+     *  The enemy
+     * @param[in,out] hash
+     *  The hash
+     */
+    void HashState(Entity enemy, std::uint64_t& hash) const;
+
+  private: /* types */
+
+    /// Events on which the enemy's AI changes its mode
+    enum class AiEvent { SeePlayerNear, SeePlayerFar, LosePlayer, Arrive, Stuck, Count };
+
+    /// Table of the mode to go to, for each mode and event
+    typedef std::array<std::array<AiMode, (int)AiEvent::Count>, (int)AiMode::Count> AiTransitions;
+
+  private: /* functions */
+
+    /// Checks whether an enemy sees the player, and changes its mode accordingly
+    void Perceive(Entity enemy);
+
+    /**
+     * Changes an enemy's mode as the transitions specify for an event.
+     * An enemy that gets stuck, or starts wandering, chooses a new point to wander to.
+     * 
+     * @param[in,out] state
+     *  State of the enemy's AI
+     * @param[in] event
+     *  The event
+     */
+    void Transition(AiState& state, AiEvent const event) const;
+
+    /// Updates an enemy's target point according to its mode
+    void UpdateTargetPoint(Entity enemy);
+
+    /**
+     * Decides whether an enemy shoots in the current frame
+     * 
+     * @param[in,out] state
+     *  State of the enemy's AI
+     * @param[in] elapsedFrames
+     *  Number of frames since the enemy's last update
+     */
+    void UpdateShooting(AiState& state, int elapsedFrames) const;
+
+    /**
+     * Makes an enemy give up on the point it is going to, if it could not move towards it
+     * 
+     * @param[in] enemy
+     *  The enemy
+     * @param[in] prevPos
+     *  Position of the enemy before it tried to move
+     */
+    void GiveUpIfStuck(Entity enemy, sf::Vector2f const prevPos);
+
+    /// Moves an enemy's field of view along with it, and traces it if the enemy is simulated in full detail
+    void UpdateFieldOfView(Entity enemy);
+
+    /**
+     * Chooses a random point in the world that an enemy can reach by going in a straight line.
+     * 
+     * @param[in] enemy
+     *  The enemy
+     * @param[out] point
+     *  The chosen point
+     * 
+     * @return true if such a point was found, false otherwise
+     */
+    bool ChooseWanderPoint(Entity enemy, sf::Vector2f& point);
+
+    /**
+     * Configures the transitions of the AI's modes, as specified in a config
+     * 
+     * @param[in] config
+     *  The enemies' config
+     */
+    void ConfigTransitions(Config const& config);
+
+    /// Returns the mode with the given name, as used in the config
+    static AiMode ParseAiMode(std::string const& name);
+
+  private: /* variables */
+
+    /// The world of the enemies
+    World const* _world;
+
+    /// Registry of the world's entities
+    EntityRegistry* _registry;
+
+    /// System moving the enemies
+    MovementSystem* _movementSystem;
+
+    /// System pointing the enemies and their guns towards their target points
+    WeaponSystem* _weaponSystem;
+
+    /// The player that is being chased by the enemies
+    Entity _player;
+
+    /// Whether the enemies are moved by crowd steering, instead of moving on their own
+    bool _crowdSteering;
+
+    /// Mode to go to, for each mode and event
+    AiTransitions _transitions;
+
+    /// Number of frames between two perceptions
+    int _perceptionInterval;
+
+    /// If the player is seen and closer than this distance, an enemy attacks instead of chasing, in pixels
+    float _attackDistance;
+
+    /// An enemy considers a point reached when it is closer than this distance, in pixels
+    float _arriveDistance;
+
+    /// Number of frames between two shots
+    int _shootInterval;
+};
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,178 @@
+#include "BulletSystem.h"
+
+#include "../World.h"
+
+#include "../utils/geometryUtils.hpp"
+#include "../utils/hashUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+/* A bullet has a single despawn scheduled, except for those left behind when its exit is calculated again,
+   which wait until their ticks come, so the wheel needs room for more despawns than bullets */
+int const DESPAWNS_PER_BULLET = 2;
+
+} // namespace
+
+namespace HideAndSeekAndShoot
+{
+
+BulletSystem::BulletSystem(World const* world, EntityRegistry* registry, int despawnWheelSize)
+    : _world(world),
+    _registry(registry),
+    _despawnWheel(despawnWheelSize)
+{}
+
+void BulletSystem::Spawn(sf::Vector2f const position, sf::Vector2f const targetDir, Weapon const& weapon)
+{
+    // Bullets never turn
+    Entity const bullet = _registry->Create();
+    _registry->GetComponents<Transform>().Add(bullet, { position, 0.f });
+    _registry->GetComponents<Velocity>().Add(bullet, {
+        GeometryUtils::NormaliseVector(targetDir) * weapon.bulletSpeed,
+        weapon.bulletSpeed
+    });
+    _registry->GetComponents<Sprite>().Add(bullet, { weapon.bulletTexture, weapon.bulletScale });
+    _registry->GetComponents<Trajectory>().Add(bullet, Trajectory());
+
+    StartTrajectory(bullet);
+}
+
+void BulletSystem::Reserve(int bulletsCount)
+{
+    _registry->ReserveEntities(bulletsCount);
+
+    ComponentArray<Transform>& transforms = _registry->GetComponents<Transform>();
+    transforms.Reserve(transforms.GetSize() + bulletsCount);
+    ComponentArray<Velocity>& velocities = _registry->GetComponents<Velocity>();
+    velocities.Reserve(velocities.GetSize() + bulletsCount);
+    ComponentArray<Sprite>& sprites = _registry->GetComponents<Sprite>();
+    sprites.Reserve(sprites.GetSize() + bulletsCount);
+    ComponentArray<Trajectory>& trajectories = _registry->GetComponents<Trajectory>();
+    trajectories.Reserve(trajectories.GetSize() + bulletsCount);
+
+    _despawnWheel.Reserve(DESPAWNS_PER_BULLET * bulletsCount);
+}
+
+void BulletSystem::Update()
+{
+    ComponentArray<Trajectory> const& trajectories = _registry->GetComponents<Trajectory>();
+    for (int i = 0; i < trajectories.GetSize(); i++)
+    {
+        Entity const bullet = trajectories.GetEntityAt(i);
+        Trajectory const& trajectory = trajectories.GetAt(i);
+        _registry->GetComponent<Transform>(bullet).position = trajectory.startPosition
+            + _registry->GetComponent<Velocity>(bullet).velocity * (float)(_world->GetFrameCount() - trajectory.startTick + 1);
+    }
+
+    Despawn();
+}
+
+void BulletSystem::RecalcExitTicks()
+{
+    ComponentArray<Trajectory> const& trajectories = _registry->GetComponents<Trajectory>();
+    for (int i = 0; i < trajectories.GetSize(); i++)
+    {
+        StartTrajectory(trajectories.GetEntityAt(i));
+    }
+}
+
+void BulletSystem::Rescale(sf::Vector2f const scale)
+{
+    ComponentArray<Trajectory> const& trajectories = _registry->GetComponents<Trajectory>();
+    for (int i = 0; i < trajectories.GetSize(); i++)
+    {
+        // Speed is relative to the view's width
+        Velocity& velocity = _registry->GetComponent<Velocity>(trajectories.GetEntityAt(i));
+        velocity.speed *= scale.x;
+        velocity.velocity = sf::Vector2f(velocity.velocity.x * scale.x, velocity.velocity.y * scale.y);
+    }
+
+    RecalcExitTicks();
+}
+
+void BulletSystem::HashState(std::uint64_t& hash) const
+{
+    ComponentArray<Trajectory> const& trajectories = _registry->GetComponents<Trajectory>();
+    for (int i = 0; i < trajectories.GetSize(); i++)
+    {
+        Entity const bullet = trajectories.GetEntityAt(i);
+        Trajectory const& trajectory = trajectories.GetAt(i);
+        HashUtils::HashVector(hash, _registry->GetComponent<Transform>(bullet).position);
+        HashUtils::HashVector(hash, _registry->GetComponent<Velocity>(bullet).velocity);
+        HashUtils::HashVector(hash, trajectory.startPosition);
+        HashUtils::HashValue(hash, trajectory.startTick);
+        HashUtils::HashValue(hash, trajectory.exitTick);
+    }
+}
+
+void BulletSystem::StartTrajectory(Entity bullet)
+{
+    Trajectory& trajectory = _registry->GetComponent<Trajectory>(bullet);
+    sf::Vector2f const velocity = _registry->GetComponent<Velocity>(bullet).velocity;
+    trajectory.startPosition = _registry->GetComponent<Transform>(bullet).position;
+    trajectory.startTick = _world->GetFrameCount();
+
+    // Steps after which the bullet is out of the world along an axis, the fewest of them for both axes
+    int steps = std::numeric_limits<int>::max();
+    sf::Vector2f const worldSize = _world->GetSize();
+    float const start[2] = { trajectory.startPosition.x, trajectory.startPosition.y };
+    float const velocityCoords[2] = { velocity.x, velocity.y };
+    float const size[2] = { worldSize.x, worldSize.y };
+    for (int axis = 0; axis < 2; axis++)
+    {
+        float axisSteps;
+        if (velocityCoords[axis] > 0.f)
+        {
+            axisSteps = std::floor((size[axis] - start[axis]) / velocityCoords[axis]) + 1.f;
+        }
+        else if (velocityCoords[axis] < 0.f)
+        {
+            axisSteps = std::floor(start[axis] / -velocityCoords[axis]) + 1.f;
+        }
+        else if (start[axis] < 0.f || start[axis] > size[axis])
+        {
+            axisSteps = 1.f;
+        }
+        else
+        {
+            continue;
+        }
+        steps = std::min(steps, (int)std::clamp(axisSteps, 1.f, (float)std::numeric_limits<int>::max() / 2));
+    }
+
+    // A bullet that doesn't move would never leave, so it is removed at once
+    if (steps == std::numeric_limits<int>::max())
+    {
+        steps = 1;
+    }
+
+    // The bullet is removed in the update in which it reaches the first wall on its way out
+    float fraction;
+    if (_world->FindNearestWallCrossing(trajectory.startPosition, trajectory.startPosition + velocity * (float)steps, fraction) >= 0)
+    {
+        steps = std::max((int)std::ceil(fraction * steps), 1);
+    }
+
+    trajectory.exitTick = trajectory.startTick + steps - 1;
+    _despawnWheel.Schedule(bullet, trajectory.exitTick);
+}
+
+void BulletSystem::Despawn()
+{
+    int const frameCount = _world->GetFrameCount();
+    _despawnWheel.TakeDue(frameCount, [this, frameCount](Entity bullet) {
+        // The bullet may have been rescheduled since, or destroyed and its entity given to another bullet
+        ComponentArray<Trajectory> const& trajectories = _registry->GetComponents<Trajectory>();
+        if (trajectories.Has(bullet) && trajectories.Get(bullet).exitTick == frameCount)
+        {
+            _registry->Destroy(bullet);
+        }
+    });
+}
+
+} // namespace HideAndSeekAndShoot
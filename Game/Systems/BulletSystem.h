@@ -0,0 +1,116 @@
+#pragma once
+
+#include "../Ecs/Components.h"
+#include "../TimingWheel.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <cstdint>
+
+namespace HideAndSeekAndShoot
+{
+
+class World;
+
+/**
+ * System of the bullets - entities with a transform, a velocity, a sprite and a trajectory.
+ * A bullet moves with constant velocity from the gun that shot it, until it hits a wall, or goes out of the world.
+ * Since the velocity is constant, its position is evaluated from its trajectory in each update,
+ * and the tick at which it exits is calculated in advance, when it is shot,
+ * and its despawn is scheduled on a timing wheel at that tick, so that no bullet has to be checked each update.
+ */
+class BulletSystem
+{
+
+  public:
+
+    /**
+     * Creates the system
+     * 
+     * @param[in] world
+     *  Pointer to the world in which the bullets fly, for its size, its walls and its current tick
+     * @param[in] registry
+     *  Pointer to the registry of the world's entities
+     * @param[in] despawnWheelSize
+     *  Number of ticks in a turn of the wheel on which the bullets' despawns are scheduled
+     */
+    BulletSystem(World const* world, EntityRegistry* registry, int despawnWheelSize);
+
+    /**
+     * Creates a bullet, starting its trajectory at the world's current tick
+     * 
+     * @param[in] position
+     *  Position from which the bullet has been shot
+     * @param[in] targetDir
+     *  Target direction of the bullet.
+     *  A direction vector, specifying only direction, length will be ignored
+     * @param[in] weapon
+     *  Weapon that shot the bullet, with the bullets' texture and speed
+     */
+    void Spawn(sf::Vector2f const position, sf::Vector2f const targetDir, Weapon const& weapon);
+
+    /**
+     * Reserves room for a number of bullets besides the entities that already exist,
+     * so that shooting doesn't allocate as long as there are no more bullets at once
+     * 
+     * @param[in] bulletsCount
+     *  Number of bullets
+     */
+    void Reserve(int bulletsCount);
+
+    /**
+     * Moves all the bullets to their positions at the world's current tick, in a linear pass over their trajectories,
+     * and removes those that hit a wall or left the world in it
+     */
+    void Update();
+
+    /// Calculates again the ticks at which the bullets exit, when the walls have changed, starting their trajectories anew
+    void RecalcExitTicks();
+
+    /**
+     * Scales the bullets' velocities, so that they keep flying along their stretched paths like the positions,
+     * and calculates again the ticks at which they exit, so the walls and the positions have to be resized before
+     * 
+     * @param[in] scale
+     *  Ratio of the world's new size to its old size, for each axis
+     */
+    void Rescale(sf::Vector2f const scale);
+
+    /**
+     * Adds the bullets' positions and trajectories to a hash of the world's state
+     * 
+     * @param[in,out] hash
+     *  The hash
+     */
+    void HashState(std::uint64_t& hash) const;
+
+  private: /* functions */
+
+    /**
+     * Starts the trajectory of a bullet at its current position, from the world's current tick,
+     * and calculates the tick at which it exits.
+     * The number of steps until it leaves the world is found for each axis in closed form,
+     * and the bullet's path up to there is checked for the first wall it runs into.
+     * Its despawn is scheduled at that tick.
+     * 
+     * @param[in] bullet
+     *  The bullet
+     */
+    void StartTrajectory(Entity bullet);
+
+    /// Removes the bullets whose despawns are scheduled at the current tick - those that hit a wall or left the world
+    void Despawn();
+
+  private: /* variables */
+
+    /// The world in which the bullets fly
+    World const* _world;
+
+    /// Registry of the world's entities
+    EntityRegistry* _registry;
+
+    /// Wheel on which the bullets' despawns are scheduled by their entities
+    TimingWheel _despawnWheel;
+};
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,258 @@
+#include "MovementSystem.h"
+
+#include "../World.h"
+
+#include "../utils/geometryUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace HideAndSeekAndShoot
+{
+
+MovementSystem::MovementSystem(World const* world, EntityRegistry* registry)
+    : _world(world),
+    _registry(registry)
+{}
+
+bool MovementSystem::IsPositionValid(Entity person, sf::Vector2f const position) const
+{
+    Collider const& collider = _registry->GetComponent<Collider>(person);
+    if (!IsPositionInWorld(collider, position))
+    {
+        return false;
+    }
+
+    return IsPositionOutsideWalls(collider, _registry->GetComponent<Transform>(person).position, position);
+}
+
+void MovementSystem::MoveInDirection(Entity person, sf::Vector2f const dirVector)
+{
+    Transform& transform = _registry->GetComponent<Transform>(person);
+    Collider const& collider = _registry->GetComponent<Collider>(person);
+
+    // Calculate velocity vector in the given direction with the person's constant speed
+    sf::Vector2f velocity = GeometryUtils::NormaliseVector(dirVector) * _registry->GetComponent<Velocity>(person).speed;
+    sf::Vector2f nextPosition = transform.position + velocity;
+
+    // If the next position is valid, move the person there
+    if (IsPositionValid(person, nextPosition))
+    {
+        transform.position = nextPosition;
+    }
+    /* Otherwise move the person to that direction, step by step, until its position stops being valid.
+        This is needed so that the person can go as close as possible to objects,
+        and not be stopped when he's a few pixels away. */
+    else
+    {
+        nextPosition = transform.position;
+        sf::Vector2f stepVector = GeometryUtils::NormaliseVector(dirVector) * collider.movementPrecision;
+        while (IsPositionValid(person, nextPosition + stepVector))
+        {
+            nextPosition += stepVector;
+        }
+        transform.position = nextPosition;
+    }
+}
+
+void MovementSystem::MoveTowards(Entity person, sf::Vector2f const targetPoint, float speedScale)
+{
+    Transform& transform = _registry->GetComponent<Transform>(person);
+    sf::Vector2f const currPos = transform.position;
+    // There is no direction to move in if the target point is already reached
+    if (targetPoint == currPos)
+    {
+        return;
+    }
+
+    // Calculate velocity vector in the given direction with the person's constant speed
+    sf::Vector2f velocity = GeometryUtils::NormaliseVector(
+        targetPoint - currPos)
+        * _registry->GetComponent<Velocity>(person).speed * speedScale;
+    sf::Vector2f nextPosition = currPos + velocity;
+
+    // If the next position is valid, move the person there
+    if (IsPositionValid(person, nextPosition))
+    {
+        transform.position = nextPosition;
+    }
+    else
+    {
+        /* Each direction is rotated from the velocity directly, by a precomputed angle,
+           so that no error accumulates over the steps and no trigonometry is done while moving.
+           All the directions are checked in a single query, alternating left and right, by increasing angle. */
+        std::vector<sf::Vector2f> const& goAroundRotations = *_registry->GetComponent<Collider>(person).goAroundRotations;
+        std::pmr::vector<sf::Vector2f> candidates(_world->GetFrameMemory());
+        candidates.reserve(2 * goAroundRotations.size());
+        for (int i = 0; i < goAroundRotations.size(); i++)
+        {
+            sf::Vector2f const& rotation = goAroundRotations[i];
+            candidates.push_back(currPos + GeometryUtils::RotateVector(velocity, rotation.x, rotation.y));
+            candidates.push_back(currPos + GeometryUtils::RotateVector(velocity, rotation.x, -rotation.y));
+        }
+
+        int const validInd = FindFirstValidPosition(person, candidates);
+        if (validInd >= 0)
+        {
+            transform.position = candidates[validInd];
+        }
+    }
+}
+
+bool MovementSystem::Push(Entity person, sf::Vector2f const offset)
+{
+    Transform& transform = _registry->GetComponent<Transform>(person);
+    sf::Vector2f const nextPosition = transform.position + offset;
+    if (IsPositionValid(person, nextPosition))
+    {
+        transform.position = nextPosition;
+        return true;
+    }
+    return false;
+}
+
+bool MovementSystem::MoveToNearestValidPosition(Entity person)
+{
+    // Searching on rings of growing radius around the current position, with samples about a collision radius apart
+    Transform& transform = _registry->GetComponent<Transform>(person);
+    sf::Vector2f const origin = transform.position;
+    float const step = std::max(_registry->GetComponent<Collider>(person).radius, 1.f);
+    sf::Vector2f const worldSize = _world->GetSize();
+    int const ringsCount = (int)std::ceil(std::hypot(worldSize.x, worldSize.y) / step);
+
+    for (int ring = 1; ring <= ringsCount; ring++)
+    {
+        int const samplesCount = 8 * ring;
+        for (int sample = 0; sample < samplesCount; sample++)
+        {
+            float const angle = 2.f * M_PI * sample / samplesCount;
+            sf::Vector2f const candidate = origin + ring * step * sf::Vector2f(std::cos(angle), std::sin(angle));
+            if (IsPositionValid(person, candidate))
+            {
+                transform.position = candidate;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void MovementSystem::Rescale(sf::Vector2f const scale)
+{
+    ComponentArray<Collider>& colliders = _registry->GetComponents<Collider>();
+    for (int i = 0; i < colliders.GetSize(); i++)
+    {
+        Entity const person = colliders.GetEntityAt(i);
+
+        // Speed is relative to the view's width
+        _registry->GetComponent<Velocity>(person).speed *= scale.x;
+
+        // The collision radius reaches the corner of the head, so it grows like the head's diagonal
+        Sprite const& head = _registry->GetComponent<Sprite>(person);
+        if (head.texture != nullptr)
+        {
+            sf::Vector2f const headSize(head.texture->getSize().x * head.scale.x, head.texture->getSize().y * head.scale.y);
+            colliders.GetAt(i).radius *= std::hypot(headSize.x * scale.x, headSize.y * scale.y) / std::hypot(headSize.x, headSize.y);
+        }
+    }
+}
+
+bool MovementSystem::IsPositionInWorld(Collider const& collider, sf::Vector2f const position) const
+{
+    return (position.x + collider.radius < _world->GetSize().x
+        && position.x - collider.radius >= 0
+        && position.y + collider.radius < _world->GetSize().y
+        && position.y - collider.radius >= 0);
+}
+
+bool MovementSystem::IsPositionOutsideWalls(Collider const& collider, sf::Vector2f const currentPosition, sf::Vector2f const position) const
+{
+    /* Only the walls listed in the grid cells under the collision circle can intersect it.
+       The grid lists walls by their bounding circles, so it also has every circle that can intersect it. */
+    Broadphase::Box const box = {
+        position.x - collider.radius, position.x + collider.radius,
+        position.y - collider.radius, position.y + collider.radius
+    };
+    return _world->GetWallGrid().VisitWallsInBox(box, [this, &collider, currentPosition, position](int wallInd) -> bool {
+        return collider.coarse
+            ? IsPositionOutsideWallCoarse(collider, currentPosition, position, wallInd)
+            : IsPositionOutsideWall(collider, position, wallInd);
+    });
+}
+
+bool MovementSystem::IsPositionOutsideWallCoarse(
+    Collider const& collider,
+    sf::Vector2f const currentPosition,
+    sf::Vector2f const position,
+    int wallInd) const
+{
+    World::Circle const& circle = _world->GetWallBoundingCircles()[wallInd];
+    float const minDist = circle.radius + collider.radius;
+
+    // If the person is already within the bounding circle, it has to be checked exactly
+    if (GeometryUtils::CalcDist(currentPosition, circle.center) <= minDist)
+    {
+        return IsPositionOutsideWall(collider, position, wallInd);
+    }
+    return GeometryUtils::CalcDist(position, circle.center) > minDist;
+}
+
+int MovementSystem::FindFirstValidPosition(Entity person, std::pmr::vector<sf::Vector2f> const& positions) const
+{
+    if (positions.empty())
+    {
+        return -1;
+    }
+
+    Collider const& collider = _registry->GetComponent<Collider>(person);
+    sf::Vector2f const currentPosition = _registry->GetComponent<Transform>(person).position;
+
+    Broadphase::Box box = { positions[0].x, positions[0].x, positions[0].y, positions[0].y };
+    for (int i = 1; i < positions.size(); i++)
+    {
+        box.minX = std::min(box.minX, positions[i].x);
+        box.maxX = std::max(box.maxX, positions[i].x);
+        box.minY = std::min(box.minY, positions[i].y);
+        box.maxY = std::max(box.maxY, positions[i].y);
+    }
+    box.minX -= collider.radius;
+    box.maxX += collider.radius;
+    box.minY -= collider.radius;
+    box.maxY += collider.radius;
+
+    std::pmr::vector<int> nearWalls(_world->GetFrameMemory());
+    _world->GetWallGrid().FindWallsInBox(box, nearWalls);
+
+    for (int i = 0; i < positions.size(); i++)
+    {
+        if (!IsPositionInWorld(collider, positions[i]))
+        {
+            continue;
+        }
+        bool valid = true;
+        for (int j = 0; j < nearWalls.size() && valid; j++)
+        {
+            valid = collider.coarse
+                ? IsPositionOutsideWallCoarse(collider, currentPosition, positions[i], nearWalls[j])
+                : IsPositionOutsideWall(collider, positions[i], nearWalls[j]);
+        }
+        if (valid)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+bool MovementSystem::IsPositionOutsideWall(Collider const& collider, sf::Vector2f const position, int wallInd) const
+{
+    /* The collision circle is in the wall if an edge of the wall intersects it,
+        or if it is completely inside the wall, which happens to positions placed in a generated map,
+        and to positions that "jump" over an edge when the speed is much more than the collision radius */
+    WallEdgeTable const& wallEdges = _world->GetWallEdges();
+    return !wallEdges.CircleIntersectsWall(wallInd, position, collider.radius)
+        && !wallEdges.IsPointInsideWall(wallInd, position);
+}
+
+} // namespace HideAndSeekAndShoot
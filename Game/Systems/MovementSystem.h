@@ -0,0 +1,217 @@
+#pragma once
+
+#include "../Ecs/Components.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <memory_resource>
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+class World;
+
+/**
+ * System moving people - entities with a transform, a velocity and a collider - so that they keep within the world
+ * and don't collide with walls. People move with a constant speed, in a direction or towards a point,
+ * and go as close to the walls in their way as their movement precision allows.
+ */
+class MovementSystem
+{
+
+  public:
+
+    /**
+     * Creates the system
+     * 
+     * @param[in] world
+     *  Pointer to the world whose people are moved, for its size and its walls
+     * @param[in] registry
+     *  Pointer to the registry of the world's entities
+     */
+    MovementSystem(World const* world, EntityRegistry* registry);
+
+    /**
+     * Checks if a position is valid for a person,
+     * meaning that the person is inside the world's borders
+     * and it does not intersect with any walls.
+     * 
+     * @param[in] person
+     *  The person
+     * @param[in] position
+     *  Position to check
+     * 
+     * @return true for valid position, false for invalid
+     */
+    bool IsPositionValid(Entity person, sf::Vector2f const position) const;
+
+    /**
+     * Moves a person in the given direction with its speed.
+     * People have constant speed and so only a direction
+     * can be specified for their movement.
+     * 
+     * @param[in] person
+     *  The person
+     * @param[in] dirVector
+     *  Vector specifying the direction of the movement.
+     *  Not to be confused with velocity vector.
+     *  The length of this vector doesn't matter, only its direction.
+     */
+    void MoveInDirection(Entity person, sf::Vector2f const dirVector);
+
+    /**
+     * Moves a person towards a target point with its speed.
+     * If there is an obstacle in the way, the person will try to go around it.
+     * The way the person tries to go around object is a little simplistic.
+     * (I will probably implement Dijkstra, or better yet A*, in the future,
+     *  but it will be too computationally intense if it's on a graph of each pixel.
+     *  It will have to choose some sparse pixel grid, for example taking every 10-th pixel.)
+     * If the person cannot go directly in the target direction,
+     * he will choose a valid direction closest to the target direction and go to it.
+     * It does that by trying d + phi, d - phi, d + 2phi, d - 2phi, d + 3phi, d - 3phi, ...
+     * (where d is the direction towards the target point and phi is some tiny angle)
+     * until it finds a direction it can go to.
+     * In practice this works fine for small enough phi,
+     * and also it has a maybe positive side effect:
+     * The movement of the person, when going around obstacles,
+     * is not choosing the best path, but at each point choosing the best direction to go to,
+     * based only on the direction of the target point, and not its absolute position.
+     * Which is cool because it looks more like the person does not see the target point itself
+     * (which makes sense because obviously the target point is blocked out of view)
+     * but knows its general direction.
+     * 
+     * @param[in] person
+     *  The person
+     * @param[in] targetPoint
+     *  Point towards which the person will move.
+     * @param[in] speedScale (optional)
+     *  How many times the person's speed to move with.
+     *  Used when the person is updated once in a few frames, to move as much as it would in those frames.
+     */
+    void MoveTowards(Entity person, sf::Vector2f const targetPoint, float speedScale = 1.f);
+
+    /**
+     * Pushes a person by an offset, if it gets to a valid position that way.
+     * Used for separating people that overlap each other.
+     * 
+     * @param[in] person
+     *  The person
+     * @param[in] offset
+     *  Offset by which to push the person
+     * 
+     * @return true if the person was pushed, false if it stays where it was
+     */
+    bool Push(Entity person, sf::Vector2f const offset);
+
+    /**
+     * Moves a person to the nearest valid position it can find around its current position.
+     * Meant for spawning, when the configured position can end up inside a wall of a generated map.
+     * 
+     * @param[in] person
+     *  The person
+     * 
+     * @return true if a valid position was found, false if the person stays where it was
+     */
+    bool MoveToNearestValidPosition(Entity person);
+
+    /**
+     * Scales the speeds and collision radii of all the people, when the world is resized.
+     * The radii are calculated again from the sizes of the people's sprites, so the sprites have to be rescaled before.
+     * 
+     * @param[in] scale
+     *  Ratio of the world's new size to its old size, for each axis
+     */
+    void Rescale(sf::Vector2f const scale);
+
+  private: /* functions */
+
+    /**
+     * Checks if a position is within the borders of the world
+     * 
+     * @param[in] collider
+     *  Collider of the person
+     * @param[in] position
+     *  Position to check
+     * 
+     * @return true for inside world, false otherwise
+     */
+    bool IsPositionInWorld(Collider const& collider, sf::Vector2f const position) const;
+
+    /**
+     * Checks if a position is outside of all the walls,
+     * meaning that there is no point lying inside the person's collision circle and inside a wall.
+     * Coarse collisions check the walls' bounding circles instead,
+     * except for the ones that the person is currently in, which are checked exactly,
+     * so that switching to coarse collisions near a wall doesn't get the person stuck.
+     * 
+     * @param[in] collider
+     *  Collider of the person
+     * @param[in] currentPosition
+     *  Position of the person
+     * @param[in] position
+     *  Position to check
+     * 
+     * @return true for outside walls, false if there is an intersection with a wall
+     */
+    bool IsPositionOutsideWalls(Collider const& collider, sf::Vector2f const currentPosition, sf::Vector2f const position) const;
+
+    /**
+     * Checks if a position is outside of a single wall, exactly.
+     * 
+     * @param[in] collider
+     *  Collider of the person
+     * @param[in] position
+     *  Position to check
+     * @param[in] wallInd
+     *  Index of the wall to check against
+     * 
+     * @return true for outside the wall, false if there is an intersection with it
+     */
+    bool IsPositionOutsideWall(Collider const& collider, sf::Vector2f const position, int wallInd) const;
+
+    /**
+     * Checks if a position is outside of a single wall's bounding circle,
+     * or outside of the wall exactly if the person is currently in the circle.
+     * 
+     * @param[in] collider
+     *  Collider of the person
+     * @param[in] currentPosition
+     *  Position of the person
+     * @param[in] position
+     *  Position to check
+     * @param[in] wallInd
+     *  Index of the wall to check against
+     * 
+     * @return true for outside the wall, false if there is an intersection with it
+     */
+    bool IsPositionOutsideWallCoarse(
+        Collider const& collider,
+        sf::Vector2f const currentPosition,
+        sf::Vector2f const position,
+        int wallInd
+    ) const;
+
+    /**
+     * Finds the first valid position for a person out of a few positions near each other, in a single query.
+     * The walls near the positions are found once, and then each position is checked only against them.
+     * 
+     * @param[in] person
+     *  The person
+     * @param[in] positions
+     *  Positions to check, in the order of preference
+     * 
+     * @return index of the first valid position, or -1 if none of them is valid
+     */
+    int FindFirstValidPosition(Entity person, std::pmr::vector<sf::Vector2f> const& positions) const;
+
+  private: /* variables */
+
+    /// The world whose people are moved
+    World const* _world;
+
+    /// Registry of the world's entities
+    EntityRegistry* _registry;
+};
+
+} // namespace HideAndSeekAndShoot
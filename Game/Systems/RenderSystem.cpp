@@ -0,0 +1,148 @@
+#define VISUAL_DEBUG 0
+
+#include "RenderSystem.h"
+
+#include "../RenderSnapshot.h"
+
+#include "../utils/geometryUtils.hpp"
+
+namespace HideAndSeekAndShoot
+{
+
+RenderSystem::RenderSystem(EntityRegistry const* registry)
+    : _registry(registry),
+    _player(-1)
+{}
+
+void RenderSystem::SetPlayer(Entity player)
+{
+    _player = player;
+}
+
+void RenderSystem::Draw(sf::RenderTarget& target, sf::RenderStates states, sf::FloatRect const& viewRect) const
+{
+    ComponentArray<AiState> const& enemies = _registry->GetComponents<AiState>();
+    for (int i = 0; i < enemies.GetSize(); i++)
+    {
+        Entity const enemy = enemies.GetEntityAt(i);
+        if (enemies.GetAt(i).lodTier != LodTier::Dormant && GetPersonBounds(enemy).intersects(viewRect))
+        {
+            DrawPerson(target, states, enemy);
+        }
+    }
+    DrawPerson(target, states, _player);
+
+    ComponentArray<Trajectory> const& bullets = _registry->GetComponents<Trajectory>();
+    for (int i = 0; i < bullets.GetSize(); i++)
+    {
+        sf::Sprite const sprite = MakeSprite(bullets.GetEntityAt(i));
+        if (sprite.getGlobalBounds().intersects(viewRect))
+        {
+            target.draw(sprite, states);
+        }
+    }
+}
+
+void RenderSystem::AddToSnapshot(RenderSnapshot& snapshot, sf::FloatRect const& viewRect) const
+{
+    ComponentArray<AiState> const& enemies = _registry->GetComponents<AiState>();
+    for (int i = 0; i < enemies.GetSize(); i++)
+    {
+        Entity const enemy = enemies.GetEntityAt(i);
+        if (enemies.GetAt(i).lodTier != LodTier::Dormant && GetPersonBounds(enemy).intersects(viewRect))
+        {
+            AddPersonToSnapshot(snapshot, enemy);
+        }
+    }
+    AddPersonToSnapshot(snapshot, _player);
+
+    ComponentArray<Trajectory> const& bullets = _registry->GetComponents<Trajectory>();
+    for (int i = 0; i < bullets.GetSize(); i++)
+    {
+        sf::Sprite const sprite = MakeSprite(bullets.GetEntityAt(i));
+        if (sprite.getGlobalBounds().intersects(viewRect))
+        {
+            snapshot.AddSprite(sprite);
+        }
+    }
+}
+
+sf::Sprite RenderSystem::MakeSprite(Sprite const& sprite, Transform const& transform)
+{
+    sf::Sprite sfSprite;
+    if (sprite.texture != nullptr)
+    {
+        sfSprite.setTexture(*sprite.texture);
+        // The sprite's origin is its center, instead of the upper-left corner
+        sfSprite.setOrigin(
+            sfSprite.getLocalBounds().width / 2,
+            sfSprite.getLocalBounds().height / 2
+        );
+    }
+    sfSprite.setScale(sprite.scale);
+    sfSprite.setPosition(transform.position);
+    sfSprite.setRotation(transform.rotation);
+    return sfSprite;
+}
+
+sf::Sprite RenderSystem::MakeSprite(Entity entity) const
+{
+    return MakeSprite(_registry->GetComponent<Sprite>(entity), _registry->GetComponent<Transform>(entity));
+}
+
+sf::FloatRect RenderSystem::GetPersonBounds(Entity person) const
+{
+    sf::FloatRect const bounds = GeometryUtils::UniteRects(
+        MakeSprite(person).getGlobalBounds(),
+        MakeSprite(_registry->GetComponent<Weapon>(person).gun).getGlobalBounds()
+    );
+    if (IsFieldOfViewTraced(person))
+    {
+        return GeometryUtils::UniteRects(bounds, _registry->GetComponent<FieldOfView>(person).GetBounds());
+    }
+    return bounds;
+}
+
+bool RenderSystem::IsFieldOfViewTraced(Entity person) const
+{
+    ComponentArray<AiState> const& states = _registry->GetComponents<AiState>();
+    return states.Has(person) && states.Get(person).lodTier == LodTier::Full;
+}
+
+void RenderSystem::DrawPerson(sf::RenderTarget& target, sf::RenderStates states, Entity person) const
+{
+    if (IsFieldOfViewTraced(person))
+    {
+        target.draw(_registry->GetComponent<FieldOfView>(person), states);
+    }
+
+    target.draw(MakeSprite(person), states);
+
+#if VISUAL_DEBUG == 1
+    // Visual debugging to see the collision circle
+    float const collisionRadius = _registry->GetComponent<Collider>(person).radius;
+    sf::CircleShape circle(collisionRadius);
+    circle.setOrigin(collisionRadius, collisionRadius);
+    circle.setPosition(_registry->GetComponent<Transform>(person).position);
+    circle.setFillColor(sf::Color::Transparent);
+    circle.setOutlineColor(sf::Color(255, 0, 0, 150));
+    circle.setOutlineThickness(2.f);
+
+    target.draw(circle, states);
+#endif
+
+    target.draw(MakeSprite(_registry->GetComponent<Weapon>(person).gun), states);
+}
+
+void RenderSystem::AddPersonToSnapshot(RenderSnapshot& snapshot, Entity person) const
+{
+    if (IsFieldOfViewTraced(person))
+    {
+        _registry->GetComponent<FieldOfView>(person).AddToSnapshot(snapshot);
+    }
+
+    snapshot.AddSprite(MakeSprite(person));
+    snapshot.AddSprite(MakeSprite(_registry->GetComponent<Weapon>(person).gun));
+}
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "../Ecs/Components.h"
+
+#include <SFML/Graphics.hpp>
+
+namespace HideAndSeekAndShoot
+{
+
+class RenderSnapshot;
+
+/**
+ * System drawing the entities - the enemies with their fields of view, the player, and the bullets, in that order.
+ * Each person is drawn as its head and its gun, and only the entities whose bounds are in the view are drawn,
+ * so the cost of drawing doesn't grow with the world's size. Dormant enemies are far away from the player,
+ * so they are not drawn at all, and the fields of view are drawn only for the enemies simulated in full detail.
+ */
+class RenderSystem
+{
+
+  public:
+
+    /**
+     * Creates the system
+     * 
+     * @param[in] registry
+     *  Pointer to the registry of the world's entities
+     */
+    explicit RenderSystem(EntityRegistry const* registry);
+
+    /// Sets the player, who is drawn on top of the enemies
+    void SetPlayer(Entity player);
+
+    /**
+     * Draws the entities in a view on a render target
+     * 
+     * @param[in] target
+     *  Render target on which to draw the entities
+     * @param[in] states
+     *  States/mode of the rendering
+     * @param[in] viewRect
+     *  Rectangle of the world seen in the target's view
+     */
+    void Draw(sf::RenderTarget& target, sf::RenderStates states, sf::FloatRect const& viewRect) const;
+
+    /**
+     * Adds the entities in a view to a render snapshot, in the same order as they are drawn
+     * 
+     * @param[out] snapshot
+     *  Snapshot to add the entities to
+     * @param[in] viewRect
+     *  Rectangle of the world seen in the snapshot's view
+     */
+    void AddToSnapshot(RenderSnapshot& snapshot, sf::FloatRect const& viewRect) const;
+
+    /**
+     * Makes the SFML sprite of a sprite component at a transform, centered at its position
+     * 
+     * @param[in] sprite
+     *  The sprite component
+     * @param[in] transform
+     *  The transform
+     * 
+     * @return the SFML sprite
+     */
+    static sf::Sprite MakeSprite(Sprite const& sprite, Transform const& transform);
+
+  private: /* functions */
+
+    /// Makes the SFML sprite of an entity with a transform and a sprite
+    sf::Sprite MakeSprite(Entity entity) const;
+
+    /// Returns the rectangle containing a person's head and gun, and its field of view if it is traced
+    sf::FloatRect GetPersonBounds(Entity person) const;
+
+    /// Returns whether a person's field of view is traced, which is when it is an enemy simulated in full detail
+    bool IsFieldOfViewTraced(Entity person) const;
+
+    /**
+     * Draws a person - its field of view if it is traced, its head and its gun
+     * 
+     * @param[in] target
+     *  Render target on which to draw the person
+     * @param[in] states
+     *  States/mode of the rendering
+     * @param[in] person
+     *  The person
+     */
+    void DrawPerson(sf::RenderTarget& target, sf::RenderStates states, Entity person) const;
+
+    /**
+     * Adds a person - its field of view if it is traced, its head and its gun - to a render snapshot
+     * 
+     * @param[out] snapshot
+     *  Snapshot to add the person to
+     * @param[in] person
+     *  The person
+     */
+    void AddPersonToSnapshot(RenderSnapshot& snapshot, Entity person) const;
+
+  private: /* variables */
+
+    /// Registry of the world's entities
+    EntityRegistry const* _registry;
+
+    /// The player
+    Entity _player;
+};
+
+} // namespace HideAndSeekAndShoot
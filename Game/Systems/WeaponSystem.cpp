@@ -0,0 +1,101 @@
+#include "WeaponSystem.h"
+
+#include "BulletSystem.h"
+
+#include "../utils/geometryUtils.hpp"
+
+#include <cmath>
+
+namespace HideAndSeekAndShoot
+{
+
+WeaponSystem::WeaponSystem(EntityRegistry* registry, BulletSystem* bulletSystem)
+    : _registry(registry),
+    _bulletSystem(bulletSystem)
+{}
+
+void WeaponSystem::PointAtTarget(Entity person)
+{
+    Transform& personTransform = _registry->GetComponent<Transform>(person);
+    sf::Vector2f const targetPoint = _registry->GetComponent<Aim>(person).targetPoint;
+    Weapon const& weapon = _registry->GetComponent<Weapon>(person);
+    Transform& gunTransform = _registry->GetComponent<Transform>(weapon.gun);
+
+    PointTowards(personTransform, targetPoint);
+    PointTowards(gunTransform, targetPoint);
+
+    // Direction vector of where the person is looking at
+    sf::Vector2f lookDir = GeometryUtils::GetVector(
+        personTransform.position,
+        targetPoint
+    );
+
+    // The vector from person to gun should be perpendicular to where the person is looking at
+    sf::Vector2f personToGunNormalVector = sf::Vector2f(
+        -lookDir.y,
+        lookDir.x
+    );
+    personToGunNormalVector = GeometryUtils::NormaliseVector(personToGunNormalVector);
+
+    // The gun should be positioned some contant distance away from the person, in the perpendicular direction
+    gunTransform.position = personTransform.position
+        + personToGunNormalVector * weapon.gunDistance;
+}
+
+void WeaponSystem::Shoot(Entity person)
+{
+    Weapon const weapon = _registry->GetComponent<Weapon>(person);
+    sf::Vector2f const gunPosition = _registry->GetComponent<Transform>(weapon.gun).position;
+    _bulletSystem->Spawn(
+        gunPosition,
+        GeometryUtils::GetVector(
+            gunPosition,
+            _registry->GetComponent<Aim>(person).targetPoint
+        ),
+        weapon
+    );
+}
+
+void WeaponSystem::Rescale(sf::Vector2f const scale)
+{
+    ComponentArray<Weapon>& weapons = _registry->GetComponents<Weapon>();
+    for (int i = 0; i < weapons.GetSize(); i++)
+    {
+        // Distance from the person is relative to the person's head width, and the bullets' size and speed to the view
+        Weapon& weapon = weapons.GetAt(i);
+        weapon.gunDistance *= scale.x;
+        weapon.bulletScale = sf::Vector2f(weapon.bulletScale.x * scale.x, weapon.bulletScale.y * scale.y);
+        weapon.bulletSpeed *= scale.x;
+    }
+
+    // Target points are in the world, so they scale like the positions
+    ComponentArray<Aim>& aims = _registry->GetComponents<Aim>();
+    for (int i = 0; i < aims.GetSize(); i++)
+    {
+        sf::Vector2f& targetPoint = aims.GetAt(i).targetPoint;
+        targetPoint = sf::Vector2f(targetPoint.x * scale.x, targetPoint.y * scale.y);
+    }
+}
+
+void WeaponSystem::PointTowards(Transform& transform, sf::Vector2f const targetPoint)
+{
+    // There is no direction to point to if the target point is exactly at the entity
+    if (targetPoint == transform.position)
+    {
+        return;
+    }
+
+    // Get normal direction vector from the entity to the target point
+    sf::Vector2f dirVector = GeometryUtils::NormaliseVector(
+        transform.position - targetPoint);
+
+    float angle = acos(dirVector.x);
+    if (dirVector.y < 0)
+    {
+        angle = -angle;
+    }
+
+    transform.rotation = angle * 180.f / M_PI;
+}
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../Ecs/Components.h"
+
+#include <SFML/Graphics.hpp>
+
+namespace HideAndSeekAndShoot
+{
+
+class BulletSystem;
+
+/**
+ * System pointing people and their guns towards their target points, and shooting bullets from the guns.
+ * A person - an entity with a transform, an aim and a weapon - has its gun as a separate entity,
+ * which is kept at the person's side, at a constant distance perpendicular to where the person looks.
+ */
+class WeaponSystem
+{
+
+  public:
+
+    /**
+     * Creates the system
+     * 
+     * @param[in] registry
+     *  Pointer to the registry of the world's entities
+     * @param[in] bulletSystem
+     *  Pointer to the system of the bullets, which creates the bullets that are shot
+     */
+    WeaponSystem(EntityRegistry* registry, BulletSystem* bulletSystem);
+
+    /**
+     * Points a person and its gun towards the person's target point, and places the gun at the person's side.
+     * Has to be done whenever the person moves or changes its target point, for the gun to follow it.
+     * 
+     * @param[in] person
+     *  The person
+     */
+    void PointAtTarget(Entity person);
+
+    /**
+     * Shoots a bullet from a person's gun towards the person's target point
+     * 
+     * @param[in] person
+     *  The person
+     */
+    void Shoot(Entity person);
+
+    /**
+     * Scales the people's target points, the distances of the guns from their people,
+     * and the size and speed of the bullets they shoot, when the world is resized
+     * 
+     * @param[in] scale
+     *  Ratio of the world's new size to its old size, for each axis
+     */
+    void Rescale(sf::Vector2f const scale);
+
+  private: /* functions */
+
+    /**
+     * Rotates an entity so that it points towards a target point
+     * 
+     * @param[in,out] transform
+     *  Transform of the entity
+     * @param[in] targetPoint
+     *  Point towards which the entity will be pointed
+     */
+    static void PointTowards(Transform& transform, sf::Vector2f const targetPoint);
+
+  private: /* variables */
+
+    /// Registry of the world's entities
+    EntityRegistry* _registry;
+
+    /// System of the bullets
+    BulletSystem* _bulletSystem;
+};
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,51 @@
+#include "TimingWheel.h"
+
+#include <algorithm>
+
+namespace HideAndSeekAndShoot
+{
+
+TimingWheel::TimingWheel(int bucketsCount)
+    : _freeEvents(-1),
+    _bucketHeads(std::max(bucketsCount, 1), -1),
+    _bucketTails(std::max(bucketsCount, 1), -1)
+{}
+
+void TimingWheel::Reserve(int eventsCount)
+{
+    _events.reserve(eventsCount);
+}
+
+void TimingWheel::Schedule(int id, int tick)
+{
+    int eventInd = _freeEvents;
+    if (eventInd >= 0)
+    {
+        _freeEvents = _events[eventInd].next;
+    }
+    else
+    {
+        eventInd = _events.size();
+        _events.push_back(Event());
+    }
+
+    _events[eventInd].id = id;
+    _events[eventInd].tick = tick;
+    Append(tick % _bucketHeads.size(), eventInd);
+}
+
+void TimingWheel::Append(int bucketInd, int eventInd)
+{
+    _events[eventInd].next = -1;
+    if (_bucketTails[bucketInd] >= 0)
+    {
+        _events[_bucketTails[bucketInd]].next = eventInd;
+    }
+    else
+    {
+        _bucketHeads[bucketInd] = eventInd;
+    }
+    _bucketTails[bucketInd] = eventInd;
+}
+
+} // namespace HideAndSeekAndShoot
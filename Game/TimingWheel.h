@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * A timing wheel of events scheduled at future ticks, each identified by an integer.
+ * The wheel has a bucket for each of a fixed number of ticks, and an event is put in the bucket of its tick
+ * modulo that number, so scheduling an event and taking the events of a tick cost only as much as the events in one bucket.
+ * Events further ahead than a turn of the wheel just stay in their bucket until their tick comes.
+ * 
+ * Events cannot be cancelled. Instead, whoever takes them checks whether they are still due,
+ * and an event is rescheduled by scheduling it again.
+ * The events of all the buckets share a single pool, linked into a list for each bucket,
+ * and taken events are reused, so once the pool has room for the most events ever waiting, scheduling doesn't allocate.
+ */
+class TimingWheel
+{
+
+  public:
+
+    /**
+     * Creates a wheel
+     * 
+     * @param[in] bucketsCount
+     *  Number of ticks in a turn of the wheel
+     */
+    explicit TimingWheel(int bucketsCount);
+
+    /**
+     * Reserves room for a number of events waiting at once, so that scheduling them doesn't allocate
+     * 
+     * @param[in] eventsCount
+     *  Number of events
+     */
+    void Reserve(int eventsCount);
+
+    /**
+     * Schedules an event
+     * 
+     * @param[in] id
+     *  Identifier of the event
+     * @param[in] tick
+     *  Tick at which the event is due, which has to be after the last tick whose events were taken
+     */
+    void Schedule(int id, int tick);
+
+    /**
+     * Takes the events due at a tick out of the wheel, visiting each of them.
+     * The visitor must not schedule events in the same bucket.
+     * 
+     * @param[in] tick
+     *  The tick. Every tick should be taken in turn, as events of skipped ticks are dropped when their bucket comes again.
+     * @param[in] visitor
+     *  Function taking an event's identifier
+     */
+    template <typename Visitor>
+    void TakeDue(int tick, Visitor visitor)
+    {
+        // The bucket's list is taken whole, and the events due later are put back in it, in order
+        int const bucketInd = tick % _bucketHeads.size();
+        int eventInd = _bucketHeads[bucketInd];
+        _bucketHeads[bucketInd] = -1;
+        _bucketTails[bucketInd] = -1;
+        while (eventInd >= 0)
+        {
+            Event const event = _events[eventInd];
+            if (event.tick > tick)
+            {
+                Append(bucketInd, eventInd);
+            }
+            else
+            {
+                _events[eventInd].next = _freeEvents;
+                _freeEvents = eventInd;
+            }
+            if (event.tick == tick)
+            {
+                visitor(event.id);
+            }
+            eventInd = event.next;
+        }
+    }
+
+  private: /* types */
+
+    /// A scheduled event, in the pool
+    struct Event
+    {
+        int id;
+        int tick;
+        /// Index of the next event in the same bucket, or of the next free event, -1 for none
+        int next;
+    };
+
+  private: /* functions */
+
+    /// Links an event of the pool to the end of a bucket's list
+    void Append(int bucketInd, int eventInd);
+
+  private: /* variables */
+
+    /// Pool of the events, both scheduled and free
+    std::vector<Event> _events;
+    /// Index of the first free event in the pool, -1 if there is none
+    int _freeEvents;
+    /// For each bucket, index of its first and last events, -1 if it is empty
+    std::vector<int> _bucketHeads, _bucketTails;
+};
+
+} // namespace HideAndSeekAndShoot
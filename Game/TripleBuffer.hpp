@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * Three buffers for passing data from a producer thread to a consumer thread,
+ * without either of them ever waiting for the other to finish with a buffer.
+ * The producer fills the write buffer and publishes it, the consumer acquires the latest published buffer and reads it,
+ * and the third buffer holds the latest published data, until the consumer takes it or the producer replaces it.
+ * Buffers are swapped, never copied.
+ * 
+ * @tparam T
+ *  Type of the data in each buffer
+ */
+template <typename T>
+class TripleBuffer
+{
+
+  public:
+
+    /// Returns the buffer that the producer fills. Only the producer can use it.
+    T& GetWriteBuffer()
+    {
+        return _buffers[_writeInd];
+    }
+
+    /// Publishes the filled write buffer, replacing any published data not yet acquired. Called by the producer.
+    void Publish()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::swap(_writeInd, _publishedInd);
+        _hasPublished = true;
+    }
+
+    /**
+     * Takes the latest published data as the read buffer, if there is new one. Called by the consumer.
+     * 
+     * @return true if the read buffer was replaced with new data, false if it stays the same
+     */
+    bool Acquire()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_hasPublished)
+        {
+            return false;
+        }
+        std::swap(_readInd, _publishedInd);
+        _hasPublished = false;
+        return true;
+    }
+
+    /// Returns the buffer that the consumer reads. Only the consumer can use it.
+    T const& GetReadBuffer() const
+    {
+        return _buffers[_readInd];
+    }
+
+  private: /* variables */
+
+    /// The three buffers
+    std::array<T, 3> _buffers;
+
+    /// Indices of the buffers that are currently being written, published and read
+    int _writeInd = 0, _publishedInd = 1, _readInd = 2;
+
+    /// Whether the published buffer has new data that the consumer has not acquired yet
+    bool _hasPublished = false;
+
+    /// Mutex protecting the published buffer's index
+    std::mutex _mutex;
+};
+
+} // namespace HideAndSeekAndShoot
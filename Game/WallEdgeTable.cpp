@@ -0,0 +1,372 @@
+#include "WallEdgeTable.h"
+
+#include "utils/geometryUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace HideAndSeekAndShoot
+{
+
+void WallEdgeTable::Build(std::vector<sf::ConvexShape> const& walls, std::vector<int> const& wallPolygonInds)
+{
+    for (std::vector<float>* array : {
+            &_startX, &_startY, &_endX, &_endY, &_dirX, &_dirY, &_invLengthSq, &_normalX, &_normalY,
+            &_wallMinX, &_wallMinY, &_wallMaxX, &_wallMaxY, &_sideNormalX, &_sideNormalY, &_sideOffset })
+    {
+        array->clear();
+    }
+    _wallEdgesBegin.clear();
+    _wallSidesBegin.clear();
+
+    /* An edge is inner if another part of the same polygon has the same edge in the opposite direction.
+       Only the parts next to the wall are searched, so that building stays linear in the number of walls. */
+    auto isInnerEdge = [&walls, &wallPolygonInds](int wallInd, sf::Vector2f const A, sf::Vector2f const B) -> bool {
+        int firstInd = wallInd;
+        while (firstInd > 0 && wallPolygonInds[firstInd - 1] == wallPolygonInds[wallInd])
+        {
+            firstInd--;
+        }
+        for (int otherInd = firstInd; otherInd < walls.size() && wallPolygonInds[otherInd] == wallPolygonInds[wallInd]; otherInd++)
+        {
+            if (otherInd == wallInd)
+            {
+                continue;
+            }
+            sf::ConvexShape const& other = walls[otherInd];
+            for (int i = 0; i < other.getPointCount(); i++)
+            {
+                if (other.getPoint(i) == B && other.getPoint((i + 1) % other.getPointCount()) == A)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    for (int wallInd = 0; wallInd < walls.size(); wallInd++)
+    {
+        sf::ConvexShape const& wall = walls[wallInd];
+        int const pointCount = wall.getPointCount();
+        _wallEdgesBegin.push_back(_startX.size());
+        _wallSidesBegin.push_back(_sideOffset.size());
+
+        sf::Vector2f center(0.f, 0.f);
+        sf::FloatRect const bounds = wall.getGlobalBounds();
+        for (int i = 0; i < pointCount; i++)
+        {
+            center += wall.getPoint(i);
+        }
+        center /= (float)pointCount;
+        _wallMinX.push_back(bounds.left);
+        _wallMinY.push_back(bounds.top);
+        _wallMaxX.push_back(bounds.left + bounds.width);
+        _wallMaxY.push_back(bounds.top + bounds.height);
+
+        for (int i = 0; i < pointCount; i++)
+        {
+            sf::Vector2f const A = wall.getPoint(i);
+            sf::Vector2f const B = wall.getPoint((i + 1) % pointCount);
+            sf::Vector2f const dir = B - A;
+            float const lengthSq = dir.x * dir.x + dir.y * dir.y;
+            if (lengthSq == 0.f)
+            {
+                continue;
+            }
+
+            // Of the two normals, the outward one points away from the center of the convex wall
+            sf::Vector2f normal = sf::Vector2f(dir.y, -dir.x) / std::sqrt(lengthSq);
+            sf::Vector2f const fromCenter = (A + B) / 2.f - center;
+            if (normal.x * fromCenter.x + normal.y * fromCenter.y < 0.f)
+            {
+                normal = -normal;
+            }
+
+            // Inner edges still bound the wall, so every side is kept for the containment test
+            _sideNormalX.push_back(normal.x);
+            _sideNormalY.push_back(normal.y);
+            _sideOffset.push_back(normal.x * A.x + normal.y * A.y);
+            if (isInnerEdge(wallInd, A, B))
+            {
+                continue;
+            }
+
+            _startX.push_back(A.x);
+            _startY.push_back(A.y);
+            _endX.push_back(B.x);
+            _endY.push_back(B.y);
+            _dirX.push_back(dir.x);
+            _dirY.push_back(dir.y);
+            _invLengthSq.push_back(1.f / lengthSq);
+            _normalX.push_back(normal.x);
+            _normalY.push_back(normal.y);
+        }
+    }
+    _wallEdgesBegin.push_back(_startX.size());
+    _wallSidesBegin.push_back(_sideOffset.size());
+}
+
+int WallEdgeTable::GetEdgesCount() const
+{
+    return _startX.size();
+}
+
+bool WallEdgeTable::IsSegmentBlockedByWall(int wallInd, sf::Vector2f const pointA, sf::Vector2f const pointB) const
+{
+    if (!SegmentCrossesWallBox(wallInd, pointA, pointB))
+    {
+        return false;
+    }
+
+    sf::Vector2f const segment = pointB - pointA;
+    float fraction;
+    for (int edgeInd = _wallEdgesBegin[wallInd]; edgeInd < _wallEdgesBegin[wallInd + 1]; edgeInd++)
+    {
+        // A segment crossing a wall crosses one of its front facing edges, so back facing ones can be skipped
+        if (!IsBackFacing(edgeInd, segment) && Crosses(edgeInd, pointA, segment, fraction))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool WallEdgeTable::IsSegmentNearWall(int wallInd, sf::Vector2f const pointA, sf::Vector2f const pointB, float distance) const
+{
+    // The segment can't come near the wall if its box, grown by the distance, doesn't intersect the wall's box
+    if (std::max(pointA.x, pointB.x) + distance < _wallMinX[wallInd]
+        || std::min(pointA.x, pointB.x) - distance > _wallMaxX[wallInd]
+        || std::max(pointA.y, pointB.y) + distance < _wallMinY[wallInd]
+        || std::min(pointA.y, pointB.y) - distance > _wallMaxY[wallInd])
+    {
+        return false;
+    }
+
+    sf::Vector2f const segment = pointB - pointA;
+    float const segmentLengthSq = segment.x * segment.x + segment.y * segment.y;
+    float const distanceSq = distance * distance;
+    auto isNear = [distanceSq](sf::Vector2f const P, sf::Vector2f const Q) -> bool {
+        return (P.x - Q.x) * (P.x - Q.x) + (P.y - Q.y) * (P.y - Q.y) <= distanceSq;
+    };
+    auto closestOnSegment = [pointA, segment, segmentLengthSq](sf::Vector2f const P) -> sf::Vector2f {
+        if (segmentLengthSq == 0.f)
+        {
+            return pointA;
+        }
+        float const t = std::clamp(
+            ((P.x - pointA.x) * segment.x + (P.y - pointA.y) * segment.y) / segmentLengthSq,
+            0.f, 1.f
+        );
+        return pointA + t * segment;
+    };
+    float fraction;
+    for (int edgeInd = _wallEdgesBegin[wallInd]; edgeInd < _wallEdgesBegin[wallInd + 1]; edgeInd++)
+    {
+        // Two segments that don't cross are the closest at an end point of one of them
+        sf::Vector2f const start(_startX[edgeInd], _startY[edgeInd]);
+        sf::Vector2f const end(_endX[edgeInd], _endY[edgeInd]);
+        if (Crosses(edgeInd, pointA, segment, fraction)
+            || isNear(pointA, FindClosestPointOnEdge(edgeInd, pointA))
+            || isNear(pointB, FindClosestPointOnEdge(edgeInd, pointB))
+            || isNear(start, closestOnSegment(start))
+            || isNear(end, closestOnSegment(end)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int WallEdgeTable::FindNearestCrossing(sf::Vector2f const pointA, sf::Vector2f const pointB, float& fraction) const
+{
+    sf::Vector2f const segment = pointB - pointA;
+    int nearestEdgeInd = -1;
+    fraction = 1.f;
+    for (int wallInd = 0; wallInd + 1 < _wallEdgesBegin.size(); wallInd++)
+    {
+        FindNearestCrossingOfWall(wallInd, pointA, segment, nearestEdgeInd, fraction);
+    }
+
+    return nearestEdgeInd;
+}
+
+int WallEdgeTable::FindNearestCrossingAmong(
+    int const* wallIndsBegin,
+    int const* wallIndsEnd,
+    sf::Vector2f const pointA,
+    sf::Vector2f const pointB,
+    float& fraction) const
+{
+    // Same as FindNearestCrossing, only with the given walls, so both find the same edge when it is among them
+    sf::Vector2f const segment = pointB - pointA;
+    int nearestEdgeInd = -1;
+    fraction = 1.f;
+    for (int const* wallInd = wallIndsBegin; wallInd != wallIndsEnd; wallInd++)
+    {
+        FindNearestCrossingOfWall(*wallInd, pointA, segment, nearestEdgeInd, fraction);
+    }
+
+    return nearestEdgeInd;
+}
+
+bool WallEdgeTable::EdgeCrossesSegment(int edgeInd, sf::Vector2f const pointA, sf::Vector2f const pointB, float& fraction) const
+{
+    return Crosses(edgeInd, pointA, pointB - pointA, fraction);
+}
+
+bool WallEdgeTable::CircleIntersectsWall(int wallInd, sf::Vector2f const center, float const radius) const
+{
+    // The circle can't intersect the wall if its bounding square doesn't intersect the wall's bounding box
+    if (center.x + radius < _wallMinX[wallInd] || center.x - radius > _wallMaxX[wallInd]
+        || center.y + radius < _wallMinY[wallInd] || center.y - radius > _wallMaxY[wallInd])
+    {
+        return false;
+    }
+
+    float const radiusSq = radius * radius;
+    for (int edgeInd = _wallEdgesBegin[wallInd]; edgeInd < _wallEdgesBegin[wallInd + 1]; edgeInd++)
+    {
+        // Closest point to the center on the edge, as a fraction of the edge
+        float const toCenterX = center.x - _startX[edgeInd];
+        float const toCenterY = center.y - _startY[edgeInd];
+        float const t = std::clamp(
+            (toCenterX * _dirX[edgeInd] + toCenterY * _dirY[edgeInd]) * _invLengthSq[edgeInd],
+            0.f, 1.f
+        );
+        float const diffX = toCenterX - t * _dirX[edgeInd];
+        float const diffY = toCenterY - t * _dirY[edgeInd];
+        if (diffX * diffX + diffY * diffY <= radiusSq)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool WallEdgeTable::IsPointInsideWall(int wallInd, sf::Vector2f const point) const
+{
+    if (point.x < _wallMinX[wallInd] || point.x > _wallMaxX[wallInd]
+        || point.y < _wallMinY[wallInd] || point.y > _wallMaxY[wallInd])
+    {
+        return false;
+    }
+
+    // A point is inside a convex wall if it is behind every one of its sides
+    for (int sideInd = _wallSidesBegin[wallInd]; sideInd < _wallSidesBegin[wallInd + 1]; sideInd++)
+    {
+        if (_sideNormalX[sideInd] * point.x + _sideNormalY[sideInd] * point.y > _sideOffset[sideInd])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool WallEdgeTable::SegmentCrossesWallBox(int wallInd, sf::Vector2f const pointA, sf::Vector2f const pointB) const
+{
+    return GeometryUtils::SegmentIntersectsRect(
+        pointA,
+        pointB,
+        sf::FloatRect(
+            _wallMinX[wallInd],
+            _wallMinY[wallInd],
+            _wallMaxX[wallInd] - _wallMinX[wallInd],
+            _wallMaxY[wallInd] - _wallMinY[wallInd]
+        )
+    );
+}
+
+bool WallEdgeTable::Crosses(int edgeInd, sf::Vector2f const pointA, sf::Vector2f const segment, float& fraction) const
+{
+    // Solving pointA + fraction * segment = start + t * dir, for both fraction and t in [0, 1]
+    float const denom = segment.x * _dirY[edgeInd] - segment.y * _dirX[edgeInd];
+    if (denom == 0.f)
+    {
+        return false;
+    }
+
+    float const toStartX = _startX[edgeInd] - pointA.x;
+    float const toStartY = _startY[edgeInd] - pointA.y;
+    float const s = (toStartX * _dirY[edgeInd] - toStartY * _dirX[edgeInd]) / denom;
+    float const t = (toStartX * segment.y - toStartY * segment.x) / denom;
+    if (s < 0.f || s > 1.f || t < 0.f || t > 1.f)
+    {
+        return false;
+    }
+
+    fraction = s;
+    return true;
+}
+
+int WallEdgeTable::GetWallEdgesBegin(int wallInd) const
+{
+    return _wallEdgesBegin[wallInd];
+}
+
+int WallEdgeTable::GetWallEdgesEnd(int wallInd) const
+{
+    return _wallEdgesBegin[wallInd + 1];
+}
+
+sf::Vector2f WallEdgeTable::GetEdgeStart(int edgeInd) const
+{
+    return sf::Vector2f(_startX[edgeInd], _startY[edgeInd]);
+}
+
+sf::Vector2f WallEdgeTable::GetEdgeEnd(int edgeInd) const
+{
+    return sf::Vector2f(_endX[edgeInd], _endY[edgeInd]);
+}
+
+sf::Vector2f WallEdgeTable::GetEdgeNormal(int edgeInd) const
+{
+    return sf::Vector2f(_normalX[edgeInd], _normalY[edgeInd]);
+}
+
+sf::Vector2f WallEdgeTable::FindClosestPointOnEdge(int edgeInd, sf::Vector2f const point) const
+{
+    // Projecting the point on the edge's line, and clamping the projection to the edge
+    float const t = ((point.x - _startX[edgeInd]) * _dirX[edgeInd] + (point.y - _startY[edgeInd]) * _dirY[edgeInd])
+        * _invLengthSq[edgeInd];
+    float const clamped = std::min(std::max(t, 0.f), 1.f);
+    return sf::Vector2f(_startX[edgeInd] + clamped * _dirX[edgeInd], _startY[edgeInd] + clamped * _dirY[edgeInd]);
+}
+
+bool WallEdgeTable::IsBackFacing(int edgeInd, sf::Vector2f const segment) const
+{
+    return segment.x * _normalX[edgeInd] + segment.y * _normalY[edgeInd] > 0.f;
+}
+
+void WallEdgeTable::FindNearestCrossingOfWall(
+    int wallInd,
+    sf::Vector2f const pointA,
+    sf::Vector2f const segment,
+    int& nearestEdgeInd,
+    float& fraction) const
+{
+    // A wall can be crossed before the nearest crossing so far only if the segment up to it crosses the wall's box
+    if (!SegmentCrossesWallBox(wallInd, pointA, pointA + segment * fraction))
+    {
+        return;
+    }
+
+    float currFraction;
+    for (int edgeInd = _wallEdgesBegin[wallInd]; edgeInd < _wallEdgesBegin[wallInd + 1]; edgeInd++)
+    {
+        // Coming from outside of a wall, the segment first crosses one of its front facing edges
+        if (!IsBackFacing(edgeInd, segment)
+            && Crosses(edgeInd, pointA, segment, currFraction)
+            && currFraction <= fraction)
+        {
+            fraction = currFraction;
+            nearestEdgeInd = edgeInd;
+        }
+    }
+}
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * A flat table of the walls' edges, precomputed once whenever the walls are generated,
+ * so that geometric queries against the walls work on contiguous arrays of floats,
+ * instead of getting each wall's points from its shape again and again.
+ * Edges are stored as a structure of arrays, grouped by wall, and each wall has a bounding box.
+ * Edges that are inside of a wall, where a concave wall was split into convex parts, are left out,
+ * since anything outside of the walls reaches them only through an outer edge.
+ */
+class WallEdgeTable
+{
+
+  public:
+
+    /**
+     * Builds the table from the walls
+     * 
+     * @param[in] walls
+     *  The walls, which have to be convex
+     * @param[in] wallPolygonInds
+     *  For each wall, index of the polygon that it is a part of. Only edges between parts of the same polygon are inner,
+     *  and parts of the same polygon have to be next to each other.
+     */
+    void Build(std::vector<sf::ConvexShape> const& walls, std::vector<int> const& wallPolygonInds);
+
+    /// Returns the number of edges in the table
+    int GetEdgesCount() const;
+
+    /**
+     * Checks whether a segment crosses any of a wall's edges
+     * 
+     * @param[in] wallInd
+     *  Index of the wall
+     * @param[in] pointA, pointB
+     *  End points of the segment
+     * 
+     * @return true if an edge of the wall crosses the segment, false otherwise
+     */
+    bool IsSegmentBlockedByWall(int wallInd, sf::Vector2f const pointA, sf::Vector2f const pointB) const;
+
+    /**
+     * Checks whether any of a wall's edges comes within a distance of a segment
+     * 
+     * @param[in] wallInd
+     *  Index of the wall
+     * @param[in] pointA, pointB
+     *  End points of the segment
+     * @param[in] distance
+     *  The distance
+     * 
+     * @return true if an edge of the wall crosses the segment or is closer to it than the distance, false otherwise
+     */
+    bool IsSegmentNearWall(int wallInd, sf::Vector2f const pointA, sf::Vector2f const pointB, float distance) const;
+
+    /**
+     * Finds the edge crossing a segment closest to the segment's start
+     * 
+     * @param[in] pointA, pointB
+     *  Start and end points of the segment
+     * @param[out] fraction
+     *  Fraction of the segment from its start to the crossing, if there is one
+     * 
+     * @return index of the closest crossing edge, or -1 if no edge crosses the segment
+     */
+    int FindNearestCrossing(sf::Vector2f const pointA, sf::Vector2f const pointB, float& fraction) const;
+
+    /**
+     * Finds the edge crossing a segment closest to the segment's start, among the edges of some of the walls
+     * 
+     * @param[in] wallIndsBegin, wallIndsEnd
+     *  Range of the indices of the walls to check, in increasing order
+     * @param[in] pointA, pointB
+     *  Start and end points of the segment
+     * @param[out] fraction
+     *  Fraction of the segment from its start to the crossing, if there is one
+     * 
+     * @return index of the closest crossing edge, or -1 if no edge of the walls crosses the segment
+     */
+    int FindNearestCrossingAmong(
+        int const* wallIndsBegin,
+        int const* wallIndsEnd,
+        sf::Vector2f const pointA,
+        sf::Vector2f const pointB,
+        float& fraction) const;
+
+    /**
+     * Checks whether a single edge crosses a segment
+     * 
+     * @param[in] edgeInd
+     *  Index of the edge
+     * @param[in] pointA, pointB
+     *  Start and end points of the segment
+     * @param[out] fraction
+     *  Fraction of the segment from its start to the crossing, if there is one
+     * 
+     * @return true if the edge crosses the segment, false otherwise
+     */
+    bool EdgeCrossesSegment(int edgeInd, sf::Vector2f const pointA, sf::Vector2f const pointB, float& fraction) const;
+
+    /**
+     * Checks whether a circle intersects any of a wall's edges
+     * 
+     * @param[in] wallInd
+     *  Index of the wall
+     * @param[in] center, radius
+     *  The circle
+     * 
+     * @return true if the circle intersects an edge of the wall, false otherwise
+     */
+    bool CircleIntersectsWall(int wallInd, sf::Vector2f const center, float const radius) const;
+
+    /**
+     * Checks whether a point is inside a wall, including on its edges
+     * 
+     * @param[in] wallInd
+     *  Index of the wall
+     * @param[in] point
+     *  The point
+     * 
+     * @return true if the point is inside the wall, false otherwise
+     */
+    bool IsPointInsideWall(int wallInd, sf::Vector2f const point) const;
+
+    /// Returns the index of a wall's first edge. The wall's edges go up to the first edge of the next wall.
+    int GetWallEdgesBegin(int wallInd) const;
+
+    /// Returns the index after a wall's last edge
+    int GetWallEdgesEnd(int wallInd) const;
+
+    /// Returns the start point of an edge
+    sf::Vector2f GetEdgeStart(int edgeInd) const;
+
+    /// Returns the end point of an edge
+    sf::Vector2f GetEdgeEnd(int edgeInd) const;
+
+    /// Returns the outward unit normal of an edge
+    sf::Vector2f GetEdgeNormal(int edgeInd) const;
+
+    /**
+     * Finds the point of an edge closest to a point
+     * 
+     * @param[in] edgeInd
+     *  Index of the edge
+     * @param[in] point
+     *  The point
+     * 
+     * @return the closest point of the edge
+     */
+    sf::Vector2f FindClosestPointOnEdge(int edgeInd, sf::Vector2f const point) const;
+
+  private: /* functions */
+
+    /**
+     * Checks whether a segment crosses a wall's bounding box
+     * 
+     * @param[in] wallInd
+     *  Index of the wall
+     * @param[in] pointA, pointB
+     *  End points of the segment
+     * 
+     * @return true if the segment crosses or is inside the box, false otherwise
+     */
+    bool SegmentCrossesWallBox(int wallInd, sf::Vector2f const pointA, sf::Vector2f const pointB) const;
+
+    /**
+     * Checks whether a segment crosses an edge, without checking which side of the edge it comes from
+     * 
+     * @param[in] edgeInd
+     *  Index of the edge
+     * @param[in] pointA
+     *  Start point of the segment
+     * @param[in] segment
+     *  Vector from the start to the end of the segment
+     * @param[out] fraction
+     *  Fraction of the segment from its start to the crossing, if there is one
+     * 
+     * @return true if the edge crosses the segment, false otherwise
+     */
+    bool Crosses(int edgeInd, sf::Vector2f const pointA, sf::Vector2f const segment, float& fraction) const;
+
+    /// Returns whether an edge faces away from a segment's direction, in which case the segment can't enter the wall through it
+    bool IsBackFacing(int edgeInd, sf::Vector2f const segment) const;
+
+    /**
+     * Checks whether a segment crosses one of a wall's edges before the nearest crossing found so far,
+     * which is the step shared by the searches for the nearest crossing
+     * 
+     * @param[in] wallInd
+     *  Index of the wall
+     * @param[in] pointA
+     *  Start point of the segment
+     * @param[in] segment
+     *  Vector from the start to the end of the segment
+     * @param[in,out] nearestEdgeInd
+     *  Index of the nearest crossing edge so far, or -1 if there is none yet
+     * @param[in,out] fraction
+     *  Fraction of the segment from its start to the nearest crossing so far, 1 if there is none yet
+     */
+    void FindNearestCrossingOfWall(
+        int wallInd,
+        sf::Vector2f const pointA,
+        sf::Vector2f const segment,
+        int& nearestEdgeInd,
+        float& fraction) const;
+
+  private: /* variables */
+
+    /// Start and end points of the edges
+    std::vector<float> _startX, _startY, _endX, _endY;
+    /// Vectors from the start to the end of the edges
+    std::vector<float> _dirX, _dirY;
+    /// Inverse squared lengths of the edges
+    std::vector<float> _invLengthSq;
+    /// Unit normals of the edges, pointing out of their walls
+    std::vector<float> _normalX, _normalY;
+
+    /// For each wall, index of its first edge, with one more element at the end for the total number of edges
+    std::vector<int> _wallEdgesBegin;
+    /// Bounding boxes of the walls
+    std::vector<float> _wallMinX, _wallMinY, _wallMaxX, _wallMaxY;
+
+    /// Outward unit normals of all the walls' sides, inner edges included, so that each wall is bounded by its sides
+    std::vector<float> _sideNormalX, _sideNormalY;
+    /// Dot products of the sides' normals with their start points, which no point inside the wall exceeds
+    std::vector<float> _sideOffset;
+    /// For each wall, index of its first side, with one more element at the end for the total number of sides
+    std::vector<int> _wallSidesBegin;
+};
+
+} // namespace HideAndSeekAndShoot
@@ -0,0 +1,134 @@
+#include "WallGrid.h"
+
+#include <cmath>
+
+namespace
+{
+
+// Maximal number of columns or rows of cells, which keeps the grid's memory bounded for huge maps
+int const CELLS_COUNT_MAX = 512;
+
+} // namespace
+
+namespace HideAndSeekAndShoot
+{
+
+WallGrid::WallGrid()
+    : _cellsCountX(1),
+    _cellsCountY(1),
+    _origin(0.f, 0.f),
+    _cellSize(1.f, 1.f),
+    _cellWallsBegin(2, 0)
+{}
+
+void WallGrid::Build(sf::FloatRect const& area, std::vector<Broadphase::Box> const& wallBoxes)
+{
+    // Square cells, about as many as there are walls
+    float const cellSide = std::sqrt(area.width * area.height / std::max<float>(wallBoxes.size(), 1.f));
+    _cellsCountX = std::min(std::max((int)std::ceil(area.width / cellSide), 1), CELLS_COUNT_MAX);
+    _cellsCountY = std::min(std::max((int)std::ceil(area.height / cellSide), 1), CELLS_COUNT_MAX);
+    _origin = sf::Vector2f(area.left, area.top);
+    _cellSize = sf::Vector2f(area.width / _cellsCountX, area.height / _cellsCountY);
+
+    // Counting the walls of each cell first, so that the cells' ranges can be filled in place
+    int const cellsCount = _cellsCountX * _cellsCountY;
+    _cellWallsBegin.assign(cellsCount + 1, 0);
+    for (int wallInd = 0; wallInd < wallBoxes.size(); wallInd++)
+    {
+        int minCellX, minCellY, maxCellX, maxCellY;
+        GetCellRange(wallBoxes[wallInd], minCellX, minCellY, maxCellX, maxCellY);
+        for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+        {
+            for (int cellX = minCellX; cellX <= maxCellX; cellX++)
+            {
+                _cellWallsBegin[cellY * _cellsCountX + cellX + 1]++;
+            }
+        }
+    }
+    for (int cellInd = 0; cellInd < cellsCount; cellInd++)
+    {
+        _cellWallsBegin[cellInd + 1] += _cellWallsBegin[cellInd];
+    }
+
+    _cellWalls.resize(_cellWallsBegin[cellsCount]);
+    std::vector<int> cellFilled(_cellWallsBegin.begin(), _cellWallsBegin.end() - 1);
+    for (int wallInd = 0; wallInd < wallBoxes.size(); wallInd++)
+    {
+        int minCellX, minCellY, maxCellX, maxCellY;
+        GetCellRange(wallBoxes[wallInd], minCellX, minCellY, maxCellX, maxCellY);
+        for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+        {
+            for (int cellX = minCellX; cellX <= maxCellX; cellX++)
+            {
+                _cellWalls[cellFilled[cellY * _cellsCountX + cellX]++] = wallInd;
+            }
+        }
+    }
+}
+
+void WallGrid::FindWallsInBox(Broadphase::Box const& box, std::pmr::vector<int>& wallInds) const
+{
+    std::size_t const begin = wallInds.size();
+    VisitWallsInBox(box, [&wallInds](int wallInd) -> bool {
+        wallInds.push_back(wallInd);
+        return true;
+    });
+
+    // Walls that span several cells are found once for each of them
+    std::sort(wallInds.begin() + begin, wallInds.end());
+    wallInds.erase(std::unique(wallInds.begin() + begin, wallInds.end()), wallInds.end());
+}
+
+void WallGrid::GetCellRange(
+    Broadphase::Box const& box,
+    int& minCellX,
+    int& minCellY,
+    int& maxCellX,
+    int& maxCellY) const
+{
+    // Boxes reaching outside of the area are clamped to the border cells
+    minCellX = std::min(std::max((int)std::floor((box.minX - _origin.x) / _cellSize.x), 0), _cellsCountX - 1);
+    minCellY = std::min(std::max((int)std::floor((box.minY - _origin.y) / _cellSize.y), 0), _cellsCountY - 1);
+    maxCellX = std::min(std::max((int)std::floor((box.maxX - _origin.x) / _cellSize.x), 0), _cellsCountX - 1);
+    maxCellY = std::min(std::max((int)std::floor((box.maxY - _origin.y) / _cellSize.y), 0), _cellsCountY - 1);
+}
+
+void WallGrid::ExtendByPartInRow(
+    sf::Vector2f const pointA,
+    sf::Vector2f const pointB,
+    int cellY,
+    float halfWidth,
+    float& minX,
+    float& maxX) const
+{
+    // Band of the row, widened by the half width, and reaching out of the area for the border rows
+    float const infinity = std::numeric_limits<float>::infinity();
+    float const bandMinY = (cellY == 0 ? -infinity : _origin.y + cellY * _cellSize.y - halfWidth);
+    float const bandMaxY = (cellY == _cellsCountY - 1 ? infinity : _origin.y + (cellY + 1) * _cellSize.y + halfWidth);
+
+    // Part of the segment inside of the band, as fractions of the segment
+    float const diffY = pointB.y - pointA.y;
+    float minT = 0.f, maxT = 1.f;
+    if (diffY != 0.f)
+    {
+        float const t1 = (bandMinY - pointA.y) / diffY;
+        float const t2 = (bandMaxY - pointA.y) / diffY;
+        minT = std::max(std::min(t1, t2), 0.f);
+        maxT = std::min(std::max(t1, t2), 1.f);
+    }
+    else if (pointA.y < bandMinY || pointA.y > bandMaxY)
+    {
+        return;
+    }
+    if (minT > maxT)
+    {
+        return;
+    }
+
+    float const x1 = pointA.x + (pointB.x - pointA.x) * minT;
+    float const x2 = pointA.x + (pointB.x - pointA.x) * maxT;
+    minX = std::min({ minX, x1, x2 });
+    maxX = std::max({ maxX, x1, x2 });
+}
+
+} // namespace HideAndSeekAndShoot
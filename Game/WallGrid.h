@@ -0,0 +1,258 @@
+#pragma once
+
+#include "Broadphase.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+
+namespace HideAndSeekAndShoot
+{
+
+/**
+ * A uniform grid over an area of the world, listing for each cell the walls whose boxes overlap it.
+ * Queries about an area look only at the walls listed in the cells the area covers,
+ * instead of at all the walls of the world.
+ * Cells are stored flat, each cell's walls in a contiguous range of a single array.
+ */
+class WallGrid
+{
+
+  public:
+
+    /// Creates an empty grid, with a single cell and no walls
+    WallGrid();
+
+    /**
+     * Builds the grid, with cells of about the size that gives one wall per cell.
+     * Cells on the border of the area reach out of it, so everything outside of the area is in them.
+     * 
+     * @param[in] area
+     *  Area that the grid covers - the whole world, or the part of it where the walls are loaded
+     * @param[in] wallBoxes
+     *  Boxes of the walls, by the walls' indices. A wall is listed in every cell its box overlaps.
+     */
+    void Build(sf::FloatRect const& area, std::vector<Broadphase::Box> const& wallBoxes);
+
+    /**
+     * Finds the walls listed in the cells a box covers, each one once
+     * 
+     * @param[in] box
+     *  The box
+     * @param[out] wallInds
+     *  Vector to which the walls' indices are appended, in increasing order
+     */
+    void FindWallsInBox(Broadphase::Box const& box, std::pmr::vector<int>& wallInds) const;
+
+    /**
+     * Visits the walls listed in the cells a box covers, until the visitor returns false.
+     * A wall that is listed in several of the cells is visited once for each of them,
+     * which is cheaper than finding unique walls for a query that usually stops early or visits few walls.
+     * 
+     * @param[in] box
+     *  The box
+     * @param[in] visitor
+     *  Function taking a wall's index and returning whether to continue
+     * 
+     * @return true if the visitor returned true for every visited wall, false otherwise
+     */
+    template <typename Visitor>
+    bool VisitWallsInBox(Broadphase::Box const& box, Visitor visitor) const
+    {
+        int minCellX, minCellY, maxCellX, maxCellY;
+        GetCellRange(box, minCellX, minCellY, maxCellX, maxCellY);
+        for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+        {
+            for (int cellX = minCellX; cellX <= maxCellX; cellX++)
+            {
+                int const cellInd = cellY * _cellsCountX + cellX;
+                for (int i = _cellWallsBegin[cellInd]; i < _cellWallsBegin[cellInd + 1]; i++)
+                {
+                    if (!visitor(_cellWalls[i]))
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Visits the walls listed in the cells that a segment, widened on both sides, passes through, until the visitor returns false.
+     * Only the cells near the segment are visited, row by row, so a long diagonal segment doesn't visit all the cells of its box.
+     * As with VisitWallsInBox, a wall listed in several of the cells is visited once for each of them.
+     * 
+     * @param[in] pointA, pointB
+     *  End points of the segment
+     * @param[in] halfWidth
+     *  Distance from the segment up to which cells are visited, 0 for only the cells the segment itself passes through
+     * @param[in] visitor
+     *  Function taking a wall's index and returning whether to continue
+     * 
+     * @return true if the visitor returned true for every visited wall, false otherwise
+     */
+    template <typename Visitor>
+    bool VisitWallsAlongSegment(sf::Vector2f const pointA, sf::Vector2f const pointB, float halfWidth, Visitor visitor) const
+    {
+        int minCellX, minCellY, maxCellX, maxCellY;
+        GetCellRange(
+            {
+                std::min(pointA.x, pointB.x) - halfWidth, std::max(pointA.x, pointB.x) + halfWidth,
+                std::min(pointA.y, pointB.y) - halfWidth, std::max(pointA.y, pointB.y) + halfWidth
+            },
+            minCellX, minCellY, maxCellX, maxCellY
+        );
+
+        for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+        {
+            // Columns that the part of the segment in the row's band, widened by the half width, covers
+            float minX = std::numeric_limits<float>::infinity(), maxX = -std::numeric_limits<float>::infinity();
+            ExtendByPartInRow(pointA, pointB, cellY, halfWidth, minX, maxX);
+            if (minX > maxX)
+            {
+                continue;
+            }
+            if (!VisitWallsInRow(cellY, minX - halfWidth, maxX + halfWidth, visitor))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Visits the walls listed in the cells that a triangle covers, until the visitor returns false.
+     * Only the cells the triangle covers are visited, row by row, so a long thin triangle doesn't visit all the cells of its box.
+     * As with VisitWallsInBox, a wall listed in several of the cells is visited once for each of them.
+     * 
+     * @param[in] pointA, pointB, pointC
+     *  Corners of the triangle
+     * @param[in] visitor
+     *  Function taking a wall's index and returning whether to continue
+     * 
+     * @return true if the visitor returned true for every visited wall, false otherwise
+     */
+    template <typename Visitor>
+    bool VisitWallsInTriangle(sf::Vector2f const pointA, sf::Vector2f const pointB, sf::Vector2f const pointC, Visitor visitor) const
+    {
+        int minCellX, minCellY, maxCellX, maxCellY;
+        GetCellRange(
+            {
+                std::min({ pointA.x, pointB.x, pointC.x }), std::max({ pointA.x, pointB.x, pointC.x }),
+                std::min({ pointA.y, pointB.y, pointC.y }), std::max({ pointA.y, pointB.y, pointC.y })
+            },
+            minCellX, minCellY, maxCellX, maxCellY
+        );
+
+        for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+        {
+            // The part of a triangle in a band reaches as far as the parts of its sides in the band
+            float minX = std::numeric_limits<float>::infinity(), maxX = -std::numeric_limits<float>::infinity();
+            ExtendByPartInRow(pointA, pointB, cellY, 0.f, minX, maxX);
+            ExtendByPartInRow(pointB, pointC, cellY, 0.f, minX, maxX);
+            ExtendByPartInRow(pointC, pointA, cellY, 0.f, minX, maxX);
+            if (minX > maxX)
+            {
+                continue;
+            }
+            if (!VisitWallsInRow(cellY, minX, maxX, visitor))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private: /* functions */
+
+    /**
+     * Calculates the range of cells a box covers, clamped to the grid
+     * 
+     * @param[in] box
+     *  The box
+     * @param[out] minCellX, minCellY, maxCellX, maxCellY
+     *  Column and row ranges of the covered cells, inclusive
+     */
+    void GetCellRange(
+        Broadphase::Box const& box,
+        int& minCellX,
+        int& minCellY,
+        int& maxCellX,
+        int& maxCellY) const;
+
+    /**
+     * Extends a range of x coordinates by the part of a segment inside of a row's band
+     * 
+     * @param[in] pointA, pointB
+     *  End points of the segment
+     * @param[in] cellY
+     *  The row, whose band reaches out of the area for the border rows
+     * @param[in] halfWidth
+     *  Distance by which the band is widened on both sides
+     * @param[in,out] minX, maxX
+     *  The range, which is left as it is if the segment doesn't pass through the band
+     */
+    void ExtendByPartInRow(
+        sf::Vector2f const pointA,
+        sf::Vector2f const pointB,
+        int cellY,
+        float halfWidth,
+        float& minX,
+        float& maxX) const;
+
+    /**
+     * Visits the walls listed in the cells of a row that a range of x coordinates covers, until the visitor returns false
+     * 
+     * @param[in] cellY
+     *  The row
+     * @param[in] minX, maxX
+     *  The range
+     * @param[in] visitor
+     *  Function taking a wall's index and returning whether to continue
+     * 
+     * @return true if the visitor returned true for every visited wall, false otherwise
+     */
+    template <typename Visitor>
+    bool VisitWallsInRow(int cellY, float minX, float maxX, Visitor& visitor) const
+    {
+        int rowMinCellX, rowMaxCellX, unusedY;
+        float const rowCenterY = _origin.y + (cellY + 0.5f) * _cellSize.y;
+        GetCellRange({ minX, maxX, rowCenterY, rowCenterY }, rowMinCellX, unusedY, rowMaxCellX, unusedY);
+
+        for (int cellX = rowMinCellX; cellX <= rowMaxCellX; cellX++)
+        {
+            int const cellInd = cellY * _cellsCountX + cellX;
+            for (int i = _cellWallsBegin[cellInd]; i < _cellWallsBegin[cellInd + 1]; i++)
+            {
+                if (!visitor(_cellWalls[i]))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+  private: /* variables */
+
+    /// Number of columns and rows of cells
+    int _cellsCountX, _cellsCountY;
+
+    /// Top left corner of the area the grid covers
+    sf::Vector2f _origin;
+
+    /// Size of a cell
+    sf::Vector2f _cellSize;
+
+    /// Beginning of each cell's range in the cells' walls, by cell index (row by row), and the end of the last cell's range
+    std::vector<int> _cellWallsBegin;
+
+    /// Indices of the walls listed in the cells, cell after cell
+    std::vector<int> _cellWalls;
+};
+
+} // namespace HideAndSeekAndShoot
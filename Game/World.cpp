@@ -1,10 +1,19 @@
 #include "World.h"
 
 #include "ControlState.h"
+#include "AllocationTracker.h"
+#include "MapGenerator.h"
 #include "utils/configUtils.hpp"
 #include "utils/textureUtils.hpp"
+#include "utils/geometryUtils.hpp"
+#include "utils/hashUtils.hpp"
+#include "utils/randomUtils.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <random>
 #include <stdexcept>
+#include <unordered_map>
 
 #include <iostream>
 
@@ -13,6 +22,68 @@ namespace
 
 auto constexpr WALLS_CONFIG_FILENAME = "Game/config/walls.conf";
 
+// Number of vertices of a wall whose vertex count is not specified in the config
+int const WALL_VERT_COUNT_DEFAULT = 4;
+
+// Fits in every style with the default passage width in a world of the view's size, and a bigger world fits more
+int const GENERATOR_WALLS_COUNT_DEFAULT = 10;
+
+unsigned const GENERATOR_SEED_DEFAULT = 0;
+
+auto constexpr WORLD_CONFIG_FILENAME = "Game/config/world.conf";
+
+int const ENEMIES_COUNT_DEFAULT = 1;
+
+float const ENEMY_SPAWN_DISTANCE_REL_DEFAULT = 0.3f;
+
+float const LOD_NEAR_DISTANCE_REL_DEFAULT = 0.4f;
+
+float const LOD_FAR_DISTANCE_REL_DEFAULT = 0.8f;
+
+int const LOD_REDUCED_INTERVAL_DEFAULT = 3;
+
+int const LOD_DORMANT_INTERVAL_DEFAULT = 6;
+
+/* An enemy that is updated once in many frames moves a long way in a single step,
+   so it could jump over a thin wall. Intervals are limited to keep such steps reasonably short. */
+int const LOD_INTERVAL_MAX = 8;
+
+// Distance within which enemies avoid each other with crowd steering, relative to the view's width
+float const CROWD_NEIGHBOUR_DISTANCE_REL_DEFAULT = 0.1f;
+
+int const CROWD_MAX_NEIGHBOURS_DEFAULT = 10;
+
+float const CROWD_TIME_HORIZON_DEFAULT = 30.f;
+
+float const CROWD_OBSTACLE_TIME_HORIZON_DEFAULT = 10.f;
+
+// Side of the line of sight cache's cells, relative to the view's width - about the size of a person
+float const LINE_OF_SIGHT_CELL_SIZE_REL_DEFAULT = 0.02f;
+
+int const LINE_OF_SIGHT_CACHE_CAPACITY_DEFAULT = 4096;
+
+// How many times the world is bigger than its view - by default it fits the window exactly
+float const WORLD_SCALE_DEFAULT = 1.f;
+
+int const STREAMING_TILES_CAPACITY_DEFAULT = 64;
+
+int const STREAMING_PREFETCH_TILES_DEFAULT = 1;
+
+// Number of updates from when the needed tiles change until their walls replace the loaded ones - a quarter of a second at 60 FPS
+int const STREAMING_DELAY_UPDATES_DEFAULT = 15;
+
+// Number of ticks in a turn of the wheel on which bullets' despawns are scheduled - a bit more than a bullet needs to cross the view
+int const BULLET_DESPAWN_WHEEL_SIZE_DEFAULT = 256;
+
+// Number of bullets that can fly at once before shooting allocates - a few times more than a storm of 300 enemies has
+int const BULLETS_CAPACITY_DEFAULT = 1024;
+
+// Seed for placing enemies and for their random generators, so that the same config always gives the same world
+unsigned const SEED_DEFAULT = 2021;
+
+// Number of random positions to try for placing an enemy before giving up on it
+int const ENEMY_PLACEMENT_ATTEMPTS = 100;
+
 } // namespace
 
 namespace HideAndSeekAndShoot
@@ -21,30 +92,65 @@ namespace HideAndSeekAndShoot
 World::World(
     Game const* game,
     Resources::ResourceHandler<Resources::Texture::Id, sf::Texture> const* texHandler,
-    sf::Vector2f size)
+    FrameArena* frameArena,
+    sf::Vector2f size,
+    Config const& configOverrides,
+    Config const* wallsConfig)
     : _game(game),
-    _size(size)
+    _frameArena(frameArena),
+    _viewSize(size),
+    _config(ConfigUtils::ReadConfig(WORLD_CONFIG_FILENAME)),
+    _movementSystem(this, &_registry),
+    _bulletSystem(this, &_registry, BULLET_DESPAWN_WHEEL_SIZE_DEFAULT),
+    _weaponSystem(&_registry, &_bulletSystem),
+    _aiSystem(this, &_registry, &_movementSystem, &_weaponSystem),
+    _renderSystem(&_registry),
+    _entityFactory(this, &_registry, &_aiSystem, texHandler),
+    _frameCount(0)
 {
+    for (auto it = configOverrides.begin(); it != configOverrides.end(); it++)
+    {
+        _config[it->first] = it->second;
+    }
+    if (wallsConfig != nullptr)
+    {
+        _wallsConfig = *wallsConfig;
+    }
+
+    ConfigCamera();
+    ConfigEnemies();
+    ConfigCrowdSteering();
+    ConfigLineOfSightCache();
+    ConfigStreaming();
+    ConfigBullets();
+
     SetBackgroundTexture(&texHandler->Get(Resources::Texture::Id::Background));
 
     SetWallTexture(&texHandler->Get(Resources::Texture::Id::Wall));
     LoadRelWalls();
+    ConfigPotentiallyVisibleSet();
     GenerateWalls();
 
-    _player = std::make_unique<Player>(
-        this,
-        &texHandler->Get(Resources::Texture::Id::PlayerHead),
-        &texHandler->Get(Resources::Texture::Id::Gun),
-        &texHandler->Get(Resources::Texture::Id::Bullet)
-    );
+    _player = _entityFactory.CreatePlayer();
+    _aiSystem.SetPlayer(_player);
+    _renderSystem.SetPlayer(_player);
+    // With a chunked map, the walls around the player are needed for placing the player and the enemies
+    _streamingPlayerPosition = _registry.GetComponent<Transform>(_player).position;
+    StreamWalls();
 
-    _enemy = std::make_unique<Enemy>(
-        this,
-        &texHandler->Get(Resources::Texture::Id::EnemyHead),
-        &texHandler->Get(Resources::Texture::Id::Gun),
-        &texHandler->Get(Resources::Texture::Id::Bullet),
-        &*_player
-    );
+    // The configured position can end up inside a wall of a generated map
+    if (!_movementSystem.IsPositionValid(_player, _registry.GetComponent<Transform>(_player).position)
+        && !_movementSystem.MoveToNearestValidPosition(_player))
+    {
+        throw std::runtime_error("Error: There is no valid position for the player in the world.");
+    }
+    UpdateCamera();
+
+    _aiSystem.Configure(_entityFactory.GetEnemyConfig());
+    _aiSystem.SetCrowdSteering(_crowdSteering);
+    CreateEnemies();
+    // Bullets are created after the people, so the room for them is on top of the people's
+    _bulletSystem.Reserve(_bulletsCapacity);
 }
 
 sf::Vector2f World::GetSize() const
@@ -52,16 +158,27 @@ sf::Vector2f World::GetSize() const
     return _size;
 }
 
+sf::Vector2f World::GetViewSize() const
+{
+    return _viewSize;
+}
+
+sf::View const& World::GetCameraView() const
+{
+    return _cameraView;
+}
+
 void World::GenerateWalls()
 {
-    _walls = std::vector<sf::ConvexShape>(
-        _relWalls.size(),
-        sf::ConvexShape(4)
-    );
+    std::lock_guard<std::mutex> lock(_staticLayerMutex);
+
+    // Existing shapes are reused, so that regenerating walls on resize doesn't reallocate them
+    _walls.resize(_relWalls.size());
 
     for (int wallInd = 0; wallInd < _walls.size(); wallInd++)
     {
-        for (int verInd = 0; verInd < 4; verInd++)
+        _walls[wallInd].setPointCount(_relWalls[wallInd].size());
+        for (int verInd = 0; verInd < _relWalls[wallInd].size(); verInd++)
         {
             _walls[wallInd].setPoint(verInd, sf::Vector2f(
                 _relWalls[wallInd][verInd].x * _size.x,
@@ -69,8 +186,66 @@ void World::GenerateWalls()
             ));
         }
     }
+    _wallEdges.Build(_walls, _wallPolygonInds);
+
+    if (!_potentiallyVisibleSet.IsEmpty() && _potentiallyVisibleSet.GetWallsCount() != _walls.size())
+    {
+        throw std::runtime_error("Error: The potentially visible set was built for other walls.");
+    }
+    _potentiallyVisibleSet.SetWorldSize(_size);
 
     SetWallTexture(_wallTex);
+    CalcWallBoundingCircles();
+    BuildWallGrid();
+    _lineOfSightCache.Reset(_size, _lineOfSightCellSizeRel * _viewSize.x, _lineOfSightCacheCapacity);
+
+    // The static layer is rendered on the rendering thread, the next time it is drawn
+    _staticLayerRect = sf::FloatRect();
+}
+
+void World::Resize(sf::Vector2f const size)
+{
+    if (size == _viewSize || size.x <= 0.f || size.y <= 0.f)
+    {
+        return;
+    }
+
+    sf::Vector2f const scale(size.x / _viewSize.x, size.y / _viewSize.y);
+    _viewSize = size;
+    _size = size * _worldScale;
+
+    SetBackgroundTexture(_bgSprite.getTexture());
+    GenerateWalls();
+
+    ComponentArray<Transform>& transforms = _registry.GetComponents<Transform>();
+    for (int i = 0; i < transforms.GetSize(); i++)
+    {
+        sf::Vector2f& position = transforms.GetAt(i).position;
+        position = sf::Vector2f(position.x * scale.x, position.y * scale.y);
+    }
+    // Collision radii follow the heads' sizes, so they are rescaled before the sprites
+    _movementSystem.Rescale(scale);
+    ComponentArray<Sprite>& sprites = _registry.GetComponents<Sprite>();
+    for (int i = 0; i < sprites.GetSize(); i++)
+    {
+        sf::Vector2f& spriteScale = sprites.GetAt(i).scale;
+        spriteScale = sf::Vector2f(spriteScale.x * scale.x, spriteScale.y * scale.y);
+    }
+    _weaponSystem.Rescale(scale);
+    _aiSystem.Rescale(scale);
+    // Bullets' exits are calculated again with the resized walls
+    _bulletSystem.Rescale(scale);
+
+    // Level of detail and spawn distances are relative to the view's width
+    _lodNearDistance *= scale.x;
+    _lodFarDistance *= scale.x;
+    _enemySpawnDistance *= scale.x;
+
+    // So is the crowd steering, and velocities scale with the world like the positions
+    _crowdSolver.Rescale(scale.x);
+    _lastPlayerPosition = sf::Vector2f(_lastPlayerPosition.x * scale.x, _lastPlayerPosition.y * scale.y);
+
+    UpdateCamera();
 }
 
 Game const* World::GetGame() const
@@ -83,8 +258,69 @@ std::vector<sf::ConvexShape> const& World::GetWalls() const
     return _walls;
 }
 
+unsigned World::GetSeed() const
+{
+    return _seed;
+}
+
+int World::GetFrameCount() const
+{
+    return _frameCount;
+}
+
+WallEdgeTable const& World::GetWallEdges() const
+{
+    return _wallEdges;
+}
+
+std::vector<World::Circle> const& World::GetWallBoundingCircles() const
+{
+    return _wallBoundingCircles;
+}
+
+WallGrid const& World::GetWallGrid() const
+{
+    return _wallGrid;
+}
+
+bool World::IsLineOfSightClear(sf::Vector2f const pointA, sf::Vector2f const pointB) const
+{
+    return _lineOfSightCache.IsLineClear(pointA, pointB, _wallGrid, _wallEdges);
+}
+
+int World::FindNearestWallCrossing(sf::Vector2f const pointA, sf::Vector2f const pointB, float& fraction) const
+{
+    int const regionInd = _potentiallyVisibleSet.FindRegion(pointA);
+    if (regionInd < 0)
+    {
+        return _wallEdges.FindNearestCrossing(pointA, pointB, fraction);
+    }
+    return _wallEdges.FindNearestCrossingAmong(
+        _potentiallyVisibleSet.GetRegionWallsBegin(regionInd),
+        _potentiallyVisibleSet.GetRegionWallsEnd(regionInd),
+        pointA,
+        pointB,
+        fraction
+    );
+}
+
+LineOfSightCache::Stats World::GetLineOfSightStats() const
+{
+    return _lineOfSightCache.GetStats();
+}
+
+std::pmr::memory_resource* World::GetFrameMemory() const
+{
+    return _frameArena->GetResource();
+}
+
 void World::Update(ControlState const& controlState)
 {
+    {
+        AllocationTag tag("Streaming");
+        StreamWalls();
+    }
+
     sf::Vector2f playerDirection;
     if (controlState.IsUpPressed())
         playerDirection.y -= 1.f;
@@ -94,49 +330,151 @@ void World::Update(ControlState const& controlState)
         playerDirection.x -= 1.f;
     if (controlState.IsRightPressed()) 
         playerDirection.x += 1.f;
-    _player->MoveInDirection(playerDirection);
-    _player->SetTargetPoint(controlState.GetMousePosition());
-    _player->Update();
+    {
+        AllocationTag tag("Player");
+        _movementSystem.MoveInDirection(_player, playerDirection);
+        // The mouse is over the window, which shows the camera's view from the last update
+        _registry.GetComponent<Aim>(_player).targetPoint =
+            controlState.GetMousePosition() + _cameraView.getCenter() - _cameraView.getSize() / 2.f;
+        _weaponSystem.PointAtTarget(_player);
+    }
 
-    _enemy->Update();
+    {
+        AllocationTag tag("Enemy");
+        UpdateEnemies();
+    }
 
-    if (controlState.IsShootButtonPressed())
     {
-        _bullets.push_back(
-            _player->Shoot()
-        );
+        AllocationTag tag("Collision");
+        SeparatePersons();
     }
 
-    for (int i = 0; i < _bullets.size(); i++)
+    AllocationTag tag("Bullet");
+    if (controlState.IsShootButtonPressed())
+    {
+        _weaponSystem.Shoot(_player);
+    }
+    ComponentArray<AiState> const& enemies = _registry.GetComponents<AiState>();
+    for (int i = 0; i < enemies.GetSize(); i++)
     {
-        _bullets[i]->Update();
+        if (enemies.GetAt(i).shooting)
+        {
+            _weaponSystem.Shoot(enemies.GetEntityAt(i));
+        }
     }
+
+    _bulletSystem.Update();
+
+    UpdateCamera();
+
+    _frameCount++;
 }
 
-void World::draw(sf::RenderTarget& target, sf::RenderStates states) const
+std::uint64_t World::CalcStateHash() const
 {
-    target.draw(_bgSprite, states);
-    
-    for (int wallInd = 0; wallInd < _walls.size(); wallInd++)
+    std::uint64_t hash = HashUtils::FNV_OFFSET_BASIS;
+
+    HashUtils::HashValue(hash, _frameCount);
+    HashUtils::HashVector(hash, _registry.GetComponent<Transform>(_player).position);
+    HashUtils::HashVector(hash, _registry.GetComponent<Aim>(_player).targetPoint);
+    HashUtils::HashVector(hash, _lastPlayerPosition);
+    ComponentArray<AiState> const& enemies = _registry.GetComponents<AiState>();
+    for (int i = 0; i < enemies.GetSize(); i++)
     {
-        target.draw(_walls[wallInd], states);
+        Entity const enemy = enemies.GetEntityAt(i);
+        HashUtils::HashVector(hash, _registry.GetComponent<Transform>(enemy).position);
+        HashUtils::HashVector(hash, _registry.GetComponent<Aim>(enemy).targetPoint);
+        _aiSystem.HashState(enemy, hash);
+        HashUtils::HashValue(hash, (int)enemies.GetAt(i).lodTier);
+        HashUtils::HashValue(hash, enemies.GetAt(i).lastUpdateFrame);
+        HashUtils::HashVector(hash, _registry.GetComponent<Velocity>(enemy).velocity);
     }
+    _bulletSystem.HashState(hash);
+
+    return hash;
+}
 
-    target.draw(*_enemy);
-    target.draw(*_player);
+void World::DrawStaticLayer(sf::RenderTarget& target, sf::View const& view) const
+{
+    std::lock_guard<std::mutex> lock(_staticLayerMutex);
 
-    for (int i = 0; i < _bullets.size(); i++)
+    sf::FloatRect const viewRect(view.getCenter() - view.getSize() / 2.f, view.getSize());
+    sf::FloatRect visibleRect;
+    if (!viewRect.intersects(sf::FloatRect(sf::Vector2f(0.f, 0.f), _size), visibleRect))
     {
-        target.draw(*_bullets[i], states);
+        return;
     }
+
+    bool const cached = _staticLayerRect.width > 0.f
+        && visibleRect.left >= _staticLayerRect.left
+        && visibleRect.top >= _staticLayerRect.top
+        && visibleRect.left + visibleRect.width <= _staticLayerRect.left + _staticLayerRect.width
+        && visibleRect.top + visibleRect.height <= _staticLayerRect.top + _staticLayerRect.height;
+    if (!cached)
+    {
+        RenderStaticLayer(view);
+    }
+
+    // Background and walls are drawn at once from the static layer cache
+    target.draw(_staticLayerSprite);
+}
+
+void World::TakeSnapshot(RenderSnapshot& snapshot) const
+{
+    snapshot.Clear();
+    snapshot.SetView(_cameraView);
+
+    sf::FloatRect const viewRect(_cameraView.getCenter() - _cameraView.getSize() / 2.f, _cameraView.getSize());
+    _renderSystem.AddToSnapshot(snapshot, viewRect);
+}
+
+void World::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    sf::View const& view = target.getView();
+    DrawStaticLayer(target, view);
+
+    // Only the things whose bounds are in the view are drawn, so the cost of drawing doesn't grow with the world's size
+    sf::FloatRect const viewRect(view.getCenter() - view.getSize() / 2.f, view.getSize());
+    _renderSystem.Draw(target, states, viewRect);
 }
 
 void World::LoadRelWalls()
 {
-    _wallsConfig = ConfigUtils::ReadConfig(WALLS_CONFIG_FILENAME);
+    // The world may have been given its walls config instead
+    if (_wallsConfig.empty())
+    {
+        _wallsConfig = ConfigUtils::ReadConfig(WALLS_CONFIG_FILENAME);
+    }
+
+    std::vector<std::vector<sf::Vector2f>> polygons;
+    auto const mapFileConfig = _wallsConfig.find("map_file");
+    auto const chunkedMapFileConfig = _wallsConfig.find("chunked_map_file");
+    if (chunkedMapFileConfig != _wallsConfig.end())
+    {
+        // Walls of a chunked map are streamed once the player is created
+        _chunkedMap.Open(chunkedMapFileConfig->second, _streamingTilesCapacity);
+    }
+    else if (_wallsConfig.find("generator") != _wallsConfig.end())
+    {
+        polygons = GenerateRelWalls();
+    }
+    else if (mapFileConfig != _wallsConfig.end())
+    {
+        polygons = MapGenerator::LoadBinary(mapFileConfig->second);
+    }
+    else
+    {
+        polygons = ReadRelWallsFromConfig();
+    }
 
+    /* Scaling relative coordinates to the world's size keeps convex polygons convex,
+       so walls can be split into convex parts only once, here */
+    MapGenerator::SplitIntoConvexWalls(polygons, _relWalls, _wallPolygonInds);
+}
+
+std::vector<std::vector<sf::Vector2f>> World::ReadRelWallsFromConfig()
+{
     int wallsCount = std::stoi(_wallsConfig["walls_count"]);
-    _relWalls = std::vector<std::vector<sf::Vector2f>>(wallsCount, std::vector<sf::Vector2f>(4));
 
     auto getWallVertCoordKey = [this](
         int wallInd, int verInd, std::string coord) -> std::string {
@@ -151,11 +489,689 @@ void World::LoadRelWalls()
         );
     };
 
+    auto getVertCount = [this](int wallInd) -> int {
+        auto const vertCountConfig = _wallsConfig.find(std::string("wall") + std::to_string(wallInd) + "_vert_count");
+        if (vertCountConfig != _wallsConfig.end())
+        {
+            return std::stoi(vertCountConfig->second);
+        }
+        return WALL_VERT_COUNT_DEFAULT;
+    };
+
+    std::vector<std::vector<sf::Vector2f>> polygons(wallsCount);
     for (int wallInd = 0; wallInd < wallsCount; wallInd++)
     {
-        for (int verInd = 0; verInd < 4; verInd++)
+        polygons[wallInd].resize(std::max(getVertCount(wallInd), 0));
+        for (int verInd = 0; verInd < polygons[wallInd].size(); verInd++)
+        {
+            polygons[wallInd][verInd] = getVertex(wallInd, verInd);
+        }
+    }
+
+    return polygons;
+}
+
+std::vector<std::vector<sf::Vector2f>> World::GenerateRelWalls() const
+{
+    MapGenerator::Style const style = MapGenerator::ParseStyle(_wallsConfig.at("generator"));
+
+    int wallsCount = GENERATOR_WALLS_COUNT_DEFAULT;
+    auto const wallsCountConfig = _wallsConfig.find("generator_walls_count");
+    if (wallsCountConfig != _wallsConfig.end())
+    {
+        wallsCount = std::stoi(wallsCountConfig->second);
+    }
+
+    unsigned seed = GENERATOR_SEED_DEFAULT;
+    auto const seedConfig = _wallsConfig.find("generator_seed");
+    if (seedConfig != _wallsConfig.end())
+    {
+        seed = std::stoul(seedConfig->second);
+    }
+
+    // People's size is relative to the view, so in a bigger world the passages are narrower relative to the world
+    float passageWidth = MapGenerator::PASSAGE_WIDTH_DEFAULT / _worldScale;
+    auto const passageWidthConfig = _wallsConfig.find("generator_passage_width");
+    if (passageWidthConfig != _wallsConfig.end())
+    {
+        passageWidth = std::stof(passageWidthConfig->second);
+    }
+
+    std::vector<std::vector<sf::Vector2f>> relWalls = MapGenerator(style, seed, passageWidth).Generate(wallsCount);
+    // The styles make only approximately the requested number of walls
+    if (relWalls.size() != wallsCount)
+    {
+        std::cout << "Generated " << relWalls.size() << " walls for the " << wallsCount << " requested" << std::endl;
+    }
+    return relWalls;
+}
+
+void World::StreamWalls()
+{
+    if (!_chunkedMap.IsOpen())
+    {
+        return;
+    }
+
+    sf::Vector2f const cameraCenter = _cameraView.getCenter();
+    sf::Vector2f const playerPos = _registry.GetComponent<Transform>(_player).position;
+    sf::Vector2f const lodFarSize(_lodFarDistance, _lodFarDistance);
+    sf::FloatRect const neededArea = GeometryUtils::UniteRects(
+        sf::FloatRect(cameraCenter - _viewSize, 2.f * _viewSize),
+        sf::FloatRect(playerPos - lodFarSize, 2.f * lodFarSize)
+    );
+    sf::FloatRect const neededRelArea(
+        neededArea.left / _size.x, neededArea.top / _size.y, neededArea.width / _size.x, neededArea.height / _size.y
+    );
+    std::pmr::vector<int> neededTiles(GetFrameMemory());
+    sf::FloatRect const neededTilesRelArea = FindTilesInRect(neededRelArea, neededTiles);
+
+    // The needed tiles are loaded first, and then the tiles ahead of them in the direction the player moves
+    sf::Vector2f const movement = playerPos - _streamingPlayerPosition;
+    _streamingPlayerPosition = playerPos;
+    float const prefetchDist = (float)_streamingPrefetchTiles / _chunkedMap.GetTilesPerSide();
+    sf::Vector2f const prefetchShift(
+        (movement.x > 0.f ? prefetchDist : (movement.x < 0.f ? -prefetchDist : 0.f)),
+        (movement.y > 0.f ? prefetchDist : (movement.y < 0.f ? -prefetchDist : 0.f))
+    );
+    std::pmr::vector<int> requestedTiles(neededTiles.begin(), neededTiles.end(), GetFrameMemory());
+    if (prefetchShift != sf::Vector2f(0.f, 0.f))
+    {
+        std::pmr::vector<int> prefetchTiles(GetFrameMemory());
+        FindTilesInRect(
+            sf::FloatRect(neededRelArea.left + prefetchShift.x, neededRelArea.top + prefetchShift.y, neededRelArea.width, neededRelArea.height),
+            prefetchTiles
+        );
+        for (int i = 0; i < prefetchTiles.size(); i++)
+        {
+            if (!std::binary_search(neededTiles.begin(), neededTiles.end(), prefetchTiles[i]))
+            {
+                requestedTiles.push_back(prefetchTiles[i]);
+            }
+        }
+    }
+    _chunkedMap.Request(requestedTiles);
+
+    if (std::equal(neededTiles.begin(), neededTiles.end(), _streamedTiles.begin(), _streamedTiles.end()))
+    {
+        _streamingApplyFrame = -1;
+        return;
+    }
+
+    /* The loaded walls are replaced a fixed number of updates after the needed tiles change, which the tiles requested then
+       have usually arrived by, and the update waits for any that haven't. That way when the walls change doesn't depend on
+       the disk, and the game stays reproducible. The first walls are loaded right away, as there is nothing to keep before them. */
+    if (!_streamedTiles.empty())
+    {
+        if (_streamingApplyFrame < 0)
+        {
+            _streamingApplyFrame = _frameCount + _streamingDelayUpdates;
+        }
+        if (_frameCount < _streamingApplyFrame)
+        {
+            return;
+        }
+    }
+    _streamingApplyFrame = -1;
+
+    std::pmr::vector<std::shared_ptr<ChunkedMap::Tile const>> tiles(GetFrameMemory());
+    tiles.reserve(neededTiles.size());
+    for (int i = 0; i < neededTiles.size(); i++)
+    {
+        tiles.push_back(_chunkedMap.WaitForTile(neededTiles[i]));
+    }
+
+    /* A polygon overlapping several tiles is in each of them, so it is taken only from the first one.
+       Polygons get consecutive indices in the world, so that the walls' textures are indexed by the loaded polygons only. */
+    std::unordered_map<int, std::pair<int, int>> polygonTileAndInds;
+    _relWalls.clear();
+    _wallPolygonInds.clear();
+    for (int i = 0; i < tiles.size(); i++)
+    {
+        std::shared_ptr<ChunkedMap::Tile const> const& tile = tiles[i];
+        for (int wallInd = 0; wallInd < tile->relWalls.size(); wallInd++)
         {
-            _relWalls[wallInd][verInd] = getVertex(wallInd, verInd);
+            auto const found = polygonTileAndInds.emplace(
+                tile->polygonInds[wallInd],
+                std::make_pair(i, (int)polygonTileAndInds.size())
+            ).first;
+            if (found->second.first == i)
+            {
+                _relWalls.push_back(tile->relWalls[wallInd]);
+                _wallPolygonInds.push_back(found->second.second);
+            }
+        }
+    }
+    _streamedTiles.assign(neededTiles.begin(), neededTiles.end());
+    _streamedRelArea = neededTilesRelArea;
+
+    GenerateWalls();
+    _aiSystem.InvalidateWallsCaches();
+
+    // Bullets can run into the walls that were streamed in
+    _bulletSystem.RecalcExitTicks();
+}
+
+sf::FloatRect World::FindTilesInRect(sf::FloatRect const& relRect, std::pmr::vector<int>& tileInds) const
+{
+    int const tilesPerSide = _chunkedMap.GetTilesPerSide();
+    int const minTileX = std::clamp((int)std::floor(relRect.left * tilesPerSide), 0, tilesPerSide - 1);
+    int const minTileY = std::clamp((int)std::floor(relRect.top * tilesPerSide), 0, tilesPerSide - 1);
+    int const maxTileX = std::clamp((int)std::floor((relRect.left + relRect.width) * tilesPerSide), 0, tilesPerSide - 1);
+    int const maxTileY = std::clamp((int)std::floor((relRect.top + relRect.height) * tilesPerSide), 0, tilesPerSide - 1);
+
+    tileInds.clear();
+    for (int tileY = minTileY; tileY <= maxTileY; tileY++)
+    {
+        for (int tileX = minTileX; tileX <= maxTileX; tileX++)
+        {
+            tileInds.push_back(tileY * tilesPerSide + tileX);
+        }
+    }
+
+    float const tileSize = 1.f / tilesPerSide;
+    return sf::FloatRect(
+        minTileX * tileSize,
+        minTileY * tileSize,
+        (maxTileX - minTileX + 1) * tileSize,
+        (maxTileY - minTileY + 1) * tileSize
+    );
+}
+
+sf::FloatRect World::GetWallsArea() const
+{
+    if (!_chunkedMap.IsOpen())
+    {
+        return sf::FloatRect(sf::Vector2f(0.f, 0.f), _size);
+    }
+    return sf::FloatRect(
+        _streamedRelArea.left * _size.x,
+        _streamedRelArea.top * _size.y,
+        _streamedRelArea.width * _size.x,
+        _streamedRelArea.height * _size.y
+    );
+}
+
+void World::CalcWallBoundingCircles()
+{
+    _wallBoundingCircles.resize(_walls.size());
+    for (int wallInd = 0; wallInd < _walls.size(); wallInd++)
+    {
+        sf::ConvexShape const& wall = _walls[wallInd];
+        Circle& circle = _wallBoundingCircles[wallInd];
+
+        // The circle is centered at the average of the wall's vertices, and reaches the furthest of them
+        circle.center = sf::Vector2f(0.f, 0.f);
+        for (int verInd = 0; verInd < wall.getPointCount(); verInd++)
+        {
+            circle.center += wall.getPoint(verInd);
+        }
+        circle.center /= (float)wall.getPointCount();
+
+        circle.radius = 0.f;
+        for (int verInd = 0; verInd < wall.getPointCount(); verInd++)
+        {
+            circle.radius = std::max(circle.radius, GeometryUtils::CalcDist(circle.center, wall.getPoint(verInd)));
+        }
+    }
+}
+
+void World::BuildWallGrid()
+{
+    std::vector<Broadphase::Box> boxes(_wallBoundingCircles.size());
+    for (int wallInd = 0; wallInd < _wallBoundingCircles.size(); wallInd++)
+    {
+        Circle const& circle = _wallBoundingCircles[wallInd];
+        boxes[wallInd] = {
+            circle.center.x - circle.radius, circle.center.x + circle.radius,
+            circle.center.y - circle.radius, circle.center.y + circle.radius
+        };
+    }
+    _wallGrid.Build(GetWallsArea(), boxes);
+}
+
+void World::CreateEnemies()
+{
+    std::mt19937 rng(_seed);
+    // With a chunked map, enemies are placed where the walls are loaded, so that they aren't placed inside of walls
+    sf::FloatRect const placementArea = GetWallsArea();
+    sf::Vector2f const playerPos = _registry.GetComponent<Transform>(_player).position;
+
+    // Each enemy is a person with a gun, so that many of each component are needed
+    _registry.GetComponents<Transform>().Reserve(2 * _enemiesCount + 2);
+    _registry.GetComponents<Sprite>().Reserve(2 * _enemiesCount + 2);
+    _registry.GetComponents<Velocity>().Reserve(_enemiesCount + 1);
+    _registry.GetComponents<Collider>().Reserve(_enemiesCount + 1);
+    _registry.GetComponents<Aim>().Reserve(_enemiesCount + 1);
+    _registry.GetComponents<Weapon>().Reserve(_enemiesCount + 1);
+    _registry.GetComponents<AiState>().Reserve(_enemiesCount);
+    _registry.GetComponents<RandomGenerator>().Reserve(_enemiesCount);
+    _registry.GetComponents<FieldOfView>().Reserve(_enemiesCount);
+
+    for (int i = 0; i < _enemiesCount; i++)
+    {
+        Entity const enemy = _entityFactory.CreateEnemy(i);
+        sf::Vector2f& enemyPos = _registry.GetComponent<Transform>(enemy).position;
+
+        // The first enemy stays at its configured position
+        bool placed = (i == 0 && _movementSystem.IsPositionValid(enemy, enemyPos));
+        if (i > 0)
+        {
+            for (int attempt = 0; attempt < ENEMY_PLACEMENT_ATTEMPTS; attempt++)
+            {
+                // Braced initialization draws the coordinates in order, so the same seed gives the same world everywhere
+                sf::Vector2f const candidate{
+                    RandomUtils::UniformFloat(rng, placementArea.left, placementArea.left + placementArea.width),
+                    RandomUtils::UniformFloat(rng, placementArea.top, placementArea.top + placementArea.height)
+                };
+                // A valid position is outside of the walls, and not only clear of their edges, so candidates inside a wall are rejected
+                if (GeometryUtils::CalcDist(candidate, playerPos) >= _enemySpawnDistance
+                    && _movementSystem.IsPositionValid(enemy, candidate))
+                {
+                    enemyPos = candidate;
+                    placed = true;
+                    break;
+                }
+            }
+        }
+
+        /* An enemy that fits nowhere is destroyed, so that it doesn't get stuck inside a wall.
+           It is the last one created, so the other enemies keep their order. */
+        if (!placed && !_movementSystem.MoveToNearestValidPosition(enemy))
+        {
+            std::cerr << "Warning: There is no valid position for enemy " << i << ", so it is not created." << std::endl;
+            _entityFactory.DestroyPerson(enemy);
+        }
+    }
+
+    _lastPlayerPosition = playerPos;
+}
+
+void World::UpdateEnemies()
+{
+    std::pmr::vector<int> updatedEnemies(GetFrameMemory());
+    sf::FloatRect const wallsArea = GetWallsArea();
+    ComponentArray<AiState>& enemies = _registry.GetComponents<AiState>();
+    for (int i = 0; i < enemies.GetSize(); i++)
+    {
+        Entity const enemy = enemies.GetEntityAt(i);
+        sf::Vector2f const enemyPos = _registry.GetComponent<Transform>(enemy).position;
+
+        // Enemies where the walls are not loaded are frozen, and their time doesn't pass until the walls are loaded again
+        if (!wallsArea.contains(enemyPos))
+        {
+            enemies.GetAt(i).lastUpdateFrame = _frameCount;
+            continue;
+        }
+
+        LodTier const tier = CalcLodTier(enemyPos);
+        if (tier != enemies.GetAt(i).lodTier)
+        {
+            _aiSystem.SetLodTier(enemy, tier);
+        }
+
+        /* Enemies with the same level of detail are updated in different frames,
+           so that the cost of updating them is spread evenly across frames */
+        int const interval = GetLodInterval(tier);
+        if ((_frameCount + i) % interval != 0)
+        {
+            continue;
+        }
+
+        _aiSystem.Update(enemy, _frameCount - enemies.GetAt(i).lastUpdateFrame);
+        enemies.GetAt(i).lastUpdateFrame = _frameCount;
+        updatedEnemies.push_back(i);
+    }
+
+    if (_crowdSteering)
+    {
+        SteerEnemies(updatedEnemies);
+    }
+}
+
+void World::SteerEnemies(std::pmr::vector<int> const& updatedEnemies)
+{
+    // Enemies come first, with the same indices, and the player is the last agent
+    ComponentArray<AiState> const& enemies = _registry.GetComponents<AiState>();
+    std::pmr::vector<CrowdSolver::Agent> agents(GetFrameMemory());
+    agents.reserve(enemies.GetSize() + 1);
+    for (int i = 0; i < enemies.GetSize(); i++)
+    {
+        Entity const enemy = enemies.GetEntityAt(i);
+        agents.push_back({
+            _registry.GetComponent<Transform>(enemy).position,
+            sf::Vector2f(0.f, 0.f),
+            sf::Vector2f(0.f, 0.f),
+            _registry.GetComponent<Collider>(enemy).radius,
+            _registry.GetComponent<Velocity>(enemy).speed,
+            false
+        });
+    }
+    for (int k = 0; k < updatedEnemies.size(); k++)
+    {
+        int const i = updatedEnemies[k];
+        agents[i].velocity = _registry.GetComponent<Velocity>(enemies.GetEntityAt(i)).velocity;
+        agents[i].preferredVelocity = enemies.GetAt(i).preferredVelocity;
+        agents[i].movable = true;
+    }
+    sf::Vector2f const playerPos = _registry.GetComponent<Transform>(_player).position;
+    agents.push_back({
+        playerPos,
+        playerPos - _lastPlayerPosition,
+        sf::Vector2f(0.f, 0.f),
+        _registry.GetComponent<Collider>(_player).radius,
+        _registry.GetComponent<Velocity>(_player).speed,
+        false
+    });
+    _lastPlayerPosition = playerPos;
+
+    std::pmr::vector<sf::Vector2f> velocities(GetFrameMemory());
+    _crowdSolver.Solve(agents, _wallGrid, _wallEdges, velocities);
+
+    for (int k = 0; k < updatedEnemies.size(); k++)
+    {
+        int const i = updatedEnemies[k];
+        _aiSystem.MoveWithVelocity(enemies.GetEntityAt(i), velocities[i]);
+    }
+}
+
+LodTier World::CalcLodTier(sf::Vector2f const position) const
+{
+    float const dist = GeometryUtils::CalcDist(position, _registry.GetComponent<Transform>(_player).position);
+    if (dist <= _lodNearDistance)
+    {
+        return LodTier::Full;
+    }
+    if (dist <= _lodFarDistance)
+    {
+        return LodTier::Reduced;
+    }
+    return LodTier::Dormant;
+}
+
+int World::GetLodInterval(LodTier tier) const
+{
+    switch (tier)
+    {
+    case LodTier::Reduced:
+        return _lodReducedInterval;
+    case LodTier::Dormant:
+        return _lodDormantInterval;
+    default:
+        return 1;
+    }
+}
+
+void World::ConfigEnemies()
+{
+    _enemiesCount = ENEMIES_COUNT_DEFAULT;
+    auto const enemiesCountConfig = _config.find("enemies_count");
+    if (enemiesCountConfig != _config.end())
+    {
+        _enemiesCount = std::stoi(enemiesCountConfig->second);
+    }
+
+    _seed = SEED_DEFAULT;
+    auto const seedConfig = _config.find("seed");
+    if (seedConfig != _config.end())
+    {
+        _seed = std::stoul(seedConfig->second);
+    }
+
+    // Distances are specified relative to the view's width
+    float enemySpawnDistanceRel = ENEMY_SPAWN_DISTANCE_REL_DEFAULT;
+    auto const enemySpawnDistanceConfig = _config.find("enemy_spawn_distance");
+    if (enemySpawnDistanceConfig != _config.end())
+    {
+        enemySpawnDistanceRel = std::stof(enemySpawnDistanceConfig->second);
+    }
+    _enemySpawnDistance = enemySpawnDistanceRel * _viewSize.x;
+
+    float lodNearDistanceRel = LOD_NEAR_DISTANCE_REL_DEFAULT;
+    auto const lodNearDistanceConfig = _config.find("lod_near_distance");
+    if (lodNearDistanceConfig != _config.end())
+    {
+        lodNearDistanceRel = std::stof(lodNearDistanceConfig->second);
+    }
+    _lodNearDistance = lodNearDistanceRel * _viewSize.x;
+
+    float lodFarDistanceRel = LOD_FAR_DISTANCE_REL_DEFAULT;
+    auto const lodFarDistanceConfig = _config.find("lod_far_distance");
+    if (lodFarDistanceConfig != _config.end())
+    {
+        lodFarDistanceRel = std::stof(lodFarDistanceConfig->second);
+    }
+    _lodFarDistance = std::max(lodFarDistanceRel * _viewSize.x, _lodNearDistance);
+
+    _lodReducedInterval = LOD_REDUCED_INTERVAL_DEFAULT;
+    auto const lodReducedIntervalConfig = _config.find("lod_reduced_interval");
+    if (lodReducedIntervalConfig != _config.end())
+    {
+        _lodReducedInterval = std::clamp(std::stoi(lodReducedIntervalConfig->second), 1, LOD_INTERVAL_MAX);
+    }
+
+    _lodDormantInterval = LOD_DORMANT_INTERVAL_DEFAULT;
+    auto const lodDormantIntervalConfig = _config.find("lod_dormant_interval");
+    if (lodDormantIntervalConfig != _config.end())
+    {
+        _lodDormantInterval = std::clamp(std::stoi(lodDormantIntervalConfig->second), 1, LOD_INTERVAL_MAX);
+    }
+}
+
+void World::ConfigCrowdSteering()
+{
+    auto const crowdSteeringConfig = _config.find("crowd_steering");
+    _crowdSteering = (crowdSteeringConfig != _config.end() && crowdSteeringConfig->second == "on");
+
+    // The neighbour distance is specified relative to the view's width
+    float neighbourDistanceRel = CROWD_NEIGHBOUR_DISTANCE_REL_DEFAULT;
+    auto const neighbourDistanceConfig = _config.find("crowd_neighbour_distance");
+    if (neighbourDistanceConfig != _config.end())
+    {
+        neighbourDistanceRel = std::stof(neighbourDistanceConfig->second);
+    }
+
+    int maxNeighbours = CROWD_MAX_NEIGHBOURS_DEFAULT;
+    auto const maxNeighboursConfig = _config.find("crowd_max_neighbours");
+    if (maxNeighboursConfig != _config.end())
+    {
+        maxNeighbours = std::stoi(maxNeighboursConfig->second);
+    }
+
+    // Time horizons are specified in frames
+    float timeHorizon = CROWD_TIME_HORIZON_DEFAULT;
+    auto const timeHorizonConfig = _config.find("crowd_time_horizon");
+    if (timeHorizonConfig != _config.end())
+    {
+        timeHorizon = std::max(std::stof(timeHorizonConfig->second), 1.f);
+    }
+
+    float obstacleTimeHorizon = CROWD_OBSTACLE_TIME_HORIZON_DEFAULT;
+    auto const obstacleTimeHorizonConfig = _config.find("crowd_obstacle_time_horizon");
+    if (obstacleTimeHorizonConfig != _config.end())
+    {
+        obstacleTimeHorizon = std::max(std::stof(obstacleTimeHorizonConfig->second), 1.f);
+    }
+
+    _crowdSolver.SetParameters(neighbourDistanceRel * _viewSize.x, maxNeighbours, timeHorizon, obstacleTimeHorizon);
+}
+
+void World::ConfigPotentiallyVisibleSet()
+{
+    auto const fileConfig = _wallsConfig.find("pvs_file");
+    auto const regionsConfig = _config.find("pvs_regions");
+    bool const buildConfigured = (regionsConfig != _config.end() && std::stoi(regionsConfig->second) > 0);
+
+    // Potentially visible sets are built for all the walls, while a chunked map has only some of them at a time
+    if (_chunkedMap.IsOpen() && (fileConfig != _wallsConfig.end() || buildConfigured))
+    {
+        throw std::runtime_error("Error: Potentially visible sets cannot be used with a chunked map.");
+    }
+
+    int const regionsPerSide = buildConfigured ? std::stoi(regionsConfig->second) : PotentiallyVisibleSet::REGIONS_PER_SIDE_DEFAULT;
+
+    // A set built offline for the map is preferred to building one at every start
+    if (fileConfig != _wallsConfig.end())
+    {
+        try
+        {
+            _potentiallyVisibleSet.Load(fileConfig->second);
+            if (_potentiallyVisibleSet.GetWallsCount() == _relWalls.size())
+            {
+                return;
+            }
+            std::cerr << "Warning: The potentially visible set " << fileConfig->second
+                << " was built for other walls, so it is built again." << std::endl;
+        }
+        catch (std::runtime_error const& e)
+        {
+            std::cerr << e.what() << " It is built again instead." << std::endl;
+        }
+        _potentiallyVisibleSet.Build(_relWalls, _wallPolygonInds, regionsPerSide);
+        return;
+    }
+
+    if (buildConfigured)
+    {
+        _potentiallyVisibleSet.Build(_relWalls, _wallPolygonInds, regionsPerSide);
+    }
+}
+
+void World::ConfigLineOfSightCache()
+{
+    _lineOfSightCellSizeRel = LINE_OF_SIGHT_CELL_SIZE_REL_DEFAULT;
+    auto const cellSizeConfig = _config.find("line_of_sight_cell_size");
+    if (cellSizeConfig != _config.end())
+    {
+        _lineOfSightCellSizeRel = std::stof(cellSizeConfig->second);
+        if (_lineOfSightCellSizeRel <= 0.f)
+        {
+            throw std::runtime_error("Error: The line of sight cell size must be positive.");
+        }
+    }
+
+    // A capacity of 0 turns the cache off
+    _lineOfSightCacheCapacity = LINE_OF_SIGHT_CACHE_CAPACITY_DEFAULT;
+    auto const capacityConfig = _config.find("line_of_sight_cache_capacity");
+    if (capacityConfig != _config.end())
+    {
+        _lineOfSightCacheCapacity = std::max(std::stoi(capacityConfig->second), 0);
+    }
+}
+
+void World::ConfigBullets()
+{
+    auto const wheelSizeConfig = _config.find("bullet_despawn_wheel_size");
+    if (wheelSizeConfig != _config.end())
+    {
+        _bulletSystem = BulletSystem(this, &_registry, std::stoi(wheelSizeConfig->second));
+    }
+
+    _bulletsCapacity = BULLETS_CAPACITY_DEFAULT;
+    auto const bulletsCapacityConfig = _config.find("bullets_capacity");
+    if (bulletsCapacityConfig != _config.end())
+    {
+        _bulletsCapacity = std::max(std::stoi(bulletsCapacityConfig->second), 0);
+    }
+}
+
+void World::ConfigStreaming()
+{
+    _streamingTilesCapacity = STREAMING_TILES_CAPACITY_DEFAULT;
+    auto const tilesCapacityConfig = _config.find("streaming_tiles_capacity");
+    if (tilesCapacityConfig != _config.end())
+    {
+        _streamingTilesCapacity = std::max(std::stoi(tilesCapacityConfig->second), 1);
+    }
+
+    _streamingPrefetchTiles = STREAMING_PREFETCH_TILES_DEFAULT;
+    auto const prefetchTilesConfig = _config.find("streaming_prefetch_tiles");
+    if (prefetchTilesConfig != _config.end())
+    {
+        _streamingPrefetchTiles = std::max(std::stoi(prefetchTilesConfig->second), 0);
+    }
+
+    _streamingDelayUpdates = STREAMING_DELAY_UPDATES_DEFAULT;
+    auto const delayUpdatesConfig = _config.find("streaming_delay_updates");
+    if (delayUpdatesConfig != _config.end())
+    {
+        _streamingDelayUpdates = std::max(std::stoi(delayUpdatesConfig->second), 0);
+    }
+    _streamingApplyFrame = -1;
+}
+
+void World::ConfigCamera()
+{
+    _worldScale = WORLD_SCALE_DEFAULT;
+    auto const worldScaleConfig = _config.find("world_scale");
+    if (worldScaleConfig != _config.end())
+    {
+        _worldScale = std::stof(worldScaleConfig->second);
+        if (_worldScale <= 0.f)
+        {
+            throw std::runtime_error("Error: The world's scale must be positive.");
+        }
+    }
+    _size = _viewSize * _worldScale;
+}
+
+void World::UpdateCamera()
+{
+    sf::Vector2f center = _registry.GetComponent<Transform>(_player).position;
+    center.x = (_size.x > _viewSize.x) ? std::clamp(center.x, _viewSize.x / 2.f, _size.x - _viewSize.x / 2.f) : _size.x / 2.f;
+    center.y = (_size.y > _viewSize.y) ? std::clamp(center.y, _viewSize.y / 2.f, _size.y - _viewSize.y / 2.f) : _size.y / 2.f;
+    _cameraView.setSize(_viewSize);
+    _cameraView.setCenter(center);
+}
+
+void World::SeparatePersons()
+{
+    ComponentArray<AiState> const& enemies = _registry.GetComponents<AiState>();
+    std::pmr::vector<Entity> persons(GetFrameMemory());
+    persons.reserve(enemies.GetSize() + 1);
+    persons.push_back(_player);
+    for (int i = 0; i < enemies.GetSize(); i++)
+    {
+        persons.push_back(enemies.GetEntityAt(i));
+    }
+
+    _personsBroadphase.Resize(persons.size());
+    for (int i = 0; i < persons.size(); i++)
+    {
+        sf::Vector2f const& pos = _registry.GetComponent<Transform>(persons[i]).position;
+        float const radius = _registry.GetComponent<Collider>(persons[i]).radius;
+        _personsBroadphase.SetBox(i, { pos.x - radius, pos.x + radius, pos.y - radius, pos.y + radius });
+    }
+
+    std::pmr::vector<std::pair<int, int>> pairs(GetFrameMemory());
+    _personsBroadphase.FindOverlappingPairs(pairs);
+
+    for (int pairInd = 0; pairInd < pairs.size(); pairInd++)
+    {
+        Entity const personA = persons[pairs[pairInd].first];
+        Entity const personB = persons[pairs[pairInd].second];
+
+        sf::Vector2f const fromAToB = GeometryUtils::GetVector(
+            _registry.GetComponent<Transform>(personA).position,
+            _registry.GetComponent<Transform>(personB).position
+        );
+        float const dist = GeometryUtils::GetVectorLength(fromAToB);
+        float const overlap = _registry.GetComponent<Collider>(personA).radius + _registry.GetComponent<Collider>(personB).radius - dist;
+        if (overlap <= 0.f)
+        {
+            continue;
+        }
+
+        // People at the exact same position are separated horizontally
+        sf::Vector2f const dir = (dist > 0.f) ? fromAToB / dist : sf::Vector2f(1.f, 0.f);
+        // People are pushed after they have been updated, so their guns have to catch up with them
+        if (_movementSystem.Push(personA, -dir * overlap / 2.f))
+        {
+            _weaponSystem.PointAtTarget(personA);
+        }
+        if (_movementSystem.Push(personB, dir * overlap / 2.f))
+        {
+            _weaponSystem.PointAtTarget(personB);
         }
     }
 }
@@ -169,9 +1185,9 @@ void World::SetBackgroundTexture(sf::Texture const* bgTex)
 
     _bgSprite.setTexture(*bgTex);
     // scale background sprite so that it spans the whole world
-    _bgSprite.scale(
-        _size.x / _bgSprite.getGlobalBounds().width,
-        _size.y / _bgSprite.getGlobalBounds().height
+    _bgSprite.setScale(
+        _size.x / _bgSprite.getLocalBounds().width,
+        _size.y / _bgSprite.getLocalBounds().height
     );
 }
 
@@ -183,13 +1199,79 @@ void World::SetWallTexture(sf::Texture const* wallTex)
         return;
     }
 
+    /* Parts of the same polygon from the config share a crop of the texture,
+       so that the texture continues seamlessly between them */
+    std::vector<sf::FloatRect> polygonBounds;
+    for (int wallInd = 0; wallInd < _walls.size(); wallInd++)
+    {
+        int const polygonInd = _wallPolygonInds[wallInd];
+        if (polygonInd >= polygonBounds.size())
+        {
+            polygonBounds.resize(polygonInd + 1, _walls[wallInd].getGlobalBounds());
+        }
+
+        sf::FloatRect& bounds = polygonBounds[polygonInd];
+        sf::FloatRect const wallBounds = _walls[wallInd].getGlobalBounds();
+        float const right = std::max(bounds.left + bounds.width, wallBounds.left + wallBounds.width);
+        float const bottom = std::max(bounds.top + bounds.height, wallBounds.top + wallBounds.height);
+        bounds.left = std::min(bounds.left, wallBounds.left);
+        bounds.top = std::min(bounds.top, wallBounds.top);
+        bounds.width = right - bounds.left;
+        bounds.height = bottom - bounds.top;
+    }
+
     for (int wallInd = 0; wallInd < _walls.size(); wallInd++)
     {
-        TextureUtils::SetTextureKeepRatio(
+        TextureUtils::SetTextureKeepRatioForPart(
             &_walls[wallInd],
-            wallTex
+            wallTex,
+            polygonBounds[_wallPolygonInds[wallInd]]
         );
     }
 }
 
+void World::RenderStaticLayer(sf::View const& view) const
+{
+    // The region is twice the view's size, but not bigger than the world, and it is placed in whole pixels inside the world
+    sf::Vector2u const layerSize(
+        (unsigned)std::ceil(std::min(2.f * view.getSize().x, _size.x)),
+        (unsigned)std::ceil(std::min(2.f * view.getSize().y, _size.y))
+    );
+    sf::Vector2f const layerPos(
+        std::floor(std::clamp(view.getCenter().x - layerSize.x / 2.f, 0.f, std::max(_size.x - layerSize.x, 0.f))),
+        std::floor(std::clamp(view.getCenter().y - layerSize.y / 2.f, 0.f, std::max(_size.y - layerSize.y, 0.f)))
+    );
+
+    // The render texture has to be (re)created only when the view's or the world's size changes
+    if (_staticLayer.getSize() != layerSize)
+    {
+        if (!_staticLayer.create(layerSize.x, layerSize.y))
+        {
+            throw std::runtime_error("Error: Cannot create render texture for the world's static layer.");
+        }
+        _staticLayerSprite.setTexture(_staticLayer.getTexture(), true);
+    }
+    _staticLayerRect = sf::FloatRect(layerPos, sf::Vector2f(layerSize));
+    _staticLayerSprite.setPosition(layerPos);
+    _staticLayer.setView(sf::View(_staticLayerRect));
+
+    _staticLayer.clear();
+
+    _staticLayer.draw(_bgSprite);
+    _staticLayerWalls.clear();
+    _wallGrid.FindWallsInBox(
+        {
+            _staticLayerRect.left, _staticLayerRect.left + _staticLayerRect.width,
+            _staticLayerRect.top, _staticLayerRect.top + _staticLayerRect.height
+        },
+        _staticLayerWalls
+    );
+    for (int i = 0; i < _staticLayerWalls.size(); i++)
+    {
+        _staticLayer.draw(_walls[_staticLayerWalls[i]]);
+    }
+
+    _staticLayer.display();
+}
+
 } // namespace HideAndSeekAndShoot
\ No newline at end of file
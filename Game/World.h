@@ -1,14 +1,30 @@
 #pragma once
 
-#include "Entities/Player.h"
-#include "Entities/Enemy.h"
-#include "Entities/Bullet.h"
+#include "Ecs/Components.h"
+#include "Entities/EntityFactory.h"
+#include "Systems/MovementSystem.h"
+#include "Systems/BulletSystem.h"
+#include "Systems/WeaponSystem.h"
+#include "Systems/AiSystem.h"
+#include "Systems/RenderSystem.h"
+
+#include "FrameArena.h"
+#include "Broadphase.h"
+#include "WallEdgeTable.h"
+#include "WallGrid.h"
+#include "CrowdSolver.h"
+#include "LineOfSightCache.h"
+#include "PotentiallyVisibleSet.h"
+#include "ChunkedMap.h"
+#include "RenderSnapshot.h"
 
 #include "resources/ResourceHandler.hpp"
 #include "resources/ResourceIDs.hpp"
 
 #include <SFML/Graphics.hpp>
 
+#include <cstdint>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -23,10 +39,22 @@ class Game;
 /**
  * A class representing the world in the game.
  * Keeps track of all the entities and handles control states.
+ * Entities are compositions of components kept in dense arrays, which the world's systems update in linear passes.
+ * The world can be larger than the window, in which case it is seen through a camera following the player,
+ * and only what is in the camera's view is drawn.
  */
 class World : public sf::Drawable
 {
 
+  public: /* types */
+
+    /// A circle, used for bounding walls
+    struct Circle
+    {
+        sf::Vector2f center;
+        float radius;
+    };
+
   public:
 
     /**
@@ -36,25 +64,138 @@ class World : public sf::Drawable
      *  Pointer to the game that creates the world
      * @param[in] texHandler
      *  Pointer to textre handler with loaded textures
+     * @param[in] frameArena
+     *  Pointer to the arena from which memory that lives only during a single frame should be allocated
+     * @param[in] size
+     *  Size of the view of the world, in pixels. The world is that many times bigger, as specified in the world's config.
+     * @param[in] configOverrides (optional)
+     *  Values replacing those of the world's config file, such as the number of enemies
+     * @param[in] wallsConfig (optional)
+     *  Config of the walls to use instead of the walls config file, or nullptr to read that file
      */
     World(
       Game const* game,
       Resources::ResourceHandler<Resources::Texture::Id, sf::Texture> const* texHandler,
-      sf::Vector2f size
+      FrameArena* frameArena,
+      sf::Vector2f size,
+      Config const& configOverrides = Config(),
+      Config const* wallsConfig = nullptr
     );
 
     /// Getter for world's size
     sf::Vector2f GetSize() const;
 
-    /// Generate walls according to the current world size
+    /**
+     * Returns the size of the view of the world, in pixels.
+     * Sizes of entities, their speeds and distances are relative to it, so they look the same however big the world is.
+     */
+    sf::Vector2f GetViewSize() const;
+
+    /// Returns the camera's view of the world, following the player as of the last update
+    sf::View const& GetCameraView() const;
+
+    /// Generate walls according to the current world size, and have the static layer re-rendered with them
     void GenerateWalls();
 
+    /**
+     * Resizes the view of the world, and the world with it, scaling everything in it to the new size.
+     * Walls are regenerated from their relative coordinates,
+     * and entities are rescaled in place, without recreating them or reading their configs again.
+     * 
+     * @param[in] size
+     *  New size of the view of the world, in pixels
+     */
+    void Resize(sf::Vector2f const size);
+
     /// Returns a pointer to the game owner/creater of the world
     Game const* GetGame() const;
 
-    /// Returns a vector of world's walls
+    /// Returns the seed of the world's random choices - where enemies are placed, and where they wander
+    unsigned GetSeed() const;
+
+    /// Returns the number of updates done so far, which is the tick of the update in progress, or of the next one between updates
+    int GetFrameCount() const;
+
+    /**
+     * Returns a vector of world's walls.
+     * Walls are always convex, and a concave wall from the config is split into a few convex walls.
+     */
     std::vector<sf::ConvexShape> const& GetWalls() const;
 
+    /// Returns the table of the walls' edges, with the same wall indices as the walls
+    WallEdgeTable const& GetWallEdges() const;
+
+    /// Returns a vector of circles bounding the world's walls, with the same indices as the walls
+    std::vector<Circle> const& GetWallBoundingCircles() const;
+
+    /// Returns the grid listing the walls near each part of the world, by their bounding circles
+    WallGrid const& GetWallGrid() const;
+
+    /**
+     * Checks whether the straight line between two points is not blocked by any of the walls
+     * 
+     * @param[in] pointA, pointB
+     *  End points of the line
+     * 
+     * @return true if no wall blocks the line, false otherwise
+     */
+    bool IsLineOfSightClear(sf::Vector2f const pointA, sf::Vector2f const pointB) const;
+
+    /**
+     * Finds the wall edge that a segment runs into first, as FindNearestCrossing of the table of the walls' edges.
+     * If the world has potentially visible sets, only the walls potentially visible from the segment's start are checked.
+     * 
+     * @param[in] pointA, pointB
+     *  Start and end points of the segment
+     * @param[out] fraction
+     *  Fraction of the segment from its start to the crossing, if there is one
+     * 
+     * @return index of the closest crossing edge, or -1 if no edge crosses the segment
+     */
+    int FindNearestWallCrossing(sf::Vector2f const pointA, sf::Vector2f const pointB, float& fraction) const;
+
+    /// Returns the counts of the line of sight queries answered by the line of sight cache, and of those cast through the walls
+    LineOfSightCache::Stats GetLineOfSightStats() const;
+
+    /**
+     * Returns the memory resource for containers that are thrown away in the same frame in which they are filled.
+     * Such memory is reclaimed at the beginning of the next frame, so it must not be kept after the current one.
+     */
+    std::pmr::memory_resource* GetFrameMemory() const;
+
+    /**
+     * Draws the part of the static layer of the world (background and walls) seen in a view.
+     * The static layer is cached for a region around the view, and re-rendered only when the view leaves the region,
+     * so this has to be called on the thread that renders. The walls it reads are replaced while the world is updated
+     * only when they are streamed, which is guarded by a mutex.
+     * 
+     * @param[in] target
+     *  RenderTarget object on which to draw the static layer
+     * @param[in] view
+     *  View of the world that is drawn
+     */
+    void DrawStaticLayer(sf::RenderTarget& target, sf::View const& view) const;
+
+    /**
+     * Fills a render snapshot with everything needed for drawing the world in the camera's view as it is now.
+     * Drawing the static layer and then the snapshot in its view gives the same picture as drawing the world,
+     * except that all fields of view are beneath all people.
+     * 
+     * @param[out] snapshot
+     *  Snapshot to fill
+     */
+    void TakeSnapshot(RenderSnapshot& snapshot) const;
+
+    /**
+     * Calculates a hash of the simulated state of the world - the positions and targets of all people and bullets,
+     * the enemies' AI states, timers, random generators, levels of detail and velocities, and the bullets' trajectories.
+     * Two runs whose hashes match on every update have simulated exactly the same game,
+     * so comparing the hashes of runs of different builds or on different machines proves they are deterministic.
+     * 
+     * @return 64-bit FNV-1a hash of the state
+     */
+    std::uint64_t CalcStateHash() const;
+
     /**
      * Updates world according to a control state
      * 
@@ -66,29 +207,161 @@ class World : public sf::Drawable
   private: /* functions */
 
     /**
-     * Draws the world on the given render target
+     * Draws the world on the given render target, skipping what is outside of the target's current view
      * 
      * @param[in] renderTarget
      *  RenderTarget object on which to draw the world
      */
     void draw(sf::RenderTarget& target, sf::RenderStates states) const;
 
-    /// Loads walls' relative coordinates from config file
+    /**
+     * Loads walls' relative coordinates from config file.
+     * Instead of listing the walls, the config can name a map generator style
+     * (with its number of walls, seed and passage width), or a binary map file.
+     * Walls can be any simple polygons, and they are split into convex walls at load time.
+     * The config can also name a chunked map file, whose walls are streamed around the player instead.
+     */
     void LoadRelWalls();
 
+    /// Reads walls' relative coordinates listed in the walls config, each as a polygon
+    std::vector<std::vector<sf::Vector2f>> ReadRelWallsFromConfig();
+
+    /**
+     * Generates walls' relative coordinates with the generator configured in the walls config.
+     * Unless the config specifies the passage width, it is the default one relative to the view,
+     * so it is narrower relative to a bigger world. Reports how many walls were made, if not as many as requested.
+     */
+    std::vector<std::vector<sf::Vector2f>> GenerateRelWalls() const;
+
+    /**
+     * Replaces the walls with the walls of the tiles of the chunked map around the player, if the world has one.
+     * Walls are needed where the static layer can be cached around the camera, and where enemies are not dormant.
+     * Tiles ahead in the direction the player moves are requested in advance, so that they are usually loaded when needed.
+     * When the needed tiles change, the loaded walls are kept for a fixed number of updates while the tiles load in the background,
+     * and then replaced, waiting for any tiles that haven't arrived yet, so the walls change at the same update in every run.
+     */
+    void StreamWalls();
+
+    /**
+     * Finds the tiles of the chunked map that a rectangle overlaps
+     * 
+     * @param[in] relRect
+     *  Rectangle relative to the world's size
+     * @param[out] tileInds
+     *  Indices of the tiles, in increasing order
+     * 
+     * @return area of the tiles, relative to the world's size
+     */
+    sf::FloatRect FindTilesInRect(sf::FloatRect const& relRect, std::pmr::vector<int>& tileInds) const;
+
+    /// Returns the area of the world where the walls are loaded - the streamed tiles, or the whole world without a chunked map
+    sf::FloatRect GetWallsArea() const;
+
+    /// Calculates the circles bounding the walls, from the walls' current coordinates
+    void CalcWallBoundingCircles();
+
+    /// Builds the grid of the walls, from their bounding circles
+    void BuildWallGrid();
+
+    /**
+     * Creates the enemies.
+     * The first enemy is at the position from its config, and the others are at random valid positions,
+     * not closer to the player than the spawn distance, so that the player isn't shot as soon as the game starts.
+     */
+    void CreateEnemies();
+
+    /// Updates the enemies that have to be updated in the current frame, according to their level of detail
+    void UpdateEnemies();
+
+    /**
+     * Moves the enemies updated in the current frame with crowd steering, so that they avoid each other and the player.
+     * Enemies that are not updated in the current frame stand still, and the player keeps its velocity,
+     * so the updated enemies avoid them fully on their own.
+     * 
+     * @param[in] updatedEnemies
+     *  Indices of the enemies updated in the current frame, in the array of the AI states
+     */
+    void SteerEnemies(std::pmr::vector<int> const& updatedEnemies);
+
+    /// Calculates the level of detail with which an enemy at a position should be simulated
+    LodTier CalcLodTier(sf::Vector2f const position) const;
+
+    /// Returns the number of frames between two updates of an enemy with the given level of detail
+    int GetLodInterval(LodTier tier) const;
+
+    /// Configures the number of enemies, the seed, the spawn distance and the levels of detail, as specified in the world's config
+    void ConfigEnemies();
+
+    /// Configures whether enemies are moved with crowd steering, and its parameters, as specified in the world's config
+    void ConfigCrowdSteering();
+
+    /**
+     * Loads the potentially visible sets of the walls from the file named in the walls config,
+     * or builds them if the world's config asks for them. Otherwise the world has none.
+     * A file that is corrupt, or was built for other walls, is reported and the sets are built instead.
+     */
+    void ConfigPotentiallyVisibleSet();
+
+    /// Configures the size of the line of sight cache's cells and its capacity, as specified in the world's config
+    void ConfigLineOfSightCache();
+
+    /// Configures the number of tiles of a chunked map kept loaded and loaded in advance, as specified in the world's config
+    void ConfigStreaming();
+
+    /**
+     * Configures the number of ticks in a turn of the bullets' despawn wheel,
+     * and the number of bullets for which room is reserved, as specified in the world's config
+     */
+    void ConfigBullets();
+
+    /// Configures how many times the world is bigger than its view, as specified in the world's config, and sets the world's size
+    void ConfigCamera();
+
+    /**
+     * Moves the camera to the player, keeping the view inside of the world.
+     * A world smaller than the view is centered in it.
+     */
+    void UpdateCamera();
+
+    /**
+     * Separates people that overlap each other, by pushing each one of a pair half of the way out of the other.
+     * Pairs that can overlap are found with a broadphase, and only they are checked exactly.
+     */
+    void SeparatePersons();
+
     /// Setter for the background of the world
     void SetBackgroundTexture(sf::Texture const* bgTex);
 
     /// Setter for the texture used for walls
     void SetWallTexture(sf::Texture const* wallTex);
 
+    /**
+     * Renders the static layer of the world (background and walls) into the static layer cache,
+     * for a region around a view that is twice its size, so that the view can move a while before it has to be re-rendered.
+     * Only the walls in the region are drawn, found with the grid of the walls.
+     * Things in the static layer never move, so it has to be re-rendered only when they are regenerated or the view leaves the region.
+     * 
+     * @param[in] view
+     *  View around which to render
+     */
+    void RenderStaticLayer(sf::View const& view) const;
+
   private: /* variables */
     
     /// Game object that is an owner/creater of this world
     Game const* _game;
 
+    /// Arena for memory that lives only during a single frame
+    FrameArena* _frameArena;
+
     /// Size of the world, in pixels
     sf::Vector2f _size;
+    /// Size of the view of the world, in pixels
+    sf::Vector2f _viewSize;
+    /// How many times the world is bigger than its view
+    float _worldScale;
+    /// Camera's view of the world
+    sf::View _cameraView;
 
     /// Sprite for the background of the world
     sf::Sprite _bgSprite;
@@ -97,19 +370,112 @@ class World : public sf::Drawable
     std::vector<sf::ConvexShape> _walls;
     /// Vector of walls coordinates relative to the size of the world
     std::vector<std::vector<sf::Vector2f>> _relWalls;
+    /// For each wall, index of the polygon from the config that it is a part of
+    std::vector<int> _wallPolygonInds;
+    /// Table of the walls' edges, for geometric queries against the walls
+    WallEdgeTable _wallEdges;
     /// Config for walls' relative coordinates
     Config _wallsConfig;
     /// Pointer to a loaded texture to be used for walls
     sf::Texture const* _wallTex;
+    /// Vector of circles bounding the walls, used for coarse collisions
+    std::vector<Circle> _wallBoundingCircles;
+    /// Grid of the walls, by the boxes of their bounding circles, which contain both the walls and the circles
+    WallGrid _wallGrid;
+    /**
+     * Cache of the walls that can block lines of sight between cells of the world, reset whenever the walls are regenerated.
+     * Filling it doesn't change any answer, so it is mutable for the line of sight queries.
+     */
+    mutable LineOfSightCache _lineOfSightCache;
+    /// Potentially visible sets of the walls, in regions of the world, or an empty set if there are none
+    PotentiallyVisibleSet _potentiallyVisibleSet;
+    /// Side of the line of sight cache's cells, relative to the view's width
+    float _lineOfSightCellSizeRel;
+    /// Maximal number of pairs of cells in the line of sight cache
+    int _lineOfSightCacheCapacity;
+    /// Map whose walls are streamed from disk in tiles, or a map that is not open if the walls are all loaded at once
+    ChunkedMap _chunkedMap;
+    /// Number of tiles of the chunked map kept loaded
+    int _streamingTilesCapacity;
+    /// Number of tiles in the direction the player moves that are loaded in advance
+    int _streamingPrefetchTiles;
+    /// Number of updates from when the needed tiles change until the walls are replaced with theirs
+    int _streamingDelayUpdates;
+    /// Frame at which the walls are replaced with the walls of the needed tiles, or -1 if the needed tiles are the streamed ones
+    int _streamingApplyFrame;
+    /// Indices of the tiles whose walls are the world's walls, in increasing order
+    std::vector<int> _streamedTiles;
+    /// Area of the streamed tiles, relative to the world's size
+    sf::FloatRect _streamedRelArea;
+    /// Position of the player when the walls were last streamed, for finding the direction it moves
+    sf::Vector2f _streamingPlayerPosition;
+
+    /// Config for the world's entities
+    Config _config;
+
+    /* Render texture caching the static layer of the world - the background and the walls - in a region around the view.
+       It is re-rendered when it is drawn, so it is mutable, as are the things used for rendering it. */
+    mutable sf::RenderTexture _staticLayer;
+    /// Sprite for drawing the cached static layer, as a single quad
+    mutable sf::Sprite _staticLayerSprite;
+    /// Region of the world cached in the static layer, empty if it has to be re-rendered
+    mutable sf::FloatRect _staticLayerRect;
+    /// Indices of the walls in the cached region, kept so that re-rendering doesn't allocate
+    mutable std::pmr::vector<int> _staticLayerWalls;
+    /// Mutex guarding the walls while the static layer is rendered, since streamed walls are replaced while the world is updated
+    mutable std::mutex _staticLayerMutex;
+
+    /// Registry of the world's entities, keeping each kind of component in a dense array
+    EntityRegistry _registry;
+    /// System moving the people
+    MovementSystem _movementSystem;
+    /// System of the bullets, which moves them and despawns them when they exit
+    BulletSystem _bulletSystem;
+    /// System pointing the people and their guns towards their targets, and shooting
+    WeaponSystem _weaponSystem;
+    /// System of the enemies' AI
+    AiSystem _aiSystem;
+    /// System drawing the entities
+    RenderSystem _renderSystem;
+    /// Factory composing the people out of components
+    EntityFactory _entityFactory;
+
+    /// The player's entity
+    Entity _player;
+
+    /// Number of bullets for which room is reserved, so that shooting doesn't allocate until there are more of them at once
+    int _bulletsCapacity;
+
+    /// Number of enemies in the world
+    int _enemiesCount;
+
+    /// Seed of the world's random choices
+    unsigned _seed;
+
+    /// Enemies are placed at least this far from where the player starts, in pixels
+    float _enemySpawnDistance;
+
+    /// Enemies closer than this distance to the player are simulated in full detail, in pixels
+    float _lodNearDistance;
+    /// Enemies further than this distance from the player are dormant, in pixels
+    float _lodFarDistance;
+    /// Number of frames between two updates of an enemy with reduced detail
+    int _lodReducedInterval;
+    /// Number of frames between two updates of a dormant enemy
+    int _lodDormantInterval;
 
-    /// Player object for the player's entity
-    std::unique_ptr<Player> _player;
+    /// Number of the current frame
+    int _frameCount;
 
-    /// Enemy object for the enemy's entity
-    std::unique_ptr<Enemy> _enemy;
+    /// Broadphase for finding people that can overlap each other - the player has index 0, and enemies follow it
+    Broadphase _personsBroadphase;
 
-    /// List of currently existing bullets (TODO: maybe use linked list instead of vector)
-    std::vector<std::unique_ptr<Bullet>> _bullets;
+    /// Whether enemies are moved with crowd steering, instead of each going around obstacles on its own
+    bool _crowdSteering;
+    /// Solver of the crowd steering
+    CrowdSolver _crowdSolver;
+    /// Position of the player in the previous frame, for estimating its velocity
+    sf::Vector2f _lastPlayerPosition;
 };
 
 } // namespace HideAndSeekAndShoot
\ No newline at end of file
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <chrono>
+#include <future>
 #include <memory>
 #include <string>
 #include <map>
@@ -11,6 +16,42 @@ namespace HideAndSeekAndShoot
 namespace Resources
 {
 
+/**
+ * Describes how a resource type can be loaded asynchronously.
+ * The loading is split into two steps:
+ *  - decoding the file into some intermediate data, which can be done on any thread
+ *  - uploading that data into the resource, which has to be done on the thread that owns the resource
+ *    (for example textures need to be uploaded on the thread with the active OpenGL context)
+ * Only resource types with a specialization of this template can be loaded asynchronously.
+ * 
+ * @param[in] ResourceType
+ *  The type of the resources that will be loaded
+ */
+template <class ResourceType>
+struct AsyncLoadTraits;
+
+/// Textures are decoded into an image in the background and uploaded to the GPU afterwards
+template <>
+struct AsyncLoadTraits<sf::Texture>
+{
+    typedef sf::Image DecodedType;
+
+    static DecodedType Decode(std::string const& filename)
+    {
+        sf::Image image;
+        if (!image.loadFromFile(filename))
+        {
+            throw std::runtime_error("Error: Cannot load resource from file " + filename);
+        }
+        return image;
+    }
+
+    static bool Upload(sf::Texture& texture, DecodedType const& image)
+    {
+        return texture.loadFromImage(image);
+    }
+};
+
 /**
  * A template class for handling SFML resources, such as textures, sound effects and fonts.
  * The user of the class can load resources from files,
@@ -41,6 +82,31 @@ class ResourceHandler
         std::string const& filename
     );
 
+    /**
+     * Starts loading a resource for an ID from a file in the background.
+     * The file is decoded on a separate thread, so many resources can be decoded in parallel.
+     * Until it is uploaded with UploadReady() the resource is an empty placeholder,
+     * but it can already be retrieved with Get() and it will stay at the same address after the upload.
+     * 
+     * @param[in] id
+     *  Id of the resource that we want to load
+     * @param[in] filename
+     *  Name of the file where the resource is located
+     */
+    void LoadAsync(
+        ResourceIdType id,
+        std::string const& filename
+    );
+
+    /**
+     * Uploads all resources that have finished decoding in the background.
+     * Has to be called on the thread that owns the resources (for textures that is the thread with the window).
+     * Does not block, so it can be called each frame until everything is loaded.
+     * 
+     * @return true when there are no more resources waiting to be loaded, false otherwise
+     */
+    bool UploadReady();
+
     /**
      * Returns a reference to the resource with the requested Id.
      * Note that the resource at that Id should be loaded first.
@@ -61,6 +127,13 @@ class ResourceHandler
       ResourceIdType,
       std::unique_ptr<ResourceType>
     > _resourceMap;
+
+    /* Map of the resources that are still being decoded in the background.
+       Maps each resource Id with the future result of the decoding. */
+    std::map<
+      ResourceIdType,
+      std::future<typename AsyncLoadTraits<ResourceType>::DecodedType>
+    > _pendingMap;
 };
 
 // RIDT = ResourceIdType, RT = ResourceType
@@ -78,6 +151,45 @@ void ResourceHandler<RIDT, RT>::Load(
     _resourceMap.insert(std::make_pair(id, std::move(resource)));
 }
 
+// RIDT = ResourceIdType, RT = ResourceType
+template <class RIDT, class RT>
+void ResourceHandler<RIDT, RT>::LoadAsync(
+    RIDT id,
+    std::string const& filename)
+{
+    // Insert an empty placeholder right away, so that the resource has a stable address
+    _resourceMap.insert(std::make_pair(id, std::make_unique<RT>()));
+
+    _pendingMap[id] = std::async(
+        std::launch::async,
+        &AsyncLoadTraits<RT>::Decode,
+        filename
+    );
+}
+
+// RIDT = ResourceIdType, RT = ResourceType
+template <class RIDT, class RT>
+bool ResourceHandler<RIDT, RT>::UploadReady()
+{
+    for (auto pending = _pendingMap.begin(); pending != _pendingMap.end();)
+    {
+        if (pending->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++pending;
+            continue;
+        }
+
+        // get() rethrows if the decoding has failed on the background thread
+        if (!AsyncLoadTraits<RT>::Upload(*_resourceMap.at(pending->first), pending->second.get()))
+        {
+            throw std::runtime_error("Error: Cannot upload loaded resource.");
+        }
+        pending = _pendingMap.erase(pending);
+    }
+
+    return _pendingMap.empty();
+}
+
 /*
 // RIDT = ResourceIdType, RT = ResourceType
 template <class RIDT, class RT>
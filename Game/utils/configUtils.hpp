@@ -1,5 +1,7 @@
 /* only meant to be included in source files */
 
+#include "../AllocationTracker.h"
+
 #include <fstream>
 #include <string>
 #include <map>
@@ -30,6 +32,8 @@ char const CONFIG_FILE_SEPARATOR = '=';
  */
 Config ReadConfig(std::string const& filename)
 {
+    HideAndSeekAndShoot::AllocationTag tag("Config");
+
     // Open config file
     std::ifstream file(filename);
     if (!file.is_open())
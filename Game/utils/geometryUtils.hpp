@@ -4,6 +4,7 @@
 
 #include <SFML/Graphics.hpp>
 
+#include <algorithm>
 #include <cmath>
 
 namespace
@@ -357,18 +358,89 @@ bool SegmentIntersectsCircle(
 }
 
 /**
- * Rotates the vector by some angle
+ * Checks if a line segment intersects an axis-aligned rectangle.
+ * Used as a cheap test before testing the segment against the actual shape inside the rectangle.
+ * 
+ * @param[in] A
+ *  First end point of the line segment
+ * @param[in] B
+ *  Second end point of the line segment
+ * @param[in] rect
+ *  The rectangle
+ * 
+ * @return true if segment intersects or is inside the rectangle, false otherwise
+ */
+bool SegmentIntersectsRect(
+    sf::Vector2f const A,
+    sf::Vector2f const B,
+    sf::FloatRect const& rect)
+{
+    // Clipping the segment's parameter range by the rectangle's slabs, first the vertical one and then the horizontal
+    float tMin = 0.f, tMax = 1.f;
+    float const start[2] = { A.x, A.y };
+    float const delta[2] = { B.x - A.x, B.y - A.y };
+    float const rectMin[2] = { rect.left, rect.top };
+    float const rectMax[2] = { rect.left + rect.width, rect.top + rect.height };
+    for (int axis = 0; axis < 2; axis++)
+    {
+        if (delta[axis] == 0.f)
+        {
+            if (start[axis] < rectMin[axis] || start[axis] > rectMax[axis])
+            {
+                return false;
+            }
+            continue;
+        }
+
+        float t0 = (rectMin[axis] - start[axis]) / delta[axis];
+        float t1 = (rectMax[axis] - start[axis]) / delta[axis];
+        if (t0 > t1)
+        {
+            std::swap(t0, t1);
+        }
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        if (tMin > tMax)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Finds the smallest axis-aligned rectangle containing two rectangles
+ * 
+ * @param[in] rectA, rectB
+ *  The rectangles
+ * 
+ * @return rectangle containing both of them
+ */
+sf::FloatRect UniteRects(
+    sf::FloatRect const& rectA,
+    sf::FloatRect const& rectB)
+{
+    float const left = std::min(rectA.left, rectB.left);
+    float const top = std::min(rectA.top, rectB.top);
+    float const right = std::max(rectA.left + rectA.width, rectB.left + rectB.width);
+    float const bottom = std::max(rectA.top + rectA.height, rectB.top + rectB.height);
+    return sf::FloatRect(left, top, right - left, bottom - top);
+}
+
+/**
+ * Rotates the vector by an angle given by its cosine and sine.
+ * Useful for rotating by the same angles many times, without calculating them again.
  * 
  * @param[in] vec
- *  Vectore to rotate
- * @param[in] deltaAngle
- *  Angle by which the vector will be rotated, in radians
+ *  Vector to rotate
+ * @param[in] cosDelta, sinDelta
+ *  Cosine and sine of the angle by which the vector will be rotated
  * 
  * @return resulting vector after rotation
  */
-sf::Vector2f RotateVector(sf::Vector2f const vec, float deltaAngle)
+sf::Vector2f RotateVector(sf::Vector2f const vec, float cosDelta, float sinDelta)
 {
-    float cosDelta = cos(deltaAngle), sinDelta = sin(deltaAngle);
     float const &cosAngle = vec.x, &sinAngle = vec.y;
 
     return sf::Vector2f(
@@ -377,6 +449,21 @@ sf::Vector2f RotateVector(sf::Vector2f const vec, float deltaAngle)
     );
 }
 
+/**
+ * Rotates the vector by some angle
+ * 
+ * @param[in] vec
+ *  Vectore to rotate
+ * @param[in] deltaAngle
+ *  Angle by which the vector will be rotated, in radians
+ * 
+ * @return resulting vector after rotation
+ */
+sf::Vector2f RotateVector(sf::Vector2f const vec, float deltaAngle)
+{
+    return RotateVector(vec, cos(deltaAngle), sin(deltaAngle));
+}
+
 } // namespace Geometry
 
 } // namespace
\ No newline at end of file
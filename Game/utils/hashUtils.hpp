@@ -0,0 +1,68 @@
+#pragma once
+
+/* Helper functions for hashing the simulated state, with the 64-bit FNV-1a hash.
+   Values are hashed by their bits, so that even the smallest difference between runs changes the hash. */
+
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace
+{
+
+namespace HashUtils
+{
+
+// Parameters of the 64-bit FNV-1a hash
+std::uint64_t const FNV_OFFSET_BASIS = 14695981039346656037ull;
+std::uint64_t const FNV_PRIME = 1099511628211ull;
+
+/**
+ * Adds bytes to a hash
+ * 
+ * @param[in,out] hash
+ *  The hash, starting from FNV_OFFSET_BASIS
+ * @param[in] data, size
+ *  The bytes
+ */
+void HashBytes(std::uint64_t& hash, void const* data, std::size_t size)
+{
+    unsigned char const* bytes = static_cast<unsigned char const*>(data);
+    for (std::size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+}
+
+/**
+ * Adds a value to a hash, by the bytes of its representation
+ * 
+ * @param[in,out] hash
+ *  The hash
+ * @param[in] value
+ *  The value, which must not have padding bytes
+ */
+template <typename T>
+void HashValue(std::uint64_t& hash, T const& value)
+{
+    HashBytes(hash, &value, sizeof(value));
+}
+
+/**
+ * Adds a vector to a hash, by the bits of its coordinates
+ * 
+ * @param[in,out] hash
+ *  The hash
+ * @param[in] vec
+ *  The vector
+ */
+void HashVector(std::uint64_t& hash, sf::Vector2f const vec)
+{
+    float const coords[2] = { vec.x, vec.y };
+    HashBytes(hash, coords, sizeof(coords));
+}
+
+} // namespace HashUtils
+
+} // namespace
@@ -0,0 +1,272 @@
+#pragma once
+
+/* Some polygon helper functions */
+
+#include <SFML/Graphics.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+namespace PolygonUtils
+{
+
+/**
+ * Calculates the cross product of vectors AB and AC.
+ * It is positive if C is on the one side of line AB, negative if it's on the other, and 0 if it's on the line.
+ * 
+ * @param[in] A, B, C
+ *  The three points
+ * 
+ * @return the cross product
+ */
+float Cross(
+    sf::Vector2f const A,
+    sf::Vector2f const B,
+    sf::Vector2f const C)
+{
+    return (B.x - A.x) * (C.y - A.y) - (B.y - A.y) * (C.x - A.x);
+}
+
+/**
+ * Calculates the signed area of a polygon.
+ * The sign depends on the order of the polygon's vertices - positive for one order and negative for the opposite.
+ * 
+ * @param[in] polygon
+ *  Vertices of the polygon, in order
+ * 
+ * @return signed area of the polygon
+ */
+float CalcSignedArea(std::vector<sf::Vector2f> const& polygon)
+{
+    float area = 0.f;
+    for (int i = 0; i < polygon.size(); i++)
+    {
+        sf::Vector2f const& A = polygon[i];
+        sf::Vector2f const& B = polygon[(i + 1) % polygon.size()];
+        area += A.x * B.y - B.x * A.y;
+    }
+    return area / 2.f;
+}
+
+/**
+ * Checks if a polygon given by indices of points is convex.
+ * The polygon's vertices have to be in the order for which the signed area is positive.
+ * 
+ * @param[in] points
+ *  All points
+ * @param[in] polygon
+ *  Indices of the polygon's vertices, in order
+ * 
+ * @return true if the polygon is convex, false otherwise
+ */
+bool IsConvex(std::vector<sf::Vector2f> const& points, std::vector<int> const& polygon)
+{
+    for (int i = 0; i < polygon.size(); i++)
+    {
+        if (Cross(
+                points[polygon[i]],
+                points[polygon[(i + 1) % polygon.size()]],
+                points[polygon[(i + 2) % polygon.size()]]
+            ) < 0.f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks if a point is inside a triangle or on its border.
+ * The triangle's vertices have to be in the order for which the signed area is positive.
+ * 
+ * @param[in] P
+ *  The point
+ * @param[in] A, B, C
+ *  Vertices of the triangle
+ * 
+ * @return true if the point is inside the triangle, false otherwise
+ */
+bool IsPointInTriangle(
+    sf::Vector2f const P,
+    sf::Vector2f const A,
+    sf::Vector2f const B,
+    sf::Vector2f const C)
+{
+    return Cross(A, B, P) >= 0.f && Cross(B, C, P) >= 0.f && Cross(C, A, P) >= 0.f;
+}
+
+/**
+ * Splits a simple polygon into triangles, by clipping its ears one by one.
+ * 
+ * @param[in] points
+ *  Vertices of the polygon, in the order for which the signed area is positive
+ * 
+ * @return the triangles, as indices of the polygon's vertices, in the same order as the polygon
+ */
+std::vector<std::vector<int>> Triangulate(std::vector<sf::Vector2f> const& points)
+{
+    std::vector<int> remaining(points.size());
+    for (int i = 0; i < points.size(); i++)
+    {
+        remaining[i] = i;
+    }
+
+    std::vector<std::vector<int>> triangles;
+    while (remaining.size() > 3)
+    {
+        bool earFound = false;
+        for (int i = 0; i < remaining.size() && !earFound; i++)
+        {
+            int const prev = remaining[(i + remaining.size() - 1) % remaining.size()];
+            int const curr = remaining[i];
+            int const next = remaining[(i + 1) % remaining.size()];
+
+            // An ear has a convex vertex, and no other vertex inside of it
+            if (Cross(points[prev], points[curr], points[next]) <= 0.f)
+            {
+                continue;
+            }
+            bool isEar = true;
+            for (int j = 0; j < remaining.size() && isEar; j++)
+            {
+                int const other = remaining[j];
+                if (other != prev && other != curr && other != next
+                    && IsPointInTriangle(points[other], points[prev], points[curr], points[next]))
+                {
+                    isEar = false;
+                }
+            }
+            if (!isEar)
+            {
+                continue;
+            }
+
+            triangles.push_back({ prev, curr, next });
+            remaining.erase(remaining.begin() + i);
+            earFound = true;
+        }
+
+        // Every simple polygon has an ear, so if there is none, the polygon is not simple
+        if (!earFound)
+        {
+            throw std::runtime_error("Error: Cannot triangulate a polygon that is not simple.");
+        }
+    }
+    triangles.push_back(remaining);
+
+    return triangles;
+}
+
+/**
+ * Merges two convex polygons along a shared edge, if the result is convex too.
+ * 
+ * @param[in] points
+ *  All points
+ * @param[in] polygonA, polygonB
+ *  Indices of the polygons' vertices, in the order for which the signed area is positive
+ * @param[out] merged
+ *  The merged polygon, if the polygons could be merged
+ * 
+ * @return true if the polygons were merged, false otherwise
+ */
+bool TryMergeConvex(
+    std::vector<sf::Vector2f> const& points,
+    std::vector<int> const& polygonA,
+    std::vector<int> const& polygonB,
+    std::vector<int>& merged)
+{
+    // A shared edge goes from U to V in polygon A, and from V to U in polygon B
+    for (int i = 0; i < polygonA.size(); i++)
+    {
+        int const U = polygonA[i];
+        int const V = polygonA[(i + 1) % polygonA.size()];
+        for (int j = 0; j < polygonB.size(); j++)
+        {
+            if (polygonB[j] != V || polygonB[(j + 1) % polygonB.size()] != U)
+            {
+                continue;
+            }
+
+            // Going around polygon A from V to U, and then around polygon B from after U to before V
+            merged.clear();
+            for (int k = 0; k < polygonA.size(); k++)
+            {
+                merged.push_back(polygonA[(i + 1 + k) % polygonA.size()]);
+            }
+            for (int k = 2; k < polygonB.size(); k++)
+            {
+                merged.push_back(polygonB[(j + k) % polygonB.size()]);
+            }
+
+            return IsConvex(points, merged);
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Splits a simple polygon, that may be concave, into convex polygons.
+ * The polygon is triangulated first, and then triangles are merged back together
+ * along their shared edges, for as long as the merged polygons stay convex (Hertel-Mehlhorn).
+ * The result has at most four times more polygons than the fewest possible, and usually is much closer than that.
+ * 
+ * @param[in] polygon
+ *  Vertices of the polygon, in order
+ * 
+ * @return the convex polygons, each in the same order as the given polygon
+ */
+std::vector<std::vector<sf::Vector2f>> DecomposeIntoConvex(std::vector<sf::Vector2f> const& polygon)
+{
+    // Work with the vertices in the order in which the signed area is positive
+    bool const reversed = CalcSignedArea(polygon) < 0.f;
+    std::vector<sf::Vector2f> points(polygon);
+    if (reversed)
+    {
+        std::reverse(points.begin(), points.end());
+    }
+
+    std::vector<std::vector<int>> parts = Triangulate(points);
+
+    std::vector<int> merged;
+    bool mergedAny = true;
+    while (mergedAny)
+    {
+        mergedAny = false;
+        for (int a = 0; a < parts.size() && !mergedAny; a++)
+        {
+            for (int b = a + 1; b < parts.size() && !mergedAny; b++)
+            {
+                if (TryMergeConvex(points, parts[a], parts[b], merged))
+                {
+                    parts[a] = merged;
+                    parts.erase(parts.begin() + b);
+                    mergedAny = true;
+                }
+            }
+        }
+    }
+
+    std::vector<std::vector<sf::Vector2f>> convexPolygons(parts.size());
+    for (int partInd = 0; partInd < parts.size(); partInd++)
+    {
+        for (int i = 0; i < parts[partInd].size(); i++)
+        {
+            convexPolygons[partInd].push_back(points[parts[partInd][i]]);
+        }
+        if (reversed)
+        {
+            std::reverse(convexPolygons[partInd].begin(), convexPolygons[partInd].end());
+        }
+    }
+
+    return convexPolygons;
+}
+
+} // namespace PolygonUtils
+
+} // namespace
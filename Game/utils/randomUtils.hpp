@@ -0,0 +1,71 @@
+#pragma once
+
+/* Random helper functions that give the same results with every standard library.
+   The standard's random engines are exactly specified, but its distributions and std::shuffle are not,
+   so the same seed could give a different world with a different compiler. */
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+namespace RandomUtils
+{
+
+/**
+ * Generates a random float uniformly distributed in [min, max)
+ * 
+ * @param[in,out] rng
+ *  Random engine to use
+ * @param[in] min, max
+ *  Range of the generated value
+ * 
+ * @return the generated value
+ */
+float UniformFloat(std::mt19937& rng, float min, float max)
+{
+    // The top 24 bits fill exactly the mantissa of a float in [0, 1)
+    float const unit = (float)(rng() >> 8) * (1.f / 16777216.f);
+    return min + (max - min) * unit;
+}
+
+/**
+ * Generates a random integer uniformly distributed in [min, max]
+ * 
+ * @param[in,out] rng
+ *  Random engine to use
+ * @param[in] min, max
+ *  Range of the generated value, inclusive
+ * 
+ * @return the generated value
+ */
+int UniformInt(std::mt19937& rng, int min, int max)
+{
+    // Scaling a 32-bit random value to the range, with a bias that is negligible for small ranges
+    std::uint64_t const range = (std::uint64_t)(max - min) + 1;
+    return min + (int)(((std::uint64_t)rng() * range) >> 32);
+}
+
+/**
+ * Shuffles a vector randomly (Fisher-Yates)
+ * 
+ * @param[in,out] values
+ *  Vector to shuffle
+ * @param[in,out] rng
+ *  Random engine to use
+ */
+template <typename T>
+void Shuffle(std::vector<T>& values, std::mt19937& rng)
+{
+    for (int i = (int)values.size() - 1; i > 0; i--)
+    {
+        std::swap(values[i], values[UniformInt(rng, 0, i)]);
+    }
+}
+
+} // namespace RandomUtils
+
+} // namespace
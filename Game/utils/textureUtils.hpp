@@ -8,6 +8,40 @@ namespace
 namespace TextureUtils
 {
 
+/**
+ * Calculates how much a crop from a texture has to be scaled down,
+ * so that it stays within the texture.
+ * 
+ * @param[in] cropSize
+ *  Size of the crop before scaling
+ * @param[in] tex
+ *  Pointer to the texture from which we are cropping
+ * @param[in] cropPosition
+ *  Upper-left corner of the cropped rectangle from the texture
+ * 
+ * @return scale for the crop, at most 1
+ */
+float CalcCropScale(
+    sf::Vector2i const& cropSize,
+    sf::Texture const* tex,
+    sf::Vector2i const& cropPosition)
+{
+    float scale = 1.f;
+    // If the crop width goes beyond the texture
+    if (cropSize.x > tex->getSize().x - cropPosition.x)
+    {
+        // scale down the crop, so that the crop width matches the end of the texture
+        scale = (float)(tex->getSize().x - cropPosition.x) / cropSize.x;
+    }
+    // If after the first scale, the crop height still goes beyond the texture
+    if (scale * cropSize.y > tex->getSize().y - cropPosition.y)
+    {
+        // scale down the crop again, so that the crop height matches the end of the texture
+        scale *= (float)(tex->getSize().y - cropPosition.y) / (scale * cropSize.y);
+    }
+    return scale;
+}
+
 /**
  * Sets the texture to the shape keeping the texture's ratio.
  * For cases when the ratio of the shape's bounding rectangle
@@ -47,19 +81,7 @@ void SetTextureKeepRatio(
     );
 
     // Scale down crop, if needed
-    float scale = 1.f;
-    // If the crop width goes beyond the texture
-    if (cropRect.width > tex->getSize().x - cropPosition.x)
-    {
-        // scale down the crop, so that the crop width matches the end of the texture
-        scale = (float)(tex->getSize().x - cropPosition.x) / cropRect.width;
-    }
-    // If after the first scale, the crop height still goes beyond the texture
-    if (scale * cropRect.height > tex->getSize().y - cropPosition.y)
-    {
-        // scale down the crop again, so that the crop height matches the end of the texture
-        scale *= (float)(tex->getSize().y - cropPosition.y) / (scale * cropRect.height);
-    }
+    float const scale = CalcCropScale(sf::Vector2i(cropRect.width, cropRect.height), tex, cropPosition);
 
     // Perform the scale on the crop
     cropRect.width = scale * cropRect.width;
@@ -69,6 +91,40 @@ void SetTextureKeepRatio(
     shape->setTextureRect(cropRect);
 }
 
+/**
+ * Sets the texture to a shape that is a part of a bigger whole,
+ * so that the texture is cropped for the whole as with SetTextureKeepRatio,
+ * and each part gets its own piece of that crop. This way the texture continues seamlessly between the parts.
+ * 
+ * @param[in] shape
+ *  Pointer to the shape on which we want to set the texture
+ * @param[in] tex
+ *  Pointer to the texture that we want to set
+ * @param[in] wholeBounds
+ *  Bounding rectangle of the whole that the shape is a part of
+ */
+void SetTextureKeepRatioForPart(
+    sf::Shape* shape,
+    sf::Texture const* tex,
+    sf::FloatRect const& wholeBounds)
+{
+    shape->setTexture(tex);
+
+    float const scale = CalcCropScale(
+        sf::Vector2i((int)wholeBounds.width, (int)wholeBounds.height),
+        tex,
+        {0, 0}
+    );
+
+    sf::FloatRect const partBounds = shape->getLocalBounds();
+    shape->setTextureRect(sf::IntRect(
+        (int)(scale * (partBounds.left - wholeBounds.left)),
+        (int)(scale * (partBounds.top - wholeBounds.top)),
+        (int)(scale * partBounds.width),
+        (int)(scale * partBounds.height)
+    ));
+}
+
 } // namespace TextureUtils
 
 } // namespace
\ No newline at end of file
@@ -1,9 +1,207 @@
 #include "Game/Game.h"
+#include "Game/ChunkedMap.h"
+#include "Game/MapGenerator.h"
+#include "Game/PotentiallyVisibleSet.h"
 
-int main()
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+int const CHUNKED_MAP_TILES_PER_SIDE_DEFAULT = 16;
+
+auto constexpr BENCHMARK_BASELINE_FILENAME_DEFAULT = "Game/config/benchmark_baseline.json";
+
+/**
+ * Generates a map and saves it to a file, for the arguments:
+ * --generate-map <style> <walls count> <seed> <output file> [passage width]
+ * The map is saved in the binary format if the output file's extension is .bin,
+ * and in the walls config format otherwise.
+ * 
+ * @return exit code of the program
+ */
+int GenerateMap(int argc, char* argv[])
+{
+    if (argc < 6)
+    {
+        std::cerr << "Usage: " << argv[0]
+            << " --generate-map <maze|city|sparse> <walls count> <seed> <output file> [passage width]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::string const filename = argv[5];
+        float const passageWidth = argc > 6 ? std::stof(argv[6]) : HideAndSeekAndShoot::MapGenerator::PASSAGE_WIDTH_DEFAULT;
+        HideAndSeekAndShoot::MapGenerator generator(
+            HideAndSeekAndShoot::MapGenerator::ParseStyle(argv[2]),
+            std::stoul(argv[4]),
+            passageWidth
+        );
+        auto const walls = generator.Generate(std::stoi(argv[3]));
+
+        bool const binary = filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".bin") == 0;
+        if (binary)
+        {
+            HideAndSeekAndShoot::MapGenerator::SaveAsBinary(walls, filename);
+        }
+        else
+        {
+            HideAndSeekAndShoot::MapGenerator::SaveAsConfig(walls, filename);
+        }
+        std::cout << "Generated " << walls.size() << " walls into " << filename << std::endl;
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Builds the potentially visible sets for a binary map and saves them to a file, for the arguments:
+ * --build-pvs <map file> <output file> [regions per side]
+ * The output file is then named as pvs_file in the walls config, next to the map file.
+ * 
+ * @return exit code of the program
+ */
+int BuildPotentiallyVisibleSet(int argc, char* argv[])
 {
-    HideAndSeekAndShoot::Game game;
-    game.Run();
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " --build-pvs <map file> <output file> [regions per side]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::vector<std::vector<sf::Vector2f>> walls;
+        std::vector<int> wallPolygonInds;
+        HideAndSeekAndShoot::MapGenerator::SplitIntoConvexWalls(
+            HideAndSeekAndShoot::MapGenerator::LoadBinary(argv[2]),
+            walls,
+            wallPolygonInds
+        );
+
+        HideAndSeekAndShoot::PotentiallyVisibleSet pvs;
+        pvs.Build(walls, wallPolygonInds, argc > 4 ? std::stoi(argv[4]) : HideAndSeekAndShoot::PotentiallyVisibleSet::REGIONS_PER_SIDE_DEFAULT);
+        pvs.Save(argv[3]);
+        std::cout << "Built the potentially visible sets of " << pvs.GetWallsCount() << " walls into " << argv[3] << std::endl;
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Splits a binary map into tiles and saves them to a chunked map file, for the arguments:
+ * --build-chunks <map file> <output file> [tiles per side]
+ * The output file is then named as chunked_map_file in the walls config, instead of the map file.
+ * 
+ * @return exit code of the program
+ */
+int BuildChunkedMap(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " --build-chunks <map file> <output file> [tiles per side]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        int const tilesPerSide = argc > 4 ? std::stoi(argv[4]) : CHUNKED_MAP_TILES_PER_SIDE_DEFAULT;
+        HideAndSeekAndShoot::ChunkedMap::Build(
+            HideAndSeekAndShoot::MapGenerator::LoadBinary(argv[2]),
+            tilesPerSide,
+            argv[3]
+        );
+        std::cout << "Split the map into " << tilesPerSide << "x" << tilesPerSide << " tiles in " << argv[3] << std::endl;
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Runs the benchmark scenarios headless and compares their results with a baseline, for the arguments:
+ * --benchmark [baseline file] [--update-baseline]
+ * With --update-baseline the results are saved as the new baseline instead.
+ * 
+ * @return exit code of the program, which is nonzero if a metric has regressed beyond its threshold
+ */
+int RunBenchmark(int argc, char* argv[])
+{
+    std::string baselineFilename = BENCHMARK_BASELINE_FILENAME_DEFAULT;
+    bool updateBaseline = false;
+    for (int argInd = 2; argInd < argc; argInd++)
+    {
+        if (std::string(argv[argInd]) == "--update-baseline")
+        {
+            updateBaseline = true;
+        }
+        else
+        {
+            baselineFilename = argv[argInd];
+        }
+    }
+
+    try
+    {
+        HideAndSeekAndShoot::Game game(true);
+        return game.RunBenchmark(baselineFilename, updateBaseline) ? 0 : 1;
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "--generate-map")
+    {
+        return GenerateMap(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--build-pvs")
+    {
+        return BuildPotentiallyVisibleSet(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--build-chunks")
+    {
+        return BuildChunkedMap(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--benchmark")
+    {
+        return RunBenchmark(argc, argv);
+    }
+
+    // A frame over the allocation budget ends the game with an exception, as do broken configs
+    try
+    {
+        HideAndSeekAndShoot::Game game;
+        game.Run();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
 
     return 0;
 }
\ No newline at end of file